@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "hot_utils/allocation_log.hpp"
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+
+HOT_UTILS_DEFINE_ALLOCATION_HOOKS()
+
+namespace {
+
+struct NullAllocationLogger {
+    void operator()(std::string_view, const hot_utils::AllocationStats&, const hot_utils::AllocationSite*,
+        std::size_t) const {}
+};
+
+void allocate_and_free() {
+    auto value = std::make_unique<int>(42);
+    hot_utils::do_not_optimize(value.get());
+}
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    const auto unscoped = hot_utils::run_benchmark("new/delete, no scope", [] { allocate_and_free(); }, options);
+
+    hot_utils::BenchmarkResult scoped;
+    {
+        hot_utils::ScopedAllocationLog<NullAllocationLogger> log("bench");
+        scoped = hot_utils::run_benchmark("new/delete, ScopedAllocationLog", [] { allocate_and_free(); }, options);
+    }
+    hot_utils::BenchmarkResult with_sites;
+    {
+        hot_utils::AllocationLogOptions log_options;
+        log_options.record_sites = true;
+        hot_utils::ScopedAllocationLog<NullAllocationLogger> log("bench", log_options);
+        with_sites = hot_utils::run_benchmark("new/delete, recording sites", [] { allocate_and_free(); }, options);
+    }
+    const auto vector_push = hot_utils::run_benchmark("vector<int> 1000 push_backs", [] {
+        std::vector<int> values;
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        hot_utils::do_not_optimize(values.data());
+    }, options);
+    hot_utils::print_benchmark_results({unscoped, scoped, with_sites, vector_push});
+
+    std::printf("\n");
+    hot_utils::AllocationLogOptions log_options;
+    log_options.record_sites = true;
+    hot_utils::ScopedAllocationLog<> log("1000 push_backs", log_options);
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    hot_utils::do_not_optimize(values.data());
+    return 0;
+}
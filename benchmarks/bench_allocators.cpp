@@ -0,0 +1,88 @@
+#include <chrono>
+#include <list>
+#include <memory>
+#include <memory_resource>
+
+#include "hot_utils/allocators.hpp"
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+
+namespace {
+
+constexpr int kNodes = 256;
+
+using Element = hot_utils::CopyMoveLog<int>;
+
+// Small-object churn: fill a list of CopyMoveLog<int> with kNodes nodes and tear it down again.
+template <class List>
+void fill_and_clear(List& values) {
+    for (int i = 0; i < kNodes; ++i) {
+        values.emplace_back(i);
+    }
+    hot_utils::do_not_optimize(values.back());
+    values.clear();
+}
+
+struct Payload {
+    char bytes[64];
+};
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    std::list<Element> std_list;
+    const auto std_alloc = hot_utils::run_benchmark(
+        "list churn, std::allocator", [&std_list] { fill_and_clear(std_list); }, options);
+
+    std::list<Element, hot_utils::PoolAllocator<Element>> pool_list;
+    const auto pool = hot_utils::run_benchmark(
+        "list churn, PoolAllocator", [&pool_list] { fill_and_clear(pool_list); }, options);
+
+    hot_utils::MonotonicArena<> arena;
+    const auto arena_list = hot_utils::run_benchmark("list churn, ArenaAllocator + reset",
+        [&arena] {
+            {
+                std::list<Element, hot_utils::ArenaAllocator<Element>> values{hot_utils::ArenaAllocator<Element>(arena)};
+                fill_and_clear(values);
+            }
+            arena.reset();
+        },
+        options);
+
+    hot_utils::ArenaResource<> arena_resource(arena);
+    const auto pmr_arena = hot_utils::run_benchmark("pmr::list churn, ArenaResource + reset",
+        [&arena, &arena_resource] {
+            {
+                std::pmr::list<Element> values(&arena_resource);
+                fill_and_clear(values);
+            }
+            arena.reset();
+        },
+        options);
+
+    std::pmr::unsynchronized_pool_resource std_pool;
+    std::pmr::list<Element> std_pool_list(&std_pool);
+    const auto pmr_pool = hot_utils::run_benchmark("pmr::list churn, unsynchronized_pool",
+        [&std_pool_list] { fill_and_clear(std_pool_list); }, options);
+
+    const auto new_delete = hot_utils::run_benchmark("64-byte object, new/delete", [] {
+        auto payload = std::make_unique<Payload>();
+        hot_utils::do_not_optimize(payload.get());
+    }, options);
+
+    hot_utils::FixedBlockPool<> blocks(sizeof(Payload), alignof(Payload));
+    const auto block_pool = hot_utils::run_benchmark("64-byte object, FixedBlockPool", [&blocks] {
+        void* payload = blocks.allocate();
+        hot_utils::do_not_optimize(payload);
+        blocks.deallocate(payload);
+    }, options);
+
+    hot_utils::print_benchmark_results({std_alloc, pool, arena_list, pmr_arena, pmr_pool, new_delete, block_pool});
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include <cstdio>
+
+#include "hot_utils/async_log.hpp"
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/log_utils.hpp"
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    // Both backends write to /dev/null so only the caller-side cost differs; against a
+    // terminal or a real file the synchronous numbers grow by the cost of the write.
+    if (std::freopen("/dev/null", "w", stderr) == nullptr) {
+        std::perror("freopen");
+        return 1;
+    }
+
+    const auto sync_line = hot_utils::run_benchmark("sync log_line", [] {
+        hot_utils::detail::log_line("BENCH", "value updated in the hot loop");
+    }, options);
+    const auto sync_call = hot_utils::run_benchmark("sync log_call", [] {
+        hot_utils::detail::log_call_impl(__FILE__, __LINE__, __func__, "update(value)", 2);
+    }, options);
+
+    hot_utils::AsyncLogOptions async;
+    async.out = stderr;
+    async.overflow = hot_utils::LogOverflow::Drop;
+    async.ring_capacity = 1 << 16;
+    hot_utils::enable_async_logging(async);
+    hot_utils::detail::log_line("BENCH", "registers this thread's ring outside the timed region");
+
+    const auto async_line = hot_utils::run_benchmark("async log_line", [] {
+        hot_utils::detail::log_line("BENCH", "value updated in the hot loop");
+    }, options);
+    const auto async_call = hot_utils::run_benchmark("async log_call", [] {
+        hot_utils::detail::log_call_impl(__FILE__, __LINE__, __func__, "update(value)", 2);
+    }, options);
+    hot_utils::disable_async_logging();
+
+    hot_utils::print_benchmark_results({sync_line, sync_call, async_line, async_call});
+    const auto stats = hot_utils::async_log_stats();
+    std::printf("async backend wrote %llu records, dropped %llu on overflow\n",
+        static_cast<unsigned long long>(stats.written), static_cast<unsigned long long>(stats.dropped));
+    return 0;
+}
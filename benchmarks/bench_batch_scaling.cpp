@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "hot_utils/batch.hpp"
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+#include "hot_utils/thread_pool.hpp"
+
+namespace {
+
+constexpr std::size_t kDimensions = 16;
+constexpr std::size_t kVectors = std::size_t{1} << 20;
+
+using Vec = hot_utils::StreamlinedVector<float, kDimensions>;
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(50);
+    options.min_sample_time = std::chrono::milliseconds(20);
+
+    std::vector<Vec> v(kVectors);
+    std::vector<Vec> w(kVectors);
+    for (std::size_t i = 0; i < kVectors; ++i) {
+        for (std::size_t j = 0; j < kDimensions; ++j) {
+            v[i][j] = static_cast<float>(j);
+            w[i][j] = static_cast<float>(i % 7);
+        }
+    }
+
+    std::printf("v[i] = v[i] * s + w[i] over %zu StreamlinedVector<float, %zu>\n", kVectors, kDimensions);
+    std::printf("%8s %12s %14s %10s\n", "threads", "median ms", "Mvectors/s", "speedup");
+
+    const auto serial = hot_utils::run_benchmark("serial", [&] {
+        for (std::size_t i = 0; i < kVectors; ++i) {
+            v[i] = v[i] * 0.5f + w[i];
+        }
+        hot_utils::do_not_optimize(v.data());
+    }, options);
+    std::printf("%8s %12.3f %14.1f %10.2f\n", "serial", serial.stats.median / 1e6,
+        static_cast<double>(kVectors) / serial.stats.median * 1e3, 1.0);
+
+    // The calling thread takes part in parallel_for, so a pool of n - 1 workers runs on n threads.
+    for (std::size_t threads = 1; threads <= hot_utils::ThreadPool::default_thread_count(); ++threads) {
+        hot_utils::ThreadPool pool(threads > 1 ? threads - 1 : 1);
+        hot_utils::BatchOptions batch;
+        batch.pool = &pool;
+        if (threads == 1) {
+            batch.serial_threshold_bytes = static_cast<std::size_t>(-1);
+        }
+        const auto result = hot_utils::run_benchmark("batch", [&] {
+            hot_utils::batch_assign(v, [&](std::size_t i) { return v[i] * 0.5f + w[i]; }, batch);
+            hot_utils::do_not_optimize(v.data());
+        }, options);
+        std::printf("%8zu %12.3f %14.1f %10.2f\n", threads, result.stats.median / 1e6,
+            static_cast<double>(kVectors) / result.stats.median * 1e3, serial.stats.median / result.stats.median);
+    }
+    return 0;
+}
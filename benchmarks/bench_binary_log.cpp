@@ -0,0 +1,48 @@
+#include <chrono>
+#include <cstdio>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/binary_log.hpp"
+#include "hot_utils/log_utils.hpp"
+#include "hot_utils/scoped_timer.hpp"
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    // Both backends write to /dev/null so the difference is formatting and stdio on the caller.
+    if (std::freopen("/dev/null", "w", stderr) == nullptr) {
+        std::perror("freopen");
+        return 1;
+    }
+    std::FILE* sink = std::fopen("/dev/null", "wb");
+    if (sink == nullptr) {
+        std::perror("fopen");
+        return 1;
+    }
+
+    long long counter = 0;
+    const auto text_timer = hot_utils::run_benchmark("text timer report", [&counter] {
+        hot_utils::DefaultTimerLogger{}("solve", std::chrono::milliseconds(++counter));
+    }, options);
+    const auto text_event = hot_utils::run_benchmark("text formatted event", [&counter] {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "iteration %lld residual %g", ++counter, 1e-3);
+        hot_utils::detail::log_line("STAT", buf);
+    }, options);
+
+    hot_utils::enable_binary_logging(sink);
+    const auto binary_timer = hot_utils::run_benchmark("binary timer report", [&counter] {
+        hot_utils::DefaultTimerLogger{}("solve", std::chrono::milliseconds(++counter));
+    }, options);
+    const auto binary_event = hot_utils::run_benchmark("binary deferred event", [&counter] {
+        HOT_UTILS_BINARY_LOG("STAT", "iteration {} residual {}", ++counter, 1e-3);
+    }, options);
+    hot_utils::disable_binary_logging();
+    std::fclose(sink);
+
+    hot_utils::print_benchmark_results({text_timer, text_event, binary_timer, binary_event});
+    return 0;
+}
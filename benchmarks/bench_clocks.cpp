@@ -0,0 +1,34 @@
+#include <chrono>
+#include <cstdio>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/tsc_clock.hpp"
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    const auto info = hot_utils::TscClock::info();
+    std::printf("invariant TSC: %s, TscClock source: %s, %.3f ticks/ns\n\n", info.invariant_tsc ? "yes" : "no",
+        info.uses_tsc ? "rdtsc" : "steady_clock", info.ticks_per_ns);
+
+    const auto high_resolution = hot_utils::run_benchmark("high_resolution_clock::now", [] {
+        hot_utils::do_not_optimize(std::chrono::high_resolution_clock::now());
+    }, options);
+    const auto steady = hot_utils::run_benchmark("steady_clock::now", [] {
+        hot_utils::do_not_optimize(std::chrono::steady_clock::now());
+    }, options);
+    const auto tsc = hot_utils::run_benchmark("TscClock::now", [] {
+        hot_utils::do_not_optimize(hot_utils::TscClock::now());
+    }, options);
+    hot_utils::print_benchmark_results({high_resolution, steady, tsc});
+
+    std::printf("\nback-to-back overhead: high_resolution_clock %lld ns, steady_clock %lld ns, TscClock %lld ns\n",
+        static_cast<long long>(hot_utils::clock_overhead<std::chrono::high_resolution_clock>().count()),
+        static_cast<long long>(hot_utils::clock_overhead<std::chrono::steady_clock>().count()),
+        static_cast<long long>(hot_utils::clock_overhead<hot_utils::TscClock>().count()));
+    return 0;
+}
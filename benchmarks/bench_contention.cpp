@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/contention_benchmark.hpp"
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/log_utils.hpp"
+
+namespace {
+
+std::atomic<std::size_t> g_shared_counter{0};
+
+int traced_value(int value) {
+    return value + 1;
+}
+
+} // namespace
+
+// Usage: bench_contention [--pin]
+int main(int argc, char** argv) {
+    hot_utils::ContentionOptions options;
+    options.pin_threads = argc > 1 && std::strcmp(argv[1], "--pin") == 0;
+    // At least four threads, so a small machine still shows oversubscription.
+    options.max_threads = std::max<std::size_t>(4, std::thread::hardware_concurrency());
+
+    // Counting only; the copy_move log lines would dominate otherwise.
+    hot_utils::set_log_level("copy_move", hot_utils::LogLevel::Off);
+
+    std::vector<hot_utils::ContentionResult> results;
+    results.push_back(hot_utils::run_contention_benchmark("shared fetch_add", [] {
+        g_shared_counter.fetch_add(1, std::memory_order_relaxed);
+    }, options));
+    results.push_back(hot_utils::run_contention_benchmark("CopyLog<int> copy", [] {
+        hot_utils::CopyLog<int> a;
+        hot_utils::CopyLog<int> b = a;
+        hot_utils::do_not_optimize(b);
+    }, options));
+    results.push_back(hot_utils::run_contention_benchmark("LifetimeLog<int> ctor + dtor", [] {
+        hot_utils::LifetimeLog<int> object;
+        hot_utils::do_not_optimize(object);
+    }, options));
+    // The call category is off by default and tracing is stopped: one relaxed load of the call gate only.
+    results.push_back(hot_utils::run_contention_benchmark("HOT_UTILS_LOG_CALL, off", [](std::size_t thread) {
+        return HOT_UTILS_LOG_CALL(traced_value(static_cast<int>(thread)));
+    }, options));
+
+    std::vector<hot_utils::BenchmarkResult> summary;
+    for (const auto& result : results) {
+        hot_utils::print_contention_results(result);
+        std::printf("\n");
+        const auto points = hot_utils::contention_benchmark_results(result);
+        summary.insert(summary.end(), points.begin(), points.end());
+    }
+    hot_utils::print_benchmark_results(summary);
+    return 0;
+}
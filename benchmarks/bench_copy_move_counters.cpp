@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/log_utils.hpp"
+
+namespace {
+
+constexpr std::size_t kCopiesPerThread = std::size_t{1} << 16;
+
+// The previous CopyLog: the same log check, but four seq_cst atomics on one cache line.
+struct SharedCounts {
+    inline static std::atomic<std::size_t> copy_ctor{0};
+    inline static std::atomic<std::size_t> copy_assign{0};
+    inline static std::atomic<std::size_t> move_ctor{0};
+    inline static std::atomic<std::size_t> move_assign{0};
+};
+
+struct SharedCountedValue {
+    SharedCountedValue() = default;
+    SharedCountedValue(const SharedCountedValue& other)
+        : value(other.value) {
+        ++SharedCounts::copy_ctor;
+        hot_utils::detail::log_action_for<int>("CopyLog", "copy_ctor");
+    }
+    SharedCountedValue& operator=(const SharedCountedValue& other) {
+        value = other.value;
+        ++SharedCounts::copy_assign;
+        hot_utils::detail::log_action_for<int>("CopyLog", "copy_assign");
+        return *this;
+    }
+
+    int value = 0;
+};
+
+// Every thread copies its own object, so only the counters are shared.
+template <typename T>
+void copy_on_threads(std::size_t threads) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([] {
+            T a;
+            for (std::size_t i = 0; i < kCopiesPerThread; ++i) {
+                T b = a;
+                a = b;
+                hot_utils::do_not_optimize(a);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    // Counting only; the copy_move log lines would dominate otherwise.
+    hot_utils::set_log_level("copy_move", hot_utils::LogLevel::Off);
+
+    const std::size_t max_threads = std::max<std::size_t>(4, std::thread::hardware_concurrency());
+    std::printf("copy ctor + copy assign on every thread, %zu of each per thread\n", kCopiesPerThread);
+    std::printf("%8s %18s %18s %10s\n", "threads", "shared ns/copy", "sharded ns/copy", "speedup");
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        const double copies = 2.0 * static_cast<double>(kCopiesPerThread * threads);
+        const auto shared = hot_utils::run_benchmark("shared", [threads] {
+            copy_on_threads<SharedCountedValue>(threads);
+        }, options);
+        const auto sharded = hot_utils::run_benchmark("sharded", [threads] {
+            copy_on_threads<hot_utils::CopyLog<int>>(threads);
+        }, options);
+        std::printf("%8zu %18.2f %18.2f %10.2f\n", threads, shared.stats.median / copies,
+            sharded.stats.median / copies, shared.stats.median / sharded.stats.median);
+    }
+
+    // Cost of attributing each copy to its call site.
+    hot_utils::CopyMoveLog<int> source;
+    const auto untracked = hot_utils::run_benchmark("CopyMoveLog copy", [&] {
+        hot_utils::CopyMoveLog<int> copy = source;
+        hot_utils::do_not_optimize(copy);
+    }, options);
+    hot_utils::enable_copy_site_tracking();
+    const auto tracked = hot_utils::run_benchmark("CopyMoveLog copy, sites tracked", [&] {
+        hot_utils::CopyMoveLog<int> copy = source;
+        hot_utils::do_not_optimize(copy);
+    }, options);
+    hot_utils::disable_copy_site_tracking();
+    const auto lifetime = hot_utils::run_benchmark("LifetimeLog construct + destroy", [] {
+        hot_utils::LifetimeLog<int> object;
+        hot_utils::do_not_optimize(object);
+    }, options);
+    std::printf("\n");
+    hot_utils::print_benchmark_results({untracked, tracked, lifetime});
+    std::printf("\n");
+    hot_utils::write_copy_move_report(stdout, 5);
+    return 0;
+}
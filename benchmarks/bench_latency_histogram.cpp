@@ -0,0 +1,33 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/latency_histogram.hpp"
+#include "hot_utils/scoped_timer.hpp"
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    hot_utils::LatencyHistogram histogram;
+    std::uint64_t value = 1;
+    const auto record = hot_utils::run_benchmark("LatencyHistogram::record", [&] {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        histogram.record(value >> 40);
+    }, options);
+
+    hot_utils::LatencyHistogram timed;
+    const auto timer = hot_utils::run_benchmark("TscScopedTimer<HistogramTimerLogger>", [&] {
+        hot_utils::TscScopedTimer<hot_utils::HistogramTimerLogger> scope("", hot_utils::HistogramTimerLogger{&timed});
+        hot_utils::do_not_optimize(value);
+    }, options);
+    hot_utils::print_benchmark_results({record, timer});
+
+    std::printf("\n");
+    timed.print_percentiles(stdout, "empty TscScopedTimer scope");
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/log_utils.hpp"
+
+namespace {
+
+hot_utils::LogCategory bench_category{"bench"};
+
+std::string describe(int value) {
+    return "value " + std::to_string(value) + " crossed the threshold";
+}
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    if (std::freopen("/dev/null", "w", stderr) == nullptr) {
+        std::perror("freopen");
+        return 1;
+    }
+    hot_utils::configure_logging("info");
+
+    int value = 0;
+    const auto disabled_log = hot_utils::run_benchmark("disabled HOT_UTILS_LOG", [&value] {
+        HOT_UTILS_LOG(bench_category, hot_utils::LogLevel::Debug, describe(++value));
+        hot_utils::do_not_optimize(value);
+    }, options);
+    const auto disabled_copy = hot_utils::run_benchmark("disabled CopyMoveLog copy", [] {
+        hot_utils::CopyMoveLog<int> a(1);
+        hot_utils::CopyMoveLog<int> b(a);
+        hot_utils::do_not_optimize(b);
+    }, options);
+
+    hot_utils::configure_logging("info,bench=debug,copy_move=debug");
+    const auto enabled_log = hot_utils::run_benchmark("enabled HOT_UTILS_LOG", [&value] {
+        HOT_UTILS_LOG(bench_category, hot_utils::LogLevel::Debug, describe(++value));
+    }, options);
+    const auto enabled_copy = hot_utils::run_benchmark("enabled CopyMoveLog copy", [] {
+        hot_utils::CopyMoveLog<int> a(1);
+        hot_utils::CopyMoveLog<int> b(a);
+        hot_utils::do_not_optimize(b);
+    }, options);
+
+    hot_utils::print_benchmark_results({disabled_log, disabled_copy, enabled_log, enabled_copy});
+    return 0;
+}
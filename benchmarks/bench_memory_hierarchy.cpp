@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/streamlined_algorithms.hpp"
+#include "hot_utils/streamlined_buffer.hpp"
+
+namespace {
+
+constexpr std::size_t kKiB = 1024;
+constexpr std::size_t kMiB = 1024 * kKiB;
+constexpr std::size_t kMinWorkingSet = 4 * kKiB;
+constexpr std::size_t kChaseLoads = std::size_t{1} << 14;
+
+// One node per cache line, so every load in the chase touches a new line.
+struct alignas(64) ChaseLine {
+    ChaseLine* next = nullptr;
+};
+
+// Bytes moved and flops done per element; bytes count each read and each write once.
+struct Kernel {
+    const char* name;
+    std::size_t streams;
+    double bytes_per_element;
+    double flops_per_element;
+};
+
+constexpr Kernel kKernels[] = {
+    {"sum", 1, 4.0, 1.0},   // total += a[i]
+    {"dot", 2, 8.0, 2.0},   // total += a[i] * b[i]
+    {"axpy", 2, 12.0, 2.0}, // y[i] += alpha * x[i]
+    {"fma", 4, 16.0, 2.0},  // out[i] = a[i] * b[i] + c[i]
+};
+constexpr std::size_t kKernelCount = sizeof(kKernels) / sizeof(kKernels[0]);
+
+struct SizeRow {
+    std::size_t working_set = 0;
+    double chase_ns = 0.0;
+    double read_gbps = 0.0;
+    double write_gbps = 0.0;
+    double copy_gbps = 0.0;
+    double kernel_gbps[kKernelCount] = {};
+};
+
+std::string size_label(std::size_t bytes) {
+    char text[32];
+    if (bytes >= kMiB) {
+        std::snprintf(text, sizeof(text), "%zu MiB", bytes / kMiB);
+    } else {
+        std::snprintf(text, sizeof(text), "%zu KiB", bytes / kKiB);
+    }
+    return text;
+}
+
+// Bytes per nanosecond is GB/s.
+double gbps(double bytes, const hot_utils::BenchmarkResult& result) {
+    return result.stats.median > 0.0 ? bytes / result.stats.median : 0.0;
+}
+
+// A single random cycle through every line defeats the prefetchers, and each
+// load depends on the one before it, so time per load is the access latency.
+double chase_latency(std::size_t working_set, const hot_utils::BenchmarkOptions& options) {
+    const std::size_t lines = std::max<std::size_t>(working_set / sizeof(ChaseLine), 2);
+    std::vector<ChaseLine> nodes(lines);
+    std::vector<std::size_t> order(lines);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::shuffle(order.begin() + 1, order.end(), std::mt19937_64(working_set));
+    for (std::size_t i = 0; i < lines; ++i) {
+        nodes[order[i]].next = &nodes[order[(i + 1) % lines]];
+    }
+
+    ChaseLine* cursor = &nodes[0];
+    const auto result = hot_utils::run_benchmark("chase", [&] {
+        ChaseLine* line = cursor;
+        for (std::size_t i = 0; i < kChaseLoads; ++i) {
+            line = line->next;
+        }
+        cursor = line;
+        return line;
+    }, options);
+    return result.stats.median / static_cast<double>(kChaseLoads);
+}
+
+void measure_streams(SizeRow& row, const hot_utils::BenchmarkOptions& options) {
+    // One buffer of the working set: read and write cover all of it, copy moves the first half onto the second.
+    const std::size_t words = row.working_set / sizeof(std::uint64_t);
+    std::vector<std::uint64_t> buffer(words, 1);
+
+    // Four independent sums, so the adds do not serialize the loads.
+    const auto read = hot_utils::run_benchmark("read", [&] {
+        std::uint64_t totals[4] = {};
+        for (std::size_t i = 0; i + 4 <= words; i += 4) {
+            totals[0] += buffer[i];
+            totals[1] += buffer[i + 1];
+            totals[2] += buffer[i + 2];
+            totals[3] += buffer[i + 3];
+        }
+        return totals[0] + totals[1] + totals[2] + totals[3];
+    }, options);
+    row.read_gbps = gbps(static_cast<double>(words * sizeof(std::uint64_t)), read);
+
+    std::uint64_t fill = 0;
+    const auto write = hot_utils::run_benchmark("write", [&] {
+        std::fill(buffer.begin(), buffer.end(), ++fill);
+        hot_utils::do_not_optimize(buffer.data());
+    }, options);
+    row.write_gbps = gbps(static_cast<double>(words * sizeof(std::uint64_t)), write);
+
+    const std::size_t half = words / 2;
+    const auto copy = hot_utils::run_benchmark("copy", [&] {
+        std::memcpy(buffer.data() + half, buffer.data(), half * sizeof(std::uint64_t));
+        hot_utils::do_not_optimize(buffer.data());
+    }, options);
+    row.copy_gbps = gbps(static_cast<double>(2 * half * sizeof(std::uint64_t)), copy);
+}
+
+void measure_kernels(SizeRow& row, const hot_utils::BenchmarkOptions& options) {
+    for (std::size_t k = 0; k < kKernelCount; ++k) {
+        const Kernel& kernel = kKernels[k];
+        const std::size_t count = row.working_set / (kernel.streams * sizeof(float));
+        hot_utils::StreamlinedBuffer<float> a(count, 0.5f);
+        hot_utils::StreamlinedBuffer<float> b(count, 0.25f);
+        hot_utils::StreamlinedBuffer<float> c(kernel.streams > 2 ? count : 0, 1.0f);
+        hot_utils::StreamlinedBuffer<float> out(kernel.streams > 2 ? count : 0);
+
+        hot_utils::BenchmarkResult result;
+        switch (k) {
+        case 0:
+            result = hot_utils::run_benchmark(kernel.name, [&] { return hot_utils::sum(a); }, options);
+            break;
+        case 1:
+            result = hot_utils::run_benchmark(kernel.name, [&] { return hot_utils::dot(a, b); }, options);
+            break;
+        case 2:
+            // Alternating signs keep y bounded over millions of iterations.
+            result = hot_utils::run_benchmark(kernel.name, [&, alpha = 1.0f]() mutable {
+                hot_utils::axpy(alpha, a, b);
+                alpha = -alpha;
+                hot_utils::do_not_optimize(b.data());
+            }, options);
+            break;
+        default:
+            result = hot_utils::run_benchmark(kernel.name, [&] {
+                out = hot_utils::fma(a, b, c);
+                hot_utils::do_not_optimize(out.data());
+            }, options);
+            break;
+        }
+        row.kernel_gbps[k] = gbps(kernel.bytes_per_element * static_cast<double>(count), result);
+    }
+}
+
+// The bandwidth roof at this size: the fastest any stream or kernel moved data.
+double best_gbps(const SizeRow& row) {
+    double best = std::max({row.read_gbps, row.write_gbps, row.copy_gbps});
+    for (const double value : row.kernel_gbps) {
+        best = std::max(best, value);
+    }
+    return best;
+}
+
+void print_cache_sizes() {
+#if defined(__linux__) && defined(_SC_LEVEL1_DCACHE_SIZE)
+    const long sizes[] = {sysconf(_SC_LEVEL1_DCACHE_SIZE), sysconf(_SC_LEVEL2_CACHE_SIZE),
+        sysconf(_SC_LEVEL3_CACHE_SIZE)};
+    const char* names[] = {"L1d", "L2", "L3"};
+    std::printf("caches:");
+    for (std::size_t i = 0; i < 3; ++i) {
+        if (sizes[i] > 0) {
+            std::printf(" %s %s", names[i], size_label(static_cast<std::size_t>(sizes[i])).c_str());
+        }
+    }
+    std::printf("\n\n");
+#endif
+}
+
+} // namespace
+
+// Usage: bench_memory_hierarchy [max MiB]
+// Sweeps working sets from 4 KiB up to max MiB (default 128), doubling each step.
+int main(int argc, char** argv) {
+    std::size_t max_working_set = 128 * kMiB;
+    if (argc > 1) {
+        const long requested = std::strtol(argv[1], nullptr, 10);
+        if (requested <= 0) {
+            std::fprintf(stderr, "usage: %s [max MiB]\n", argv[0]);
+            return 2;
+        }
+        max_working_set = static_cast<std::size_t>(requested) * kMiB;
+    }
+
+    hot_utils::BenchmarkOptions options;
+    options.samples = 5;
+    options.warmup = std::chrono::milliseconds(10);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    print_cache_sizes();
+    std::printf("%9s %9s %9s %9s %9s |", "size", "chase ns", "read", "write", "copy");
+    for (const Kernel& kernel : kKernels) {
+        std::printf(" %9s", kernel.name);
+    }
+    std::printf("   (GB/s)\n");
+
+    std::vector<SizeRow> rows;
+    for (std::size_t working_set = kMinWorkingSet; working_set <= max_working_set; working_set *= 2) {
+        SizeRow row;
+        row.working_set = working_set;
+        row.chase_ns = chase_latency(working_set, options);
+        measure_streams(row, options);
+        measure_kernels(row, options);
+        std::printf("%9s %9.2f %9.2f %9.2f %9.2f |", size_label(working_set).c_str(), row.chase_ns, row.read_gbps,
+            row.write_gbps, row.copy_gbps);
+        for (const double value : row.kernel_gbps) {
+            std::printf(" %9.2f", value);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+        rows.push_back(row);
+    }
+    if (rows.empty()) {
+        return 0;
+    }
+
+    // Roofline: attainable GFLOP/s = min(compute roof, flop/byte * bandwidth). The
+    // compute roof is the best any kernel reached, so it is what these kernels can
+    // do out of L1 rather than the machine's peak.
+    double peak_gflops = 0.0;
+    const char* peak_kernel = "-";
+    std::size_t peak_size = 0;
+    for (const SizeRow& row : rows) {
+        for (std::size_t k = 0; k < kKernelCount; ++k) {
+            const double gflops = row.kernel_gbps[k] * kKernels[k].flops_per_element / kKernels[k].bytes_per_element;
+            if (gflops > peak_gflops) {
+                peak_gflops = gflops;
+                peak_kernel = kKernels[k].name;
+                peak_size = row.working_set;
+            }
+        }
+    }
+    const SizeRow& largest = rows.back();
+    const double bandwidth = best_gbps(largest);
+    std::printf("\nroofline at %s: compute %.2f GFLOP/s (%s at %s), bandwidth %.2f GB/s, ridge %.3f flop/byte\n",
+        size_label(largest.working_set).c_str(), peak_gflops, peak_kernel, size_label(peak_size).c_str(), bandwidth,
+        bandwidth > 0.0 ? peak_gflops / bandwidth : 0.0);
+    std::printf("%9s %10s %12s %12s %12s %8s %10s %15s\n", "kernel", "flop/byte", "best GFLOP/s", "GFLOP/s",
+        "roof", "of roof", "bound", "half speed from");
+    for (std::size_t k = 0; k < kKernelCount; ++k) {
+        const Kernel& kernel = kKernels[k];
+        const double intensity = kernel.flops_per_element / kernel.bytes_per_element;
+        double kernel_best = 0.0;
+        for (const SizeRow& row : rows) {
+            kernel_best = std::max(kernel_best, row.kernel_gbps[k]);
+        }
+        // The smallest size from which the kernel stays under half its best throughput.
+        std::string knee = "-";
+        for (auto row = rows.rbegin(); row != rows.rend() && row->kernel_gbps[k] < 0.5 * kernel_best; ++row) {
+            knee = size_label(row->working_set);
+        }
+        const double gflops = largest.kernel_gbps[k] * intensity;
+        const double roof = std::min(peak_gflops, intensity * bandwidth);
+        std::printf("%9s %10.3f %12.2f %12.2f %12.2f %7.0f%% %10s %15s\n", kernel.name, intensity,
+            kernel_best * intensity, gflops, roof, roof > 0.0 ? gflops / roof * 100.0 : 0.0,
+            intensity * bandwidth < peak_gflops ? "memory" : "compute", knee.c_str());
+    }
+    return 0;
+}
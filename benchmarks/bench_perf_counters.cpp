@@ -0,0 +1,42 @@
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/perf_counters.hpp"
+
+// Same reduction over the same data in sequential and shuffled order; the counters
+// show the gap as LLC misses and a collapsed IPC rather than just a longer time.
+int main() {
+    constexpr std::size_t kCount = std::size_t{1} << 23;
+    std::vector<std::uint32_t> data(kCount);
+    std::iota(data.begin(), data.end(), 0u);
+    std::vector<std::uint32_t> order(kCount);
+    std::iota(order.begin(), order.end(), 0u);
+
+    if (!hot_utils::perf_counters_available()) {
+        std::printf("hardware counters unavailable; reporting time only\n");
+        std::fflush(stdout);
+    }
+
+    std::uint64_t sum = 0;
+    {
+        hot_utils::PerfCounterTimer<> timer("sequential gather", kCount);
+        for (const std::uint32_t index : order) {
+            sum += data[index];
+        }
+    }
+    hot_utils::do_not_optimize(sum);
+
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    {
+        hot_utils::PerfCounterTimer<> timer("random gather", kCount);
+        for (const std::uint32_t index : order) {
+            sum += data[index];
+        }
+    }
+    hot_utils::do_not_optimize(sum);
+    return 0;
+}
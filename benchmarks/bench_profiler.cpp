@@ -0,0 +1,55 @@
+#include <chrono>
+#include <cstdio>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/profiler.hpp"
+#include "hot_utils/scoped_timer.hpp"
+
+namespace {
+
+using Timer = hot_utils::ScopedTimer<>;
+
+double step(double x) {
+    Timer timer("step");
+    for (int i = 0; i < 16; ++i) {
+        x = x * 1.0000001 + 0.5;
+    }
+    return x;
+}
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    // Logging mode writes one line per scope; send it to /dev/null so only the caller-side cost shows.
+    if (std::freopen("/dev/null", "w", stderr) == nullptr) {
+        std::perror("freopen");
+        return 1;
+    }
+
+    double x = 1.0;
+    const auto logged = hot_utils::run_benchmark("ScopedTimer, logging", [&x] {
+        x = step(x);
+        hot_utils::do_not_optimize(x);
+    }, options);
+
+    hot_utils::enable_profiler();
+    const auto profiled = hot_utils::run_benchmark("ScopedTimer, profiler", [&x] {
+        Timer outer("iteration");
+        x = step(x);
+        hot_utils::do_not_optimize(x);
+    }, options);
+    hot_utils::disable_profiler();
+
+    hot_utils::print_benchmark_results({logged, profiled});
+    std::printf("\n");
+    hot_utils::write_profile_summary(stdout);
+    std::printf("\n");
+    hot_utils::write_profile_folded(stdout);
+    return 0;
+}
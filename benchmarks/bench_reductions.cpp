@@ -0,0 +1,182 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/streamlined_algorithms.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace {
+
+constexpr std::size_t kElements = 4096;
+
+template <typename T>
+struct Operands {
+    hot_utils::StreamlinedVector<T, kElements> a{};
+    hot_utils::StreamlinedVector<T, kElements> b{};
+    hot_utils::StreamlinedVector<T, kElements> c{};
+    hot_utils::StreamlinedVector<T, kElements> out{};
+
+    Operands() {
+        for (std::size_t i = 0; i < kElements; ++i) {
+            a[i] = static_cast<T>(i % 97) / T{64};
+            b[i] = static_cast<T>(i % 13) / T{8};
+            c[i] = static_cast<T>(i % 7);
+        }
+    }
+};
+
+template <typename Naive, typename Streamlined>
+void report(const char* type_name, const char* op, Naive naive, Streamlined streamlined,
+    const hot_utils::BenchmarkOptions& options) {
+    const auto baseline = hot_utils::run_benchmark(std::string(type_name) + " " + op + " [baseline]", naive, options);
+    const auto result = hot_utils::run_benchmark(std::string(type_name) + " " + op, streamlined, options);
+    std::printf("%-8s %-24s baseline %10.2f ns  streamlined %10.2f ns  %6.2fx\n", type_name, op,
+        baseline.stats.median, result.stats.median, baseline.stats.median / result.stats.median);
+}
+
+template <typename T>
+void run_type(const char* type_name, const hot_utils::BenchmarkOptions& options) {
+    static Operands<T> operands;
+    const auto& a = operands.a;
+    const auto& b = operands.b;
+    const auto& c = operands.c;
+    auto& out = operands.out;
+
+    const auto compare = [&](const char* op, auto naive, auto streamlined) {
+        report(type_name, op, naive, streamlined, options);
+    };
+
+    compare(
+        "sum",
+        [&] {
+            T total{};
+            for (std::size_t i = 0; i < kElements; ++i) {
+                total += a[i];
+            }
+            return total;
+        },
+        [&] { return hot_utils::sum(a); });
+    // Accuracy modes are measured against the fast sum rather than a naive loop.
+    compare(
+        "sum (pairwise)", [&] { return hot_utils::sum(a); },
+        [&] { return hot_utils::sum(a, hot_utils::Summation::Pairwise); });
+    compare(
+        "sum (kahan)", [&] { return hot_utils::sum(a); },
+        [&] { return hot_utils::sum(a, hot_utils::Summation::Kahan); });
+    compare(
+        "dot",
+        [&] {
+            T total{};
+            for (std::size_t i = 0; i < kElements; ++i) {
+                total += a[i] * b[i];
+            }
+            return total;
+        },
+        [&] { return hot_utils::dot(a, b); });
+    compare(
+        "norm2",
+        [&] {
+            T total{};
+            for (std::size_t i = 0; i < kElements; ++i) {
+                total += a[i] * a[i];
+            }
+            return std::sqrt(total);
+        },
+        [&] { return hot_utils::norm2(a); });
+    compare(
+        "max",
+        [&] {
+            T best = a[0];
+            for (std::size_t i = 1; i < kElements; ++i) {
+                best = a[i] > best ? a[i] : best;
+            }
+            return best;
+        },
+        [&] { return hot_utils::max_value(a); });
+    compare(
+        "out = a * b + c",
+        [&] {
+            out = a * b;
+            out += c;
+            hot_utils::do_not_optimize(out);
+        },
+        [&] {
+            out = hot_utils::fma(a, b, c);
+            hot_utils::do_not_optimize(out);
+        });
+    compare(
+        "out += 0.5 * a",
+        [&] {
+            for (std::size_t i = 0; i < kElements; ++i) {
+                out[i] += T{0.5} * a[i];
+            }
+            hot_utils::do_not_optimize(out);
+        },
+        [&] {
+            hot_utils::axpy(T{0.5}, a, out);
+            hot_utils::do_not_optimize(out);
+        });
+}
+
+// Eight elements stay under simd::kMinBytes, so fma and axpy take the scalar
+// path; a libm call per element would show here first.
+template <typename T>
+void run_small(const char* type_name, const hot_utils::BenchmarkOptions& options) {
+    constexpr std::size_t kSmall = 8;
+    static_assert(kSmall * sizeof(T) < hot_utils::detail::simd::kMinBytes);
+    static hot_utils::StreamlinedVector<T, kSmall> a{};
+    static hot_utils::StreamlinedVector<T, kSmall> b{};
+    static hot_utils::StreamlinedVector<T, kSmall> c{};
+    static hot_utils::StreamlinedVector<T, kSmall> out{};
+    for (std::size_t i = 0; i < kSmall; ++i) {
+        a[i] = static_cast<T>(i + 1) / T{8};
+        b[i] = static_cast<T>(i % 3);
+        c[i] = static_cast<T>(i);
+    }
+
+    report(
+        type_name, "small out = a * b + c",
+        [&] {
+            for (std::size_t i = 0; i < kSmall; ++i) {
+                out[i] = a[i] * b[i] + c[i];
+            }
+            hot_utils::do_not_optimize(out);
+        },
+        [&] {
+            out = hot_utils::fma(a, b, c);
+            hot_utils::do_not_optimize(out);
+        },
+        options);
+    report(
+        type_name, "small out += 0.5 * a",
+        [&] {
+            for (std::size_t i = 0; i < kSmall; ++i) {
+                out[i] += T{0.5} * a[i];
+            }
+            hot_utils::do_not_optimize(out);
+        },
+        [&] {
+            hot_utils::axpy(T{0.5}, a, out);
+            hot_utils::do_not_optimize(out);
+        },
+        options);
+}
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    std::printf("StreamlinedVector<T, %zu> reductions, detected ISA: %s\n", kElements,
+        hot_utils::simd_isa_name(hot_utils::detected_simd_isa()));
+    run_type<float>("float", options);
+    run_type<double>("double", options);
+    run_small<float>("float", options);
+    run_small<double>("double", options);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/sampling_profiler.hpp"
+
+// External linkage, so dladdr can name it in the folded stacks.
+__attribute__((noinline)) std::uint64_t sampling_profiler_workload() {
+    std::uint64_t value = 1;
+    for (int i = 0; i < 10000; ++i) {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        hot_utils::do_not_optimize(value);
+    }
+    return value;
+}
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    std::vector<hot_utils::BenchmarkResult> results;
+    results.push_back(hot_utils::run_benchmark("workload, profiler off", [] {
+        hot_utils::do_not_optimize(sampling_profiler_workload());
+    }, options));
+
+    for (const auto interval : {std::chrono::microseconds(10'000), std::chrono::microseconds(1'000),
+             std::chrono::microseconds(100)}) {
+        hot_utils::SamplingProfilerOptions profiler;
+        profiler.interval = interval;
+        if (!hot_utils::start_sampling_profiler(profiler)) {
+            std::printf("sampling profiler unavailable on this platform\n");
+            return 0;
+        }
+        const std::string name = "workload, sampling every " + std::to_string(interval.count()) + " us";
+        results.push_back(hot_utils::run_benchmark(name, [] {
+            hot_utils::do_not_optimize(sampling_profiler_workload());
+        }, options));
+        hot_utils::stop_sampling_profiler();
+        const auto stats = hot_utils::sampling_profile_stats();
+        std::printf("%s: %llu samples, %llu dropped\n", name.c_str(), static_cast<unsigned long long>(stats.samples),
+            static_cast<unsigned long long>(stats.dropped));
+    }
+    std::printf("\n");
+    hot_utils::print_benchmark_results(results);
+
+    std::printf("\nfolded stacks of the last run:\n");
+    hot_utils::write_sampling_profile_folded(stdout);
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/simd_kernels.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace {
+
+constexpr std::size_t kElements = 4096;
+
+template <typename T>
+struct Operands {
+    hot_utils::StreamlinedVector<T, kElements> a{};
+    hot_utils::StreamlinedVector<T, kElements> b{};
+    hot_utils::StreamlinedVector<T, kElements> out{};
+
+    Operands() {
+        for (std::size_t i = 0; i < kElements; ++i) {
+            a[i] = static_cast<T>(i % 97 + 1);
+            b[i] = static_cast<T>(i % 13 + 1);
+        }
+    }
+};
+
+template <typename T>
+void run_type(const char* type_name, const hot_utils::BenchmarkOptions& options) {
+    static Operands<T> operands;
+    auto& a = operands.a;
+    const auto& b = operands.b;
+    auto& out = operands.out;
+
+    const auto run = [&](const char* op, auto body) {
+        double scalar_median = 0.0;
+        for (int i = 0; i <= static_cast<int>(hot_utils::detected_simd_isa()); ++i) {
+            const auto isa = hot_utils::set_simd_isa(static_cast<hot_utils::SimdIsa>(i));
+            const std::string name = std::string(type_name) + " " + op + " [" + hot_utils::simd_isa_name(isa) + "]";
+            const auto result = hot_utils::run_benchmark(name, body, options);
+            if (isa == hot_utils::SimdIsa::Scalar) {
+                scalar_median = result.stats.median;
+            }
+            std::printf("%-32s %10.2f ns  %6.2fx\n", name.c_str(), result.stats.median,
+                scalar_median / result.stats.median);
+        }
+    };
+
+    run("v += w; v -= w", [&] {
+        a += b;
+        a -= b;
+        hot_utils::do_not_optimize(a);
+    });
+    run("v *= s; v /= s", [&] {
+        a *= T{3};
+        a /= T{3};
+        hot_utils::do_not_optimize(a);
+    });
+    run("out = v / w", [&] {
+        out = a / b;
+        hot_utils::do_not_optimize(out);
+    });
+    run("out = s - v", [&] {
+        out = T{3} - a;
+        hot_utils::do_not_optimize(out);
+    });
+    run("out = s / v", [&] {
+        out = T{1000} / a;
+        hot_utils::do_not_optimize(out);
+    });
+}
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    std::printf("StreamlinedVector<T, %zu> kernels, detected ISA: %s\n", kElements,
+        hot_utils::simd_isa_name(hot_utils::detected_simd_isa()));
+    run_type<float>("float", options);
+    run_type<double>("double", options);
+    run_type<std::int32_t>("int32", options);
+    run_type<std::int64_t>("int64", options);
+    return 0;
+}
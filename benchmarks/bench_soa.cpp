@@ -0,0 +1,119 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/streamlined_buffer.hpp"
+#include "hot_utils/streamlined_soa.hpp"
+
+namespace {
+
+constexpr std::size_t kParticles = std::size_t{1} << 16;
+constexpr float kDt = 0.001f;
+
+using Vec3 = hot_utils::StreamlinedVector<float, 3>;
+using SoA3 = hot_utils::StreamlinedSoA<float, 3>;
+
+std::vector<Vec3> make_points(float scale) {
+    std::vector<Vec3> out(kParticles);
+    for (std::size_t i = 0; i < kParticles; ++i) {
+        out[i] = Vec3{scale * static_cast<float>(i % 101), scale * static_cast<float>(i % 37), scale};
+    }
+    return out;
+}
+
+void compare(const char* workload, const hot_utils::BenchmarkResult& aos, const hot_utils::BenchmarkResult& soa) {
+    std::printf("%-28s AoS %10.2f us  SoA %10.2f us  %6.2fx\n", workload, aos.stats.median / 1e3,
+        soa.stats.median / 1e3, aos.stats.median / soa.stats.median);
+}
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    auto aos_positions = make_points(1.0f);
+    const auto aos_velocities = make_points(0.5f);
+    SoA3 soa_positions(aos_positions);
+    const SoA3 soa_velocities(aos_velocities);
+    hot_utils::StreamlinedBuffer<float> lengths(kParticles);
+
+    std::printf("%zu particles of StreamlinedVector<float, 3>\n", kParticles);
+
+    compare("integrate pos += vel * dt",
+        hot_utils::run_benchmark("aos integrate", [&] {
+            for (std::size_t i = 0; i < kParticles; ++i) {
+                aos_positions[i] += aos_velocities[i] * kDt;
+            }
+            hot_utils::do_not_optimize(aos_positions.data());
+        }, options),
+        hot_utils::run_benchmark("soa integrate", [&] {
+            hot_utils::axpy(kDt, soa_velocities, soa_positions);
+            hot_utils::do_not_optimize(soa_positions.column(0).data());
+        }, options));
+
+    compare("scale x component",
+        hot_utils::run_benchmark("aos scale x", [&] {
+            for (auto& p : aos_positions) {
+                p[0] *= 0.999f;
+            }
+            hot_utils::do_not_optimize(aos_positions.data());
+        }, options),
+        hot_utils::run_benchmark("soa scale x", [&] {
+            soa_positions.column(0) *= 0.999f;
+            hot_utils::do_not_optimize(soa_positions.column(0).data());
+        }, options));
+
+    compare("translate all points",
+        hot_utils::run_benchmark("aos translate", [&] {
+            for (auto& p : aos_positions) {
+                p += Vec3{0.5f, -0.5f, 0.25f};
+            }
+            hot_utils::do_not_optimize(aos_positions.data());
+        }, options),
+        hot_utils::run_benchmark("soa translate", [&] {
+            soa_positions += Vec3{0.5f, -0.5f, 0.25f};
+            hot_utils::do_not_optimize(soa_positions.column(0).data());
+        }, options));
+
+    compare("per-point length",
+        hot_utils::run_benchmark("aos length", [&] {
+            for (std::size_t i = 0; i < kParticles; ++i) {
+                const auto& p = aos_positions[i];
+                lengths[i] = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            }
+            hot_utils::do_not_optimize(lengths.data());
+        }, options),
+        hot_utils::run_benchmark("soa length", [&] {
+            const float* x = soa_positions.column(0).data();
+            const float* y = soa_positions.column(1).data();
+            const float* z = soa_positions.column(2).data();
+            float* out = lengths.data();
+            for (std::size_t i = 0; i < kParticles; ++i) {
+                out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            }
+            hot_utils::do_not_optimize(lengths.data());
+        }, options));
+
+    compare("sum of x components",
+        hot_utils::run_benchmark("aos sum x", [&] {
+            float total = 0.0f;
+            for (const auto& p : aos_positions) {
+                total += p[0];
+            }
+            return total;
+        }, options),
+        hot_utils::run_benchmark("soa sum x", [&] { return hot_utils::sum(soa_positions.column(0)); }, options));
+
+    const auto transpose = hot_utils::run_benchmark("aos -> soa", [&] {
+        soa_positions.assign_from(aos_positions.data());
+        hot_utils::do_not_optimize(soa_positions.column(0).data());
+    }, options);
+    std::printf("%-28s %10.2f us\n", "transpose AoS -> SoA", transpose.stats.median / 1e3);
+    return 0;
+}
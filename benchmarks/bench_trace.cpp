@@ -0,0 +1,50 @@
+#include <chrono>
+#include <cstdio>
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/log_utils.hpp"
+#include "hot_utils/scoped_timer.hpp"
+#include "hot_utils/trace.hpp"
+
+namespace {
+
+struct NullLogger {
+    void operator()(std::string_view, std::chrono::nanoseconds) const {}
+};
+
+} // namespace
+
+int main() {
+    hot_utils::BenchmarkOptions options;
+    options.samples = 10;
+    options.warmup = std::chrono::milliseconds(20);
+    options.min_sample_time = std::chrono::milliseconds(5);
+
+    // Tracing is independent of the log levels; keep the text output out of the measurement.
+    hot_utils::configure_logging("off");
+
+    int value = 0;
+    const auto call_off = hot_utils::run_benchmark("LOG_CALL, tracing off", [&value] {
+        hot_utils::do_not_optimize(HOT_UTILS_LOG_CALL(++value));
+    }, options);
+    const auto timer_off = hot_utils::run_benchmark("ScopedTimer, tracing off", [] {
+        hot_utils::ScopedTimer<std::chrono::nanoseconds, std::chrono::steady_clock, NullLogger> timer("step");
+    }, options);
+
+    // Large enough that no sample drops events.
+    hot_utils::TraceOptions trace;
+    trace.output_path.clear();
+    trace.max_events_per_thread = std::size_t{1} << 27;
+    hot_utils::start_tracing(trace);
+    const auto call_on = hot_utils::run_benchmark("LOG_CALL, tracing on", [&value] {
+        hot_utils::do_not_optimize(HOT_UTILS_LOG_CALL(++value));
+    }, options);
+    const auto timer_on = hot_utils::run_benchmark("ScopedTimer, tracing on", [] {
+        hot_utils::ScopedTimer<std::chrono::nanoseconds, std::chrono::steady_clock, NullLogger> timer("step");
+    }, options);
+    hot_utils::stop_tracing();
+
+    hot_utils::print_benchmark_results({call_off, timer_off, call_on, timer_on});
+    return 0;
+}
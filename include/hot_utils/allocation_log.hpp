@@ -0,0 +1,416 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "hot_utils/log_utils.hpp"
+#include "hot_utils/symbolize.hpp"
+
+namespace hot_utils {
+
+// Power-of-two request sizes: <=16, <=32, ..., <=4 MiB, then everything larger.
+inline constexpr std::size_t kAllocationSizeClasses = 20;
+
+struct AllocationStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytes_allocated = 0; // as requested
+    // Live bytes count the allocator's usable size, so frees of blocks allocated
+    // before the scope balance exactly. Zero unless kAllocationLiveBytes.
+    std::int64_t live_bytes = 0;
+    std::int64_t peak_live_bytes = 0;
+    std::array<std::uint64_t, kAllocationSizeClasses> size_classes{};
+};
+
+// A free only has the pointer, so live bytes need malloc_usable_size (glibc).
+// Elsewhere they are not tracked rather than only ever growing.
+#if defined(__GLIBC__)
+inline constexpr bool kAllocationLiveBytes = true;
+#else
+inline constexpr bool kAllocationLiveBytes = false;
+#endif
+
+// Upper bound of a size class, or 0 for the last, unbounded one.
+inline std::size_t allocation_size_class_limit(std::size_t size_class) noexcept {
+    return size_class + 1 < kAllocationSizeClasses ? std::size_t{16} << size_class : 0;
+}
+
+// An allocating call site, recorded when AllocationLogOptions::record_sites is set.
+struct AllocationSite {
+    std::uintptr_t caller = 0; // return address in the code that called operator new or allocate()
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+};
+
+struct AllocationLogOptions {
+    bool record_sites = false;
+};
+
+namespace detail {
+    inline constexpr std::size_t kAllocationSiteSlots = 32;
+
+    inline std::size_t allocation_size_class(std::size_t size) noexcept {
+        if (size <= 16) {
+            return 0;
+        }
+        const auto log2_ceil = static_cast<std::size_t>(64 - __builtin_clzll(static_cast<unsigned long long>(size - 1)));
+        return std::min(log2_ceil - 4, kAllocationSizeClasses - 1);
+    }
+
+    inline std::int64_t usable_size(void* ptr) noexcept {
+#if defined(__GLIBC__)
+        return static_cast<std::int64_t>(malloc_usable_size(ptr));
+#else
+        (void)ptr;
+        return 0;
+#endif
+    }
+
+    // One ScopedAllocationLog's counters, linked to the enclosing scope on the
+    // same thread. Updated from inside operator new, so nothing here allocates.
+    struct AllocationScopeState {
+        AllocationStats stats;
+        bool record_sites = false;
+        std::size_t dropped_sites = 0;
+        std::array<AllocationSite, kAllocationSiteSlots> sites{};
+        AllocationScopeState* parent = nullptr;
+
+        void on_allocate(std::size_t size, std::int64_t usable, std::uintptr_t caller) noexcept {
+            ++stats.allocations;
+            stats.bytes_allocated += size;
+            ++stats.size_classes[allocation_size_class(size)];
+            stats.live_bytes += usable;
+            stats.peak_live_bytes = std::max(stats.peak_live_bytes, stats.live_bytes);
+            if (record_sites) {
+                record_site(size, caller);
+            }
+        }
+
+        void on_deallocate(std::int64_t usable) noexcept {
+            ++stats.deallocations;
+            stats.live_bytes -= usable;
+        }
+
+        void record_site(std::size_t size, std::uintptr_t caller) noexcept {
+            for (auto& site : sites) {
+                if (site.caller == caller || site.caller == 0) {
+                    site.caller = caller;
+                    ++site.allocations;
+                    site.bytes += size;
+                    return;
+                }
+            }
+            ++dropped_sites;
+        }
+    };
+
+    // Constant-initialized, so the hooks read it without a TLS init guard.
+    inline thread_local AllocationScopeState* allocation_scope = nullptr;
+
+    inline std::atomic<bool> allocation_hooks_installed{false};
+
+    inline void note_allocation(void* ptr, std::size_t size, void* caller) noexcept {
+        AllocationScopeState* scope = allocation_scope;
+        if (scope == nullptr || ptr == nullptr) {
+            return;
+        }
+        const std::int64_t usable = usable_size(ptr);
+        for (; scope != nullptr; scope = scope->parent) {
+            scope->on_allocate(size, usable, reinterpret_cast<std::uintptr_t>(caller));
+        }
+    }
+
+    inline void note_deallocation(void* ptr) noexcept {
+        AllocationScopeState* scope = allocation_scope;
+        if (scope == nullptr || ptr == nullptr) {
+            return;
+        }
+        const std::int64_t usable = usable_size(ptr);
+        for (; scope != nullptr; scope = scope->parent) {
+            scope->on_deallocate(usable);
+        }
+    }
+
+    // The bodies of the replacement operators defined by HOT_UTILS_DEFINE_ALLOCATION_HOOKS.
+    inline void* hooked_allocate(std::size_t size, std::size_t alignment, void* caller, bool nothrow) {
+        const std::size_t bytes = size == 0 ? 1 : size;
+        void* ptr = nullptr;
+        while (true) {
+            if (alignment <= alignof(std::max_align_t)) {
+                ptr = std::malloc(bytes);
+            } else {
+                ptr = std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+            }
+            if (ptr != nullptr) {
+                break;
+            }
+            const std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                if (nothrow) {
+                    return nullptr;
+                }
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+        note_allocation(ptr, size, caller);
+        return ptr;
+    }
+
+    inline void hooked_deallocate(void* ptr) noexcept {
+        if (ptr != nullptr) {
+            note_deallocation(ptr);
+            std::free(ptr);
+        }
+    }
+
+    // Formats the stats as "[ALLOC] label: ..." lines.
+    inline std::string format_allocation_stats(std::string_view label, const AllocationStats& stats) {
+        char buf[256];
+        std::snprintf(buf, sizeof(buf), "%.*s: %llu allocations, %llu bytes, %llu frees, peak live %lld bytes, net %+lld bytes",
+            static_cast<int>(label.size()), label.data(), static_cast<unsigned long long>(stats.allocations),
+            static_cast<unsigned long long>(stats.bytes_allocated), static_cast<unsigned long long>(stats.deallocations),
+            static_cast<long long>(stats.peak_live_bytes), static_cast<long long>(stats.live_bytes));
+        std::string out = buf;
+        if (stats.allocations == 0) {
+            return out;
+        }
+        out += "; sizes";
+        for (std::size_t i = 0; i < kAllocationSizeClasses; ++i) {
+            if (stats.size_classes[i] == 0) {
+                continue;
+            }
+            const std::size_t limit = allocation_size_class_limit(i);
+            if (limit != 0) {
+                std::snprintf(buf, sizeof(buf), " <=%zu:%llu", limit, static_cast<unsigned long long>(stats.size_classes[i]));
+            } else {
+                std::snprintf(buf, sizeof(buf), " >%zu:%llu", allocation_size_class_limit(i - 1),
+                    static_cast<unsigned long long>(stats.size_classes[i]));
+            }
+            out += buf;
+        }
+        return out;
+    }
+} // namespace detail
+
+// True once HOT_UTILS_DEFINE_ALLOCATION_HOOKS is linked into the program.
+// Without the hooks only TrackingAllocator allocations are seen.
+inline bool allocation_hooks_installed() noexcept {
+    return detail::allocation_hooks_installed.load(std::memory_order_relaxed);
+}
+
+// Reports "[ALLOC] label: <n> allocations, ..." plus the allocating sites, if recorded.
+struct DefaultAllocationLogger {
+    void operator()(std::string_view label, const AllocationStats& stats, const AllocationSite* sites,
+        std::size_t site_count) const {
+        if (!log_enabled<LogLevel::Info>(log_categories::alloc)) {
+            return;
+        }
+        detail::log_line("ALLOC", detail::format_allocation_stats(label, stats));
+        for (std::size_t i = 0; i < site_count; ++i) {
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "  %llu allocations, %llu bytes from ",
+                static_cast<unsigned long long>(sites[i].allocations), static_cast<unsigned long long>(sites[i].bytes));
+            detail::log_line("ALLOC", buf + detail::symbolize(sites[i].caller));
+        }
+    }
+};
+
+// Counts the heap allocations made on this thread while in scope: allocation
+// and free counts, requested bytes, peak live bytes and a size-class histogram,
+// optionally with the allocating call sites. Scopes nest; each sees everything
+// its inner scopes see. Reported through Logger on destruction.
+template <class Logger = DefaultAllocationLogger>
+class ScopedAllocationLog {
+public:
+    explicit ScopedAllocationLog(
+        std::string_view label = "", AllocationLogOptions options = {}, Logger logger = Logger{})
+        : label_(label)
+        , logger_(std::move(logger)) {
+        state_.record_sites = options.record_sites;
+        state_.parent = detail::allocation_scope;
+        detail::allocation_scope = &state_;
+    }
+
+    ScopedAllocationLog(const ScopedAllocationLog&) = delete;
+    ScopedAllocationLog& operator=(const ScopedAllocationLog&) = delete;
+
+    ~ScopedAllocationLog() {
+        close();
+        std::array<AllocationSite, detail::kAllocationSiteSlots> sites = state_.sites;
+        const auto used = static_cast<std::size_t>(std::count_if(
+            sites.begin(), sites.end(), [](const AllocationSite& site) { return site.caller != 0; }));
+        std::sort(sites.begin(), sites.begin() + static_cast<std::ptrdiff_t>(used),
+            [](const AllocationSite& a, const AllocationSite& b) { return a.bytes > b.bytes; });
+        logger_(label_, state_.stats, sites.data(), used);
+    }
+
+    // Counters so far; usable inside the scope, e.g. to assert on.
+    const AllocationStats& stats() const noexcept { return state_.stats; }
+
+private:
+    // Unlinks this scope; the logger may allocate and must not be counted.
+    void close() noexcept {
+        if (detail::allocation_scope == &state_) {
+            detail::allocation_scope = state_.parent;
+        }
+    }
+
+    std::string_view label_;
+    Logger logger_;
+    detail::AllocationScopeState state_;
+};
+
+using AllocationViolationHandler = void (*)(std::string_view label, const AllocationStats& stats);
+
+namespace detail {
+    // Internal linkage on purpose: each translation unit reports through gtest
+    // when it included gtest before this header, and aborts otherwise.
+    [[maybe_unused]] static void report_unexpected_allocation(std::string_view label, const AllocationStats& stats) {
+        const std::string message = format_allocation_stats(label.empty() ? "no-allocation scope" : label, stats);
+#if defined(GTEST_INCLUDE_GTEST_GTEST_H_) || defined(GOOGLETEST_INCLUDE_GTEST_GTEST_H_)
+        ADD_FAILURE() << "unexpected heap allocation: " << message;
+#else
+        log_line("ERROR", "unexpected heap allocation: " + message);
+        std::abort();
+#endif
+    }
+} // namespace detail
+
+// Fails when the enclosing scope allocates on this thread. The default handler
+// adds a gtest failure in tests (include gtest first) and aborts elsewhere.
+// Needs HOT_UTILS_DEFINE_ALLOCATION_HOOKS to see plain new/delete.
+class NoAllocationScope {
+public:
+    explicit NoAllocationScope(
+        std::string_view label = "", AllocationViolationHandler handler = &detail::report_unexpected_allocation)
+        : label_(label)
+        , handler_(handler) {
+        state_.parent = detail::allocation_scope;
+        detail::allocation_scope = &state_;
+    }
+
+    NoAllocationScope(const NoAllocationScope&) = delete;
+    NoAllocationScope& operator=(const NoAllocationScope&) = delete;
+
+    ~NoAllocationScope() {
+        if (detail::allocation_scope == &state_) {
+            detail::allocation_scope = state_.parent;
+        }
+        if (state_.stats.allocations != 0 && handler_ != nullptr) {
+            handler_(label_, state_.stats);
+        }
+    }
+
+private:
+    std::string_view label_;
+    AllocationViolationHandler handler_;
+    detail::AllocationScopeState state_;
+};
+
+// std::allocator replacement that reports to the active allocation scopes
+// without the global hooks, e.g. std::vector<int, TrackingAllocator<int>>.
+// Allocates with malloc, so it is never counted twice when the hooks are installed.
+template <typename T>
+class TrackingAllocator {
+public:
+    using value_type = T;
+
+    TrackingAllocator() noexcept = default;
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U>&) noexcept {}
+
+    __attribute__((noinline)) T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(
+            detail::hooked_allocate(n * sizeof(T), alignof(T), __builtin_return_address(0), false));
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept { detail::hooked_deallocate(ptr); }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const TrackingAllocator<U>&) const noexcept {
+        return false;
+    }
+};
+
+} // namespace hot_utils
+
+// Replaces the global operator new and delete with versions that report to
+// ScopedAllocationLog and NoAllocationScope. Use once per program, at namespace
+// scope in one source file:
+//   HOT_UTILS_DEFINE_ALLOCATION_HOOKS()
+// Outside a scope the hooks cost one thread_local load over plain malloc/free.
+#define HOT_UTILS_DEFINE_ALLOCATION_HOOKS()                                                                            \
+    static const bool hot_utils_allocation_hooks_marker = [] {                                                         \
+        ::hot_utils::detail::allocation_hooks_installed.store(true, std::memory_order_relaxed);                        \
+        return true;                                                                                                   \
+    }();                                                                                                               \
+    void* operator new(std::size_t size) {                                                                             \
+        return ::hot_utils::detail::hooked_allocate(size, 0, __builtin_return_address(0), false);                      \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size) {                                                                           \
+        return ::hot_utils::detail::hooked_allocate(size, 0, __builtin_return_address(0), false);                      \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, const std::nothrow_t&) noexcept {                                             \
+        return ::hot_utils::detail::hooked_allocate(size, 0, __builtin_return_address(0), true);                       \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {                                           \
+        return ::hot_utils::detail::hooked_allocate(size, 0, __builtin_return_address(0), true);                       \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, std::align_val_t alignment) {                                                 \
+        return ::hot_utils::detail::hooked_allocate(                                                                   \
+            size, static_cast<std::size_t>(alignment), __builtin_return_address(0), false);                            \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, std::align_val_t alignment) {                                               \
+        return ::hot_utils::detail::hooked_allocate(                                                                   \
+            size, static_cast<std::size_t>(alignment), __builtin_return_address(0), false);                            \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {                 \
+        return ::hot_utils::detail::hooked_allocate(                                                                   \
+            size, static_cast<std::size_t>(alignment), __builtin_return_address(0), true);                             \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {               \
+        return ::hot_utils::detail::hooked_allocate(                                                                   \
+            size, static_cast<std::size_t>(alignment), __builtin_return_address(0), true);                             \
+    }                                                                                                                  \
+    void operator delete(void* ptr) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); }                          \
+    void operator delete[](void* ptr) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); }                        \
+    void operator delete(void* ptr, std::size_t) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); }             \
+    void operator delete[](void* ptr, std::size_t) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); }           \
+    void operator delete(void* ptr, const std::nothrow_t&) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); }   \
+    void operator delete[](void* ptr, const std::nothrow_t&) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); } \
+    void operator delete(void* ptr, std::align_val_t) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); }        \
+    void operator delete[](void* ptr, std::align_val_t) noexcept { ::hot_utils::detail::hooked_deallocate(ptr); }      \
+    void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {                                          \
+        ::hot_utils::detail::hooked_deallocate(ptr);                                                                   \
+    }                                                                                                                  \
+    void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {                                        \
+        ::hot_utils::detail::hooked_deallocate(ptr);                                                                   \
+    }                                                                                                                  \
+    void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {                                \
+        ::hot_utils::detail::hooked_deallocate(ptr);                                                                   \
+    }                                                                                                                  \
+    void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {                              \
+        ::hot_utils::detail::hooked_deallocate(ptr);                                                                   \
+    }
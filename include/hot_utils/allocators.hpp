@@ -0,0 +1,425 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+
+#include "hot_utils/allocation_log.hpp"
+#include "hot_utils/log_utils.hpp"
+
+namespace hot_utils {
+
+// Counters kept by the allocators below when instantiated with AllocatorStats.
+struct AllocatorStats {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytes_allocated = 0;
+    std::int64_t bytes_in_use = 0; // handed out and not yet freed, rewound or reset
+    std::int64_t peak_bytes_in_use = 0;
+    std::uint64_t upstream_allocations = 0; // arena chunks and pool slabs taken from the heap
+    std::uint64_t upstream_bytes = 0;
+    std::uint64_t rewinds = 0;
+
+    void on_allocate(std::size_t bytes) noexcept {
+        ++allocations;
+        bytes_allocated += bytes;
+        bytes_in_use += static_cast<std::int64_t>(bytes);
+        peak_bytes_in_use = std::max(peak_bytes_in_use, bytes_in_use);
+    }
+
+    void on_deallocate(std::size_t bytes) noexcept {
+        ++deallocations;
+        bytes_in_use -= static_cast<std::int64_t>(bytes);
+    }
+
+    void on_rewind(std::size_t bytes) noexcept {
+        ++rewinds;
+        bytes_in_use -= static_cast<std::int64_t>(bytes);
+    }
+
+    void on_upstream(std::size_t bytes) noexcept {
+        ++upstream_allocations;
+        upstream_bytes += bytes;
+    }
+
+    // Logs "[ALLOC] label: ..." at Info in the alloc category.
+    void report(std::string_view label) const {
+        if (!log_enabled<LogLevel::Info>(log_categories::alloc)) {
+            return;
+        }
+        char buf[256];
+        std::snprintf(buf, sizeof(buf),
+            "%.*s: %llu allocations, %llu bytes, %llu frees, %llu rewinds, in use %lld bytes (peak %lld), "
+            "%llu upstream allocations (%llu bytes)",
+            static_cast<int>(label.size()), label.data(), static_cast<unsigned long long>(allocations),
+            static_cast<unsigned long long>(bytes_allocated), static_cast<unsigned long long>(deallocations),
+            static_cast<unsigned long long>(rewinds), static_cast<long long>(bytes_in_use),
+            static_cast<long long>(peak_bytes_in_use), static_cast<unsigned long long>(upstream_allocations),
+            static_cast<unsigned long long>(upstream_bytes));
+        detail::log_line("ALLOC", buf);
+    }
+};
+
+// The default: counts nothing and compiles away.
+struct NoAllocatorStats {
+    void on_allocate(std::size_t) noexcept {}
+    void on_deallocate(std::size_t) noexcept {}
+    void on_rewind(std::size_t) noexcept {}
+    void on_upstream(std::size_t) noexcept {}
+    void report(std::string_view) const {}
+};
+
+namespace detail {
+    inline std::uintptr_t align_up(std::uintptr_t value, std::size_t alignment) noexcept {
+        return (value + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    }
+
+    struct alignas(std::max_align_t) ArenaChunk {
+        ArenaChunk* next;
+        std::size_t capacity;
+
+        char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+    };
+} // namespace detail
+
+// Bump allocator over a chain of heap chunks that grow geometrically.
+// deallocate() is a no-op; memory comes back all at once through rewind() to
+// a mark() or reset(), which keep the chunks for reuse, or release(). Chunks
+// are taken through the allocation hooks, so ScopedAllocationLog and
+// NoAllocationScope see the arena growing but not the allocations it serves.
+// Not thread-safe. A non-empty label reports Stats when the arena is destroyed.
+template <class Stats = NoAllocatorStats>
+class MonotonicArena {
+public:
+    // A position to rewind() to; valid until an earlier mark is rewound to or the arena is reset.
+    struct Marker {
+        detail::ArenaChunk* chunk = nullptr;
+        std::size_t offset = 0;
+        std::size_t requested = 0;
+    };
+
+    static constexpr std::size_t kMaxChunkSize = std::size_t{16} << 20;
+
+    explicit MonotonicArena(std::size_t initial_chunk_size = 4096, std::string_view label = "") noexcept
+        : next_chunk_size_(std::max<std::size_t>(initial_chunk_size, 64))
+        , label_(label) {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        if (!label_.empty()) {
+            stats_.report(label_);
+        }
+        release();
+    }
+
+    // alignment must be a power of two.
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        if (current_ != nullptr) {
+            const auto base = reinterpret_cast<std::uintptr_t>(current_->data());
+            const std::uintptr_t start = detail::align_up(base + offset_, alignment);
+            if (start + size <= base + current_->capacity) {
+                offset_ = start + size - base;
+                requested_ += size;
+                stats_.on_allocate(size);
+                return reinterpret_cast<void*>(start);
+            }
+        }
+        next_chunk(size, alignment);
+        return allocate(size, alignment);
+    }
+
+    void deallocate(void*, std::size_t) noexcept {}
+
+    Marker mark() const noexcept { return Marker{current_, offset_, requested_}; }
+
+    // Frees everything allocated since marker at once.
+    void rewind(const Marker& marker) noexcept {
+        stats_.on_rewind(requested_ - marker.requested);
+        current_ = marker.chunk;
+        offset_ = marker.offset;
+        requested_ = marker.requested;
+    }
+
+    // Frees everything, keeping the chunks for the next allocations.
+    void reset() noexcept { rewind(Marker{}); }
+
+    // Frees everything and returns the chunks to the heap.
+    void release() noexcept {
+        reset();
+        while (first_ != nullptr) {
+            detail::ArenaChunk* next = first_->next;
+            detail::hooked_deallocate(first_);
+            first_ = next;
+        }
+        capacity_ = 0;
+    }
+
+    std::size_t bytes_allocated() const noexcept { return requested_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    const Stats& stats() const noexcept { return stats_; }
+
+private:
+    // Moves to the next kept chunk if the request fits there, else links a new one in before it.
+    __attribute__((noinline)) void next_chunk(std::size_t size, std::size_t alignment) {
+        const std::size_t needed = size + alignment;
+        detail::ArenaChunk** link = current_ != nullptr ? &current_->next : &first_;
+        if (*link == nullptr || (*link)->capacity < needed) {
+            const std::size_t capacity = std::max(next_chunk_size_, needed);
+            next_chunk_size_ = std::min(next_chunk_size_ * 2, kMaxChunkSize);
+            void* raw = detail::hooked_allocate(
+                sizeof(detail::ArenaChunk) + capacity, alignof(detail::ArenaChunk), __builtin_return_address(0), false);
+            *link = ::new (raw) detail::ArenaChunk{*link, capacity};
+            capacity_ += capacity;
+            stats_.on_upstream(capacity);
+        }
+        current_ = *link;
+        offset_ = 0;
+    }
+
+    detail::ArenaChunk* first_ = nullptr;
+    detail::ArenaChunk* current_ = nullptr;
+    std::size_t offset_ = 0;
+    std::size_t requested_ = 0;
+    std::size_t capacity_ = 0;
+    std::size_t next_chunk_size_;
+    std::string_view label_;
+    Stats stats_;
+};
+
+// Standard allocator over a MonotonicArena, e.g.
+// std::vector<CopyMoveLog<int>, ArenaAllocator<CopyMoveLog<int>>> values(ArenaAllocator<CopyMoveLog<int>>(arena));
+// The arena must outlive the container.
+template <typename T, class Arena = MonotonicArena<>>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena) noexcept
+        : arena_(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, Arena>& other) noexcept
+        : arena_(other.arena()) {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept { arena_->deallocate(ptr, n * sizeof(T)); }
+
+    Arena* arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U, Arena>& other) const noexcept {
+        return arena_ == other.arena();
+    }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U, Arena>& other) const noexcept {
+        return arena_ != other.arena();
+    }
+
+private:
+    Arena* arena_;
+};
+
+// Free list of equally sized blocks carved from heap slabs. Freed blocks are
+// reused most recently freed first; slabs go back to the heap with the pool.
+// Not thread-safe. A non-empty label reports Stats when the pool is destroyed.
+template <class Stats = NoAllocatorStats>
+class FixedBlockPool {
+public:
+    explicit FixedBlockPool(std::size_t block_size, std::size_t alignment = alignof(std::max_align_t),
+        std::size_t slab_size = 64 * 1024, std::string_view label = "") noexcept
+        : alignment_(std::max(alignment, alignof(FreeBlock)))
+        , block_size_(detail::align_up(std::max(block_size, sizeof(FreeBlock)), alignment_))
+        , blocks_per_slab_(std::max<std::size_t>(slab_size / block_size_, 16))
+        , label_(label) {}
+
+    FixedBlockPool(const FixedBlockPool&) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+    ~FixedBlockPool() {
+        if (!label_.empty()) {
+            stats_.report(label_);
+        }
+        while (slabs_ != nullptr) {
+            Slab* next = slabs_->next;
+            detail::hooked_deallocate(slabs_);
+            slabs_ = next;
+        }
+    }
+
+    void* allocate() {
+        if (free_ == nullptr) {
+            add_slab();
+        }
+        FreeBlock* block = free_;
+        free_ = block->next;
+        stats_.on_allocate(block_size_);
+        return block;
+    }
+
+    void deallocate(void* ptr) noexcept {
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_;
+        free_ = block;
+        stats_.on_deallocate(block_size_);
+    }
+
+    std::size_t block_size() const noexcept { return block_size_; }
+    std::size_t slab_count() const noexcept { return slab_count_; }
+    const Stats& stats() const noexcept { return stats_; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct alignas(std::max_align_t) Slab {
+        Slab* next;
+    };
+
+    __attribute__((noinline)) void add_slab() {
+        const std::size_t header = detail::align_up(sizeof(Slab), alignment_);
+        const std::size_t bytes = header + blocks_per_slab_ * block_size_;
+        void* raw = detail::hooked_allocate(bytes, alignment_, __builtin_return_address(0), false);
+        slabs_ = ::new (raw) Slab{slabs_};
+        ++slab_count_;
+        stats_.on_upstream(bytes);
+        // Pushed from the back so the first blocks handed out are in address order.
+        char* blocks = static_cast<char*>(raw) + header;
+        for (std::size_t i = blocks_per_slab_; i-- > 0;) {
+            auto* block = reinterpret_cast<FreeBlock*>(blocks + i * block_size_);
+            block->next = free_;
+            free_ = block;
+        }
+    }
+
+    std::size_t alignment_;
+    std::size_t block_size_;
+    std::size_t blocks_per_slab_;
+    FreeBlock* free_ = nullptr;
+    Slab* slabs_ = nullptr;
+    std::size_t slab_count_ = 0;
+    std::string_view label_;
+    Stats stats_;
+};
+
+// Standard allocator serving single objects from a per-thread, per-type
+// FixedBlockPool; larger requests (vector storage) go to the heap. Suits node
+// containers: std::list<CopyMoveLog<int>, PoolAllocator<CopyMoveLog<int>>>.
+// A block must be freed on the thread that allocated it, and before that
+// thread exits.
+template <typename T, class Stats = NoAllocatorStats>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, Stats>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n == 1) {
+            return static_cast<T*>(pool().allocate());
+        }
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(
+            detail::hooked_allocate(n * sizeof(T), alignof(T), __builtin_return_address(0), false));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        if (n == 1) {
+            pool().deallocate(ptr);
+        } else {
+            detail::hooked_deallocate(ptr);
+        }
+    }
+
+    // This thread's pool for T.
+    static FixedBlockPool<Stats>& pool() {
+        thread_local FixedBlockPool<Stats> blocks(sizeof(T), alignof(T));
+        return blocks;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U, Stats>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U, Stats>&) const noexcept {
+        return false;
+    }
+};
+
+// std::pmr view of a MonotonicArena, for std::pmr containers.
+template <class Arena = MonotonicArena<>>
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(Arena& arena) noexcept
+        : arena_(&arena) {}
+
+    Arena& arena() const noexcept { return *arena_; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override { return arena_->allocate(bytes, alignment); }
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t) override { arena_->deallocate(ptr, bytes); }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    Arena* arena_;
+};
+
+// Counts what goes through an upstream std::pmr resource (by default the
+// process default) and reports it under label when destroyed.
+template <class Stats = AllocatorStats>
+class InstrumentedResource : public std::pmr::memory_resource {
+public:
+    explicit InstrumentedResource(
+        std::string_view label = "", std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : upstream_(upstream)
+        , label_(label) {}
+
+    InstrumentedResource(const InstrumentedResource&) = delete;
+    InstrumentedResource& operator=(const InstrumentedResource&) = delete;
+
+    ~InstrumentedResource() override {
+        if (!label_.empty()) {
+            stats_.report(label_);
+        }
+    }
+
+    std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+    const Stats& stats() const noexcept { return stats_; }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* ptr = upstream_->allocate(bytes, alignment);
+        stats_.on_allocate(bytes);
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+        upstream_->deallocate(ptr, bytes, alignment);
+        stats_.on_deallocate(bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* upstream_;
+    std::string_view label_;
+    Stats stats_;
+};
+
+} // namespace hot_utils
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "hot_utils/log_utils.hpp"
+
+namespace hot_utils {
+
+// What a thread does when its ring is full.
+enum class LogOverflow {
+    Drop,  // discard the record silently (still counted in AsyncLogStats)
+    Block, // wait for the drain thread to make room
+    Count, // discard the record and have the drain thread report how many were lost
+};
+
+struct AsyncLogOptions {
+    // Records per thread; rounded up to a power of two. Applies to rings created after the call.
+    std::size_t ring_capacity = 1024;
+    LogOverflow overflow = LogOverflow::Count;
+    // How long the drain thread sleeps once every ring is empty.
+    std::chrono::microseconds drain_interval{1000};
+    std::FILE* out = stderr;
+};
+
+struct AsyncLogStats {
+    std::uint64_t written = 0;
+    std::uint64_t dropped = 0;
+};
+
+namespace detail {
+    // One log call, copied verbatim by the producer and formatted by the drain thread.
+    // Messages longer than kTextBytes are truncated.
+    struct alignas(64) AsyncLogRecord {
+        static constexpr std::size_t kTextBytes = 208;
+
+        // Left uninitialized: rings can be large and every field is written before publishing.
+        bool is_call;
+        std::uint16_t length;
+        int line;
+        std::uint32_t depth;
+        const char* level;
+        const char* file;
+        const char* func;
+        const char* expr;
+        char text[kTextBytes];
+    };
+    static_assert(sizeof(AsyncLogRecord) == 256, "AsyncLogRecord should span four cache lines");
+
+    // Single-producer (owning thread), single-consumer (drain thread) ring.
+    // Each side caches the other's index so the fast path touches no shared line.
+    class AsyncLogRing {
+    public:
+        explicit AsyncLogRing(std::size_t capacity)
+            : mask_(capacity - 1)
+            , records_(new AsyncLogRecord[capacity]) {}
+
+        template <typename Fill>
+        bool try_push(Fill&& fill) noexcept {
+            const std::uint64_t head = head_.load(std::memory_order_relaxed);
+            if (head - cached_tail_ > mask_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head - cached_tail_ > mask_) {
+                    return false;
+                }
+            }
+            fill(records_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        template <typename Consume>
+        std::size_t drain(Consume&& consume) {
+            const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+            const std::uint64_t head = head_.load(std::memory_order_acquire);
+            for (std::uint64_t i = tail; i != head; ++i) {
+                consume(records_[i & mask_]);
+            }
+            tail_.store(head, std::memory_order_release);
+            return static_cast<std::size_t>(head - tail);
+        }
+
+        bool empty() const noexcept {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+        std::atomic<std::uint64_t> dropped{0};
+        std::uint64_t reported_drops = 0; // drain thread only
+        std::atomic<bool> closed{false};  // owning thread exited
+
+    private:
+        const std::uint64_t mask_;
+        std::unique_ptr<AsyncLogRecord[]> records_;
+        alignas(64) std::atomic<std::uint64_t> head_{0};
+        std::uint64_t cached_tail_ = 0;
+        alignas(64) std::atomic<std::uint64_t> tail_{0};
+    };
+
+    inline std::size_t round_up_to_power_of_two(std::size_t value) noexcept {
+        std::size_t out = 1;
+        while (out < value) {
+            out <<= 1;
+        }
+        return out;
+    }
+
+    // Owns the rings and the drain thread. Rings are registered once per thread
+    // and released by the drain thread after their thread exits and they run dry.
+    class AsyncLogBackend {
+    public:
+        static AsyncLogBackend& instance() {
+            static AsyncLogBackend backend;
+            return backend;
+        }
+
+        AsyncLogBackend(const AsyncLogBackend&) = delete;
+        AsyncLogBackend& operator=(const AsyncLogBackend&) = delete;
+
+        // Process exit is the last flush: everything still queued is written before the thread joins.
+        ~AsyncLogBackend() {
+            active_log_sink.store(nullptr, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            if (drainer_.joinable()) {
+                drainer_.join();
+            }
+        }
+
+        void enable(const AsyncLogOptions& options) {
+            ring_capacity_.store(round_up_to_power_of_two(std::max<std::size_t>(options.ring_capacity, 2)),
+                std::memory_order_relaxed);
+            overflow_.store(options.overflow, std::memory_order_relaxed);
+            drain_interval_.store(options.drain_interval.count(), std::memory_order_relaxed);
+            out_.store(options.out, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                if (!drainer_.joinable()) {
+                    drainer_ = std::thread([this] { drain_loop(); });
+                }
+            }
+            wake_.notify_all();
+            active_log_sink.store(&kSink, std::memory_order_release);
+        }
+
+        // Back to synchronous writes. Records already queued are still written by the drain thread.
+        void disable() {
+            active_log_sink.store(nullptr, std::memory_order_release);
+            flush();
+        }
+
+        bool enabled() const noexcept { return active_log_sink.load(std::memory_order_acquire) == &kSink; }
+
+        // Returns once every record pushed before the call has been written and the stream flushed.
+        void flush() {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            if (!drainer_.joinable()) {
+                return;
+            }
+            const std::uint64_t request = ++flush_requested_;
+            wake_.notify_all();
+            while (flush_completed_ < request) {
+                flushed_.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+
+        AsyncLogStats stats() const noexcept {
+            return AsyncLogStats{written_.load(std::memory_order_relaxed), dropped_.load(std::memory_order_relaxed)};
+        }
+
+        void push_line(const char* level, std::string_view msg) {
+            push([level, msg](AsyncLogRecord& record) {
+                record.is_call = false;
+                record.level = level;
+                record.length = static_cast<std::uint16_t>(std::min(msg.size(), AsyncLogRecord::kTextBytes));
+                std::memcpy(record.text, msg.data(), record.length);
+            });
+        }
+
+        void push_call(const char* file, int line, const char* func, const char* expr, std::size_t depth) {
+            push([=](AsyncLogRecord& record) {
+                record.is_call = true;
+                record.file = file;
+                record.line = line;
+                record.func = func;
+                record.expr = expr;
+                record.depth = static_cast<std::uint32_t>(depth);
+            });
+        }
+
+    private:
+        AsyncLogBackend() = default;
+
+        struct RingHandle {
+            std::shared_ptr<AsyncLogRing> ring;
+
+            ~RingHandle() {
+                if (ring) {
+                    ring->closed.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        static void sink_line(const char* level, std::string_view msg) { instance().push_line(level, msg); }
+
+        static void sink_call(const char* file, int line, const char* func, const char* expr, std::size_t depth) {
+            instance().push_call(file, line, func, expr, depth);
+        }
+
+        static constexpr LogSink kSink{&sink_line, &sink_call};
+
+        AsyncLogRing& this_thread_ring() {
+            thread_local RingHandle handle;
+            if (!handle.ring) {
+                handle.ring = std::make_shared<AsyncLogRing>(ring_capacity_.load(std::memory_order_relaxed));
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings_.push_back(handle.ring);
+            }
+            return *handle.ring;
+        }
+
+        template <typename Fill>
+        void push(Fill&& fill) {
+            AsyncLogRing& ring = this_thread_ring();
+            if (ring.try_push(fill)) {
+                return;
+            }
+            if (overflow_.load(std::memory_order_relaxed) == LogOverflow::Block) {
+                wake_.notify_one();
+                while (!ring.try_push(fill)) {
+                    std::this_thread::yield();
+                }
+                return;
+            }
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void write_record(std::FILE* out, const AsyncLogRecord& record) {
+            if (record.is_call) {
+                write_log_call(out, record.file, record.line, record.func, record.expr, record.depth);
+            } else {
+                write_log_line(out, record.level, std::string_view(record.text, record.length));
+            }
+        }
+
+        // One pass over every ring. Returns the number of records written.
+        std::size_t drain_rings() {
+            std::vector<std::shared_ptr<AsyncLogRing>> rings;
+            {
+                std::lock_guard<std::mutex> lock(rings_mutex_);
+                rings = rings_;
+            }
+            std::FILE* out = out_.load(std::memory_order_relaxed);
+            std::size_t written = 0;
+            for (const auto& ring : rings) {
+                written += ring->drain([&](const AsyncLogRecord& record) { write_record(out, record); });
+                const std::uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+                if (dropped != ring->reported_drops) {
+                    if (overflow_.load(std::memory_order_relaxed) == LogOverflow::Count) {
+                        char buf[64];
+                        std::snprintf(buf, sizeof(buf), "dropped %llu records",
+                            static_cast<unsigned long long>(dropped - ring->reported_drops));
+                        write_log_line(out, "LOG", buf);
+                    }
+                    ring->reported_drops = dropped;
+                }
+            }
+            if (written != 0) {
+                std::fflush(out);
+                written_.fetch_add(written, std::memory_order_relaxed);
+            }
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                             [](const auto& ring) {
+                                 return ring->closed.load(std::memory_order_acquire) && ring->empty();
+                             }),
+                rings_.end());
+            return written;
+        }
+
+        void drain_loop() {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            while (true) {
+                const std::uint64_t request = flush_requested_;
+                const bool stopping = stopping_;
+                lock.unlock();
+                while (drain_rings() != 0) {
+                }
+                std::fflush(out_.load(std::memory_order_relaxed));
+                lock.lock();
+                if (request > flush_completed_) {
+                    flush_completed_ = request;
+                    flushed_.notify_all();
+                }
+                if (stopping) {
+                    return;
+                }
+                if (flush_requested_ == request && !stopping_) {
+                    wake_.wait_for(lock, std::chrono::microseconds(drain_interval_.load(std::memory_order_relaxed)));
+                }
+            }
+        }
+
+        std::atomic<std::size_t> ring_capacity_{1024};
+        std::atomic<LogOverflow> overflow_{LogOverflow::Count};
+        std::atomic<std::chrono::microseconds::rep> drain_interval_{1000};
+        std::atomic<std::FILE*> out_{stderr};
+        std::atomic<std::uint64_t> written_{0};
+        std::atomic<std::uint64_t> dropped_{0};
+
+        std::mutex rings_mutex_;
+        std::vector<std::shared_ptr<AsyncLogRing>> rings_;
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_;
+        std::condition_variable flushed_;
+        std::uint64_t flush_requested_ = 0;
+        std::uint64_t flush_completed_ = 0;
+        bool stopping_ = false;
+        std::thread drainer_;
+    };
+} // namespace detail
+
+// Routes log_debug, ScopedTimer reports, CopyMoveLog events and HOT_UTILS_LOG_CALL
+// through per-thread lock-free rings drained by a background thread. The caller
+// only copies the message; formatting and stdio happen on the drain thread.
+// Lines from different threads may be written out of order relative to each other.
+inline void enable_async_logging(const AsyncLogOptions& options = {}) {
+    detail::AsyncLogBackend::instance().enable(options);
+}
+
+// Restores synchronous stderr logging after writing everything already queued.
+inline void disable_async_logging() {
+    detail::AsyncLogBackend::instance().disable();
+}
+
+inline bool async_logging_enabled() noexcept {
+    return detail::AsyncLogBackend::instance().enabled();
+}
+
+// Blocks until every record logged before the call is written.
+inline void flush_async_log() {
+    detail::AsyncLogBackend::instance().flush();
+}
+
+inline AsyncLogStats async_log_stats() noexcept {
+    return detail::AsyncLogBackend::instance().stats();
+}
+
+} // namespace hot_utils
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "hot_utils/streamlined_vector.hpp"
+#include "hot_utils/thread_pool.hpp"
+
+namespace hot_utils {
+
+struct BatchOptions {
+    // Pool to run on; default_thread_pool() when null.
+    ThreadPool* pool = nullptr;
+    // Batches touching fewer bytes than this run on the calling thread.
+    std::size_t serial_threshold_bytes = std::size_t{256} << 10;
+    // Bytes of destination data per task. Small enough that a chunk and its operands stay in L2.
+    std::size_t chunk_bytes = std::size_t{32} << 10;
+};
+
+namespace detail {
+    inline std::size_t batch_grain(std::size_t bytes_per_item, const BatchOptions& options) noexcept {
+        return std::max<std::size_t>(options.chunk_bytes / std::max<std::size_t>(bytes_per_item, 1), 1);
+    }
+} // namespace detail
+
+// Calls op(i) for every i in [0, count), spread over the pool in cache-sized chunks.
+// bytes_per_item is the destination footprint of one call and drives chunking and the serial cut-off.
+template <typename F>
+void parallel_batch(std::size_t count, std::size_t bytes_per_item, F&& op, const BatchOptions& options = {}) {
+    if (count * bytes_per_item < options.serial_threshold_bytes) {
+        for (std::size_t i = 0; i < count; ++i) {
+            op(i);
+        }
+        return;
+    }
+    ThreadPool& pool = options.pool != nullptr ? *options.pool : default_thread_pool();
+    pool.parallel_for(count, detail::batch_grain(bytes_per_item, options), [&op](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            op(i);
+        }
+    });
+}
+
+// Calls op(vectors[i], i) on every vector in place.
+template <typename T, std::size_t N, typename F>
+void batch_apply(StreamlinedVector<T, N>* vectors, std::size_t count, F&& op, const BatchOptions& options = {}) {
+    parallel_batch(
+        count, sizeof(StreamlinedVector<T, N>), [&](std::size_t i) { op(vectors[i], i); }, options);
+}
+
+template <typename T, std::size_t N, typename F>
+void batch_apply(std::vector<StreamlinedVector<T, N>>& vectors, F&& op, const BatchOptions& options = {}) {
+    batch_apply(vectors.data(), vectors.size(), std::forward<F>(op), options);
+}
+
+// out[i] = make(i) for every i. make usually returns a lazy expression over the
+// i-th operands, e.g. [&](std::size_t i) { return v[i] * s + w[i]; }, which is
+// evaluated straight into out[i].
+template <typename T, std::size_t N, typename F>
+void batch_assign(StreamlinedVector<T, N>* out, std::size_t count, F&& make, const BatchOptions& options = {}) {
+    parallel_batch(
+        count, sizeof(StreamlinedVector<T, N>), [&](std::size_t i) { out[i] = make(i); }, options);
+}
+
+template <typename T, std::size_t N, typename F>
+void batch_assign(std::vector<StreamlinedVector<T, N>>& out, F&& make, const BatchOptions& options = {}) {
+    batch_assign(out.data(), out.size(), std::forward<F>(make), options);
+}
+
+} // namespace hot_utils
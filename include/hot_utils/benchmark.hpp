@@ -0,0 +1,436 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/scoped_timer.hpp"
+
+// Recorded as git_sha in written results; CMake passes the configured checkout's
+// HEAD to the benchmarks. The HOT_UTILS_GIT_SHA environment variable overrides it.
+#ifndef HOT_UTILS_GIT_SHA
+#define HOT_UTILS_GIT_SHA "unknown"
+#endif
+
+namespace hot_utils {
+
+struct BenchmarkOptions {
+    std::chrono::nanoseconds warmup = std::chrono::milliseconds(100);
+    std::chrono::nanoseconds min_sample_time = std::chrono::milliseconds(10);
+    std::size_t samples = 30;
+    std::size_t max_iterations = std::size_t{1} << 32;
+};
+
+// All statistics are in nanoseconds per iteration.
+struct BenchmarkStats {
+    double min = 0.0;
+    double median = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double p99 = 0.0;
+};
+
+// A per-iteration figure reported next to the timings, e.g. bytes or cache misses.
+struct BenchmarkCounter {
+    std::string name;
+    double value = 0.0;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::size_t iterations = 0;
+    std::vector<double> samples;
+    BenchmarkStats stats;
+    std::vector<BenchmarkCounter> counters;
+};
+
+// Where a set of results came from; written alongside them.
+struct BenchmarkContext {
+    std::string git_sha;
+    std::string cpu_model;
+    std::string compiler;
+    std::string date; // UTC, ISO 8601
+};
+
+namespace detail {
+    struct CaptureTimerLogger {
+        std::chrono::nanoseconds* out = nullptr;
+
+        void operator()(std::string_view, std::chrono::nanoseconds elapsed) const { *out = elapsed; }
+    };
+
+    using BenchmarkTimer = ScopedTimer<std::chrono::nanoseconds, std::chrono::steady_clock, CaptureTimerLogger>;
+
+    template <typename F>
+    inline void invoke_benchmark_body(F& body) {
+        if constexpr (std::is_void_v<std::invoke_result_t<F&>>) {
+            body();
+            compiler_barrier();
+        } else {
+            do_not_optimize(body());
+        }
+    }
+
+    template <typename F>
+    inline std::chrono::nanoseconds time_iterations(F& body, std::size_t iterations) {
+        std::chrono::nanoseconds elapsed{0};
+        {
+            BenchmarkTimer timer("", CaptureTimerLogger{&elapsed});
+            for (std::size_t i = 0; i < iterations; ++i) {
+                invoke_benchmark_body(body);
+            }
+        }
+        return elapsed;
+    }
+
+    // Grows the iteration count until a single sample lasts at least min_sample_time.
+    template <typename F>
+    inline std::size_t calibrate_iterations(F& body, const BenchmarkOptions& options) {
+        std::size_t iterations = 1;
+        while (iterations < options.max_iterations) {
+            const auto elapsed = time_iterations(body, iterations);
+            if (elapsed >= options.min_sample_time) {
+                break;
+            }
+            const double target = static_cast<double>(options.min_sample_time.count());
+            const double spent = static_cast<double>(std::max<std::chrono::nanoseconds::rep>(elapsed.count(), 1));
+            const double scaled = static_cast<double>(iterations) * target / spent * 1.2;
+            const double capped = std::min(scaled, static_cast<double>(iterations) * 10.0);
+            iterations = std::min(options.max_iterations, std::max(iterations * 2, static_cast<std::size_t>(capped)));
+        }
+        return iterations;
+    }
+
+    inline double percentile_of_sorted(const std::vector<double>& sorted, double fraction) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const double rank = fraction * static_cast<double>(sorted.size() - 1);
+        const auto lower = static_cast<std::size_t>(rank);
+        const auto upper = std::min(lower + 1, sorted.size() - 1);
+        const double weight = rank - static_cast<double>(lower);
+        return sorted[lower] + (sorted[upper] - sorted[lower]) * weight;
+    }
+} // namespace detail
+
+inline BenchmarkStats compute_benchmark_stats(std::vector<double> samples) {
+    BenchmarkStats stats;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+    for (const double sample : samples) {
+        sum += sample;
+    }
+    stats.mean = sum / static_cast<double>(samples.size());
+
+    double squares = 0.0;
+    for (const double sample : samples) {
+        squares += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = samples.size() > 1 ? std::sqrt(squares / static_cast<double>(samples.size() - 1)) : 0.0;
+
+    stats.min = samples.front();
+    stats.median = detail::percentile_of_sorted(samples, 0.5);
+    stats.p99 = detail::percentile_of_sorted(samples, 0.99);
+    return stats;
+}
+
+// Runs body() in a timed loop. Non-void results are passed through do_not_optimize.
+template <typename F>
+BenchmarkResult run_benchmark(std::string name, F&& body, const BenchmarkOptions& options = {}) {
+    auto& fn = body;
+    BenchmarkResult result;
+    result.name = std::move(name);
+    result.iterations = detail::calibrate_iterations(fn, options);
+
+    const auto warmup_start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - warmup_start < options.warmup) {
+        detail::time_iterations(fn, result.iterations);
+    }
+
+    result.samples.reserve(options.samples);
+    for (std::size_t i = 0; i < options.samples; ++i) {
+        const auto elapsed = detail::time_iterations(fn, result.iterations);
+        result.samples.push_back(static_cast<double>(elapsed.count()) / static_cast<double>(result.iterations));
+    }
+    result.stats = compute_benchmark_stats(result.samples);
+    return result;
+}
+
+struct BenchmarkEntry {
+    std::string name;
+    std::function<BenchmarkResult(const BenchmarkOptions&)> run;
+};
+
+inline std::vector<BenchmarkEntry>& benchmark_registry() {
+    static std::vector<BenchmarkEntry> registry;
+    return registry;
+}
+
+template <typename F>
+bool register_benchmark(std::string name, F body) {
+    auto entry_name = name;
+    benchmark_registry().push_back(BenchmarkEntry{std::move(entry_name),
+        [name = std::move(name), body = std::move(body)](const BenchmarkOptions& options) mutable {
+            return run_benchmark(name, body, options);
+        }});
+    return true;
+}
+
+// Runs every registered benchmark whose name contains filter.
+inline std::vector<BenchmarkResult> run_benchmarks(const BenchmarkOptions& options = {}, std::string_view filter = "") {
+    std::vector<BenchmarkResult> results;
+    for (auto& entry : benchmark_registry()) {
+        if (entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        results.push_back(entry.run(options));
+    }
+    return results;
+}
+
+namespace detail {
+    inline std::string read_cpu_model() {
+        std::string model = "unknown";
+        std::FILE* in = std::fopen("/proc/cpuinfo", "r");
+        if (in == nullptr) {
+            return model;
+        }
+        char line[512];
+        while (std::fgets(line, sizeof(line), in) != nullptr) {
+            const char* colon = std::strchr(line, ':');
+            if (std::strncmp(line, "model name", 10) != 0 || colon == nullptr) {
+                continue;
+            }
+            std::string_view value(colon + 1);
+            while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+                value.remove_prefix(1);
+            }
+            while (!value.empty() && (value.back() == '\n' || value.back() == ' ')) {
+                value.remove_suffix(1);
+            }
+            model = std::string(value);
+            break;
+        }
+        std::fclose(in);
+        return model;
+    }
+
+    inline void write_json_string(std::string& out, std::string_view text) {
+        out += '"';
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    // RFC 4180: quoted when the field holds a comma, quote or line break.
+    inline void write_csv_field(std::string& out, std::string_view text) {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out += text;
+            return;
+        }
+        out += '"';
+        for (const char c : text) {
+            if (c == '"') {
+                out += '"';
+            }
+            out += c;
+        }
+        out += '"';
+    }
+
+    inline void append_number(std::string& out, double value) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.9g", value);
+        out += buf;
+    }
+
+    inline bool ends_with(std::string_view text, std::string_view suffix) noexcept {
+        return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+    }
+} // namespace detail
+
+// The current build and machine. Reads /proc/cpuinfo, so call it once per run.
+inline BenchmarkContext benchmark_context() {
+    BenchmarkContext context;
+    const char* sha = std::getenv("HOT_UTILS_GIT_SHA");
+    context.git_sha = sha != nullptr && *sha != '\0' ? sha : HOT_UTILS_GIT_SHA;
+    context.cpu_model = detail::read_cpu_model();
+#if defined(__clang__)
+    context.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    context.compiler = "gcc " __VERSION__;
+#else
+    context.compiler = "unknown";
+#endif
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    char date[32] = "unknown";
+    if (gmtime_r(&now, &utc) != nullptr) {
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    }
+    context.date = date;
+    return context;
+}
+
+// {"context": {...}, "benchmarks": [{"name", "iterations", "min_ns", ..., "samples_ns": [...], "counters": {...}}]}
+inline void write_benchmark_json(
+    const std::vector<BenchmarkResult>& results, std::FILE* out, const BenchmarkContext& context = benchmark_context()) {
+    std::string text = "{\n  \"context\": {\"git_sha\": ";
+    detail::write_json_string(text, context.git_sha);
+    text += ", \"cpu_model\": ";
+    detail::write_json_string(text, context.cpu_model);
+    text += ", \"compiler\": ";
+    detail::write_json_string(text, context.compiler);
+    text += ", \"date\": ";
+    detail::write_json_string(text, context.date);
+    text += "},\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        text += i == 0 ? "\n    {\"name\": " : ",\n    {\"name\": ";
+        detail::write_json_string(text, result.name);
+        text += ", \"iterations\": " + std::to_string(result.iterations);
+        const std::pair<const char*, double> stats[] = {{"min_ns", result.stats.min}, {"median_ns", result.stats.median},
+            {"mean_ns", result.stats.mean}, {"stddev_ns", result.stats.stddev}, {"p99_ns", result.stats.p99}};
+        for (const auto& [key, value] : stats) {
+            text += std::string(", \"") + key + "\": ";
+            detail::append_number(text, value);
+        }
+        text += ", \"samples_ns\": [";
+        for (std::size_t j = 0; j < result.samples.size(); ++j) {
+            text += j == 0 ? "" : ", ";
+            detail::append_number(text, result.samples[j]);
+        }
+        text += "], \"counters\": {";
+        for (std::size_t j = 0; j < result.counters.size(); ++j) {
+            text += j == 0 ? "" : ", ";
+            detail::write_json_string(text, result.counters[j].name);
+            text += ": ";
+            detail::append_number(text, result.counters[j].value);
+        }
+        text += "}}";
+    }
+    text += "\n  ]\n}\n";
+    std::fputs(text.c_str(), out);
+}
+
+// One row per benchmark. samples_ns is ';'-separated, counters are "name=value" pairs
+// separated by ';', and the context is repeated on every row.
+inline void write_benchmark_csv(
+    const std::vector<BenchmarkResult>& results, std::FILE* out, const BenchmarkContext& context = benchmark_context()) {
+    std::string text =
+        "name,iterations,min_ns,median_ns,mean_ns,stddev_ns,p99_ns,samples_ns,counters,git_sha,cpu_model,compiler,date\n";
+    for (const auto& result : results) {
+        detail::write_csv_field(text, result.name);
+        text += "," + std::to_string(result.iterations);
+        for (const double value :
+            {result.stats.min, result.stats.median, result.stats.mean, result.stats.stddev, result.stats.p99}) {
+            text += ',';
+            detail::append_number(text, value);
+        }
+        std::string list;
+        for (std::size_t j = 0; j < result.samples.size(); ++j) {
+            list += j == 0 ? "" : ";";
+            detail::append_number(list, result.samples[j]);
+        }
+        text += ',' + list + ',';
+        list.clear();
+        for (std::size_t j = 0; j < result.counters.size(); ++j) {
+            list += (j == 0 ? "" : ";") + result.counters[j].name + "=";
+            detail::append_number(list, result.counters[j].value);
+        }
+        detail::write_csv_field(text, list);
+        for (const std::string* field : {&context.git_sha, &context.cpu_model, &context.compiler, &context.date}) {
+            text += ',';
+            detail::write_csv_field(text, *field);
+        }
+        text += '\n';
+    }
+    std::fputs(text.c_str(), out);
+}
+
+// Writes CSV when path ends in ".csv", JSON otherwise. Returns false if path cannot be written.
+inline bool write_benchmark_results(
+    const std::string& path, const std::vector<BenchmarkResult>& results, const BenchmarkContext& context = benchmark_context()) {
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        return false;
+    }
+    if (detail::ends_with(path, ".csv")) {
+        write_benchmark_csv(results, out, context);
+    } else {
+        write_benchmark_json(results, out, context);
+    }
+    return std::fclose(out) == 0;
+}
+
+// Prints the table. When HOT_UTILS_BENCHMARK_OUT names a file, every result
+// printed so far by the process is also (re)written there, e.g.
+//   HOT_UTILS_BENCHMARK_OUT=base.json ./bench_allocators
+inline void print_benchmark_results(const std::vector<BenchmarkResult>& results, std::FILE* out = stdout) {
+    std::fprintf(out, "%-40s %12s %10s %10s %10s %10s %10s\n", "benchmark", "iterations", "min ns", "median ns",
+        "mean ns", "stddev ns", "p99 ns");
+    for (const auto& result : results) {
+        const auto& s = result.stats;
+        std::fprintf(out, "%-40s %12zu %10.2f %10.2f %10.2f %10.2f %10.2f\n", result.name.c_str(), result.iterations,
+            s.min, s.median, s.mean, s.stddev, s.p99);
+    }
+    const char* path = std::getenv("HOT_UTILS_BENCHMARK_OUT");
+    if (path == nullptr || *path == '\0') {
+        return;
+    }
+    static std::vector<BenchmarkResult> printed;
+    static const BenchmarkContext context = benchmark_context();
+    printed.insert(printed.end(), results.begin(), results.end());
+    if (!write_benchmark_results(path, printed, context)) {
+        detail::log_line("ERROR", std::string("cannot write benchmark results to ") + path);
+    }
+}
+
+// ScopedTimer logger appending one JSON object per scope to out, e.g.
+// {"label": "parse", "ns": 1234}, so timer results can be collected and compared.
+struct JsonTimerLogger {
+    std::FILE* out = stdout;
+
+    template <class Rep, class Period>
+    void operator()(std::string_view label, std::chrono::duration<Rep, Period> elapsed) const {
+        std::string line = "{\"label\": ";
+        detail::write_json_string(line, label);
+        line += ", \"ns\": " + std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + "}\n";
+        std::fputs(line.c_str(), out);
+    }
+};
+
+} // namespace hot_utils
+
+// Registers a benchmark whose body is executed once per iteration.
+#define HOT_UTILS_BENCHMARK(name)                                                                                     \
+    static void hot_utils_benchmark_##name();                                                                         \
+    [[maybe_unused]] static const bool hot_utils_benchmark_registered_##name =                                        \
+        ::hot_utils::register_benchmark(#name, &hot_utils_benchmark_##name);                                          \
+    static void hot_utils_benchmark_##name()
@@ -0,0 +1,601 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "hot_utils/benchmark.hpp"
+
+namespace hot_utils {
+
+// Results read back from write_benchmark_json or write_benchmark_csv output.
+struct BenchmarkReport {
+    BenchmarkContext context;
+    std::vector<BenchmarkResult> results;
+};
+
+namespace detail {
+    // Just enough JSON for the result files: objects keep their key order.
+    struct JsonValue {
+        enum class Kind { Null, Bool, Number, String, Array, Object };
+
+        Kind kind = Kind::Null;
+        bool boolean = false;
+        double number = 0.0;
+        std::string string;
+        std::vector<std::string> keys; // objects: keys[i] names items[i]
+        std::vector<JsonValue> items;
+
+        const JsonValue* find(std::string_view key) const noexcept {
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                if (keys[i] == key) {
+                    return &items[i];
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    class JsonParser {
+    public:
+        explicit JsonParser(const std::string& text) noexcept
+            : text_(text) {}
+
+        bool parse(JsonValue& out, std::string* error) {
+            if (!value(out, 0)) {
+                return fail(error);
+            }
+            skip_space();
+            if (pos_ != text_.size()) {
+                error_ = "trailing characters";
+                return fail(error);
+            }
+            return true;
+        }
+
+    private:
+        static constexpr int kMaxDepth = 64;
+
+        bool fail(std::string* error) const {
+            if (error != nullptr) {
+                *error = error_ + " at offset " + std::to_string(pos_);
+            }
+            return false;
+        }
+
+        void skip_space() noexcept {
+            while (pos_ < text_.size()
+                && (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\r' || text_[pos_] == '\t')) {
+                ++pos_;
+            }
+        }
+
+        bool literal(std::string_view word) noexcept {
+            if (text_.compare(pos_, word.size(), word) != 0) {
+                error_ = "invalid literal";
+                return false;
+            }
+            pos_ += word.size();
+            return true;
+        }
+
+        bool value(JsonValue& out, int depth) {
+            skip_space();
+            if (pos_ == text_.size()) {
+                error_ = "unexpected end of input";
+                return false;
+            }
+            if (depth > kMaxDepth) {
+                error_ = "nesting too deep";
+                return false;
+            }
+            switch (text_[pos_]) {
+            case '{':
+                return object(out, depth);
+            case '[':
+                return array(out, depth);
+            case '"':
+                out.kind = JsonValue::Kind::String;
+                return string(out.string);
+            case 't':
+                out.kind = JsonValue::Kind::Bool;
+                out.boolean = true;
+                return literal("true");
+            case 'f':
+                out.kind = JsonValue::Kind::Bool;
+                return literal("false");
+            case 'n':
+                return literal("null");
+            default:
+                return number(out);
+            }
+        }
+
+        bool number(JsonValue& out) {
+            const char* start = text_.c_str() + pos_;
+            char* end = nullptr;
+            out.number = std::strtod(start, &end);
+            if (end == start) {
+                error_ = "unexpected character";
+                return false;
+            }
+            out.kind = JsonValue::Kind::Number;
+            pos_ += static_cast<std::size_t>(end - start);
+            return true;
+        }
+
+        bool string(std::string& out) {
+            ++pos_; // opening quote
+            while (pos_ < text_.size()) {
+                const char c = text_[pos_++];
+                if (c == '"') {
+                    return true;
+                }
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos_ == text_.size()) {
+                    break;
+                }
+                const char escape = text_[pos_++];
+                switch (escape) {
+                case 'b':
+                    out += '\b';
+                    break;
+                case 'f':
+                    out += '\f';
+                    break;
+                case 'n':
+                    out += '\n';
+                    break;
+                case 'r':
+                    out += '\r';
+                    break;
+                case 't':
+                    out += '\t';
+                    break;
+                case 'u':
+                    if (!unicode_escape(out)) {
+                        return false;
+                    }
+                    break;
+                default:
+                    out += escape; // '"', '\\' and '/'
+                }
+            }
+            error_ = "unterminated string";
+            return false;
+        }
+
+        // \uXXXX, BMP only, written as UTF-8.
+        bool unicode_escape(std::string& out) {
+            if (pos_ + 4 > text_.size()) {
+                error_ = "truncated \\u escape";
+                return false;
+            }
+            const std::string digits = text_.substr(pos_, 4);
+            char* end = nullptr;
+            const unsigned long code = std::strtoul(digits.c_str(), &end, 16);
+            if (end != digits.c_str() + 4) {
+                error_ = "invalid \\u escape";
+                return false;
+            }
+            pos_ += 4;
+            if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else if (code < 0x800) {
+                out += static_cast<char>(0xc0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            } else {
+                out += static_cast<char>(0xe0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (code & 0x3f));
+            }
+            return true;
+        }
+
+        bool array(JsonValue& out, int depth) {
+            out.kind = JsonValue::Kind::Array;
+            ++pos_;
+            skip_space();
+            if (pos_ < text_.size() && text_[pos_] == ']') {
+                ++pos_;
+                return true;
+            }
+            while (true) {
+                out.items.emplace_back();
+                if (!value(out.items.back(), depth + 1)) {
+                    return false;
+                }
+                skip_space();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                if (pos_ < text_.size() && text_[pos_] == ']') {
+                    ++pos_;
+                    return true;
+                }
+                error_ = "expected ',' or ']'";
+                return false;
+            }
+        }
+
+        bool object(JsonValue& out, int depth) {
+            out.kind = JsonValue::Kind::Object;
+            ++pos_;
+            skip_space();
+            if (pos_ < text_.size() && text_[pos_] == '}') {
+                ++pos_;
+                return true;
+            }
+            while (true) {
+                skip_space();
+                if (pos_ == text_.size() || text_[pos_] != '"') {
+                    error_ = "expected a key";
+                    return false;
+                }
+                out.keys.emplace_back();
+                if (!string(out.keys.back())) {
+                    return false;
+                }
+                skip_space();
+                if (pos_ == text_.size() || text_[pos_] != ':') {
+                    error_ = "expected ':'";
+                    return false;
+                }
+                ++pos_;
+                out.items.emplace_back();
+                if (!value(out.items.back(), depth + 1)) {
+                    return false;
+                }
+                skip_space();
+                if (pos_ < text_.size() && text_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                if (pos_ < text_.size() && text_[pos_] == '}') {
+                    ++pos_;
+                    return true;
+                }
+                error_ = "expected ',' or '}'";
+                return false;
+            }
+        }
+
+        const std::string& text_;
+        std::size_t pos_ = 0;
+        std::string error_;
+    };
+
+    inline double json_number(const JsonValue& object, std::string_view key) noexcept {
+        const JsonValue* value = object.find(key);
+        return value != nullptr && value->kind == JsonValue::Kind::Number ? value->number : 0.0;
+    }
+
+    inline std::string json_string(const JsonValue& object, std::string_view key) {
+        const JsonValue* value = object.find(key);
+        return value != nullptr && value->kind == JsonValue::Kind::String ? value->string : std::string();
+    }
+
+    inline bool parse_benchmark_json(const std::string& text, BenchmarkReport& out, std::string* error) {
+        JsonValue root;
+        if (!JsonParser(text).parse(root, error)) {
+            return false;
+        }
+        const JsonValue* benchmarks = root.find("benchmarks");
+        if (benchmarks == nullptr || benchmarks->kind != JsonValue::Kind::Array) {
+            if (error != nullptr) {
+                *error = "no \"benchmarks\" array";
+            }
+            return false;
+        }
+        if (const JsonValue* context = root.find("context")) {
+            out.context = BenchmarkContext{json_string(*context, "git_sha"), json_string(*context, "cpu_model"),
+                json_string(*context, "compiler"), json_string(*context, "date")};
+        }
+        for (const JsonValue& entry : benchmarks->items) {
+            BenchmarkResult result;
+            result.name = json_string(entry, "name");
+            result.iterations = static_cast<std::size_t>(json_number(entry, "iterations"));
+            result.stats = BenchmarkStats{json_number(entry, "min_ns"), json_number(entry, "median_ns"),
+                json_number(entry, "mean_ns"), json_number(entry, "stddev_ns"), json_number(entry, "p99_ns")};
+            if (const JsonValue* samples = entry.find("samples_ns")) {
+                for (const JsonValue& sample : samples->items) {
+                    result.samples.push_back(sample.number);
+                }
+            }
+            if (const JsonValue* counters = entry.find("counters")) {
+                for (std::size_t i = 0; i < counters->keys.size(); ++i) {
+                    result.counters.push_back(BenchmarkCounter{counters->keys[i], counters->items[i].number});
+                }
+            }
+            out.results.push_back(std::move(result));
+        }
+        return true;
+    }
+
+    // RFC 4180 records; quoted fields may hold commas, quotes and line breaks.
+    inline std::vector<std::vector<std::string>> parse_csv(const std::string& text) {
+        std::vector<std::vector<std::string>> rows;
+        std::vector<std::string> row;
+        std::string field;
+        bool quoted = false;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            const char c = text[i];
+            if (quoted) {
+                if (c == '"' && i + 1 < text.size() && text[i + 1] == '"') {
+                    field += '"';
+                    ++i;
+                } else if (c == '"') {
+                    quoted = false;
+                } else {
+                    field += c;
+                }
+            } else if (c == '"') {
+                quoted = true;
+            } else if (c == ',') {
+                row.push_back(std::move(field));
+                field.clear();
+            } else if (c == '\n') {
+                row.push_back(std::move(field));
+                field.clear();
+                rows.push_back(std::move(row));
+                row.clear();
+            } else if (c != '\r') {
+                field += c;
+            }
+        }
+        if (!field.empty() || !row.empty()) {
+            row.push_back(std::move(field));
+            rows.push_back(std::move(row));
+        }
+        return rows;
+    }
+
+    inline std::vector<std::string> split(const std::string& text, char separator) {
+        std::vector<std::string> parts;
+        std::size_t start = 0;
+        while (start < text.size()) {
+            std::size_t end = text.find(separator, start);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            parts.push_back(text.substr(start, end - start));
+            start = end + 1;
+        }
+        return parts;
+    }
+
+    inline bool parse_benchmark_csv(const std::string& text, BenchmarkReport& out, std::string* error) {
+        const auto rows = parse_csv(text);
+        if (rows.empty()) {
+            if (error != nullptr) {
+                *error = "empty CSV";
+            }
+            return false;
+        }
+        const auto& header = rows.front();
+        const auto column = [&header](std::string_view name) -> std::size_t {
+            return static_cast<std::size_t>(std::find(header.begin(), header.end(), name) - header.begin());
+        };
+        const std::size_t name = column("name");
+        if (name == header.size()) {
+            if (error != nullptr) {
+                *error = "no \"name\" column";
+            }
+            return false;
+        }
+        for (std::size_t r = 1; r < rows.size(); ++r) {
+            const auto& row = rows[r];
+            const auto field = [&row](std::size_t index) -> std::string {
+                return index < row.size() ? row[index] : std::string();
+            };
+            const auto number = [&field](std::size_t index) { return std::strtod(field(index).c_str(), nullptr); };
+            BenchmarkResult result;
+            result.name = field(name);
+            result.iterations = static_cast<std::size_t>(number(column("iterations")));
+            result.stats = BenchmarkStats{number(column("min_ns")), number(column("median_ns")),
+                number(column("mean_ns")), number(column("stddev_ns")), number(column("p99_ns"))};
+            for (const auto& sample : split(field(column("samples_ns")), ';')) {
+                result.samples.push_back(std::strtod(sample.c_str(), nullptr));
+            }
+            for (const auto& counter : split(field(column("counters")), ';')) {
+                const std::size_t equals = counter.rfind('=');
+                if (equals != std::string::npos) {
+                    result.counters.push_back(
+                        BenchmarkCounter{counter.substr(0, equals), std::strtod(counter.c_str() + equals + 1, nullptr)});
+                }
+            }
+            if (r == 1) {
+                out.context = BenchmarkContext{
+                    field(column("git_sha")), field(column("cpu_model")), field(column("compiler")), field(column("date"))};
+            }
+            out.results.push_back(std::move(result));
+        }
+        return true;
+    }
+} // namespace detail
+
+// Reads JSON (first non-blank character '{') or CSV results into out.
+inline bool read_benchmark_results(std::FILE* in, BenchmarkReport& out, std::string* error = nullptr) {
+    std::string text;
+    char buf[4096];
+    std::size_t read = 0;
+    while ((read = std::fread(buf, 1, sizeof(buf), in)) != 0) {
+        text.append(buf, read);
+    }
+    const std::size_t first = text.find_first_not_of(" \t\r\n");
+    if (first != std::string::npos && text[first] == '{') {
+        return detail::parse_benchmark_json(text, out, error);
+    }
+    return detail::parse_benchmark_csv(text, out, error);
+}
+
+inline bool read_benchmark_results(const std::string& path, BenchmarkReport& out, std::string* error = nullptr) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        if (error != nullptr) {
+            *error = "cannot open " + path;
+        }
+        return false;
+    }
+    const bool ok = read_benchmark_results(in, out, error);
+    std::fclose(in);
+    return ok;
+}
+
+struct MannWhitneyResult {
+    double u = 0.0;       // U statistic of the first sample set
+    double z = 0.0;       // normal approximation; positive when the first set ranks higher
+    double p_value = 1.0; // two-sided
+};
+
+// Mann-Whitney U test with average ranks for ties, the tie-corrected variance
+// and a continuity correction. The normal approximation is reasonable from
+// about 8 samples per side; fewer than 2 on either side gives p = 1.
+inline MannWhitneyResult mann_whitney_u(const std::vector<double>& a, const std::vector<double>& b) {
+    MannWhitneyResult result;
+    const std::size_t n1 = a.size();
+    const std::size_t n2 = b.size();
+    if (n1 < 2 || n2 < 2) {
+        return result;
+    }
+    std::vector<std::pair<double, bool>> pooled; // value, from a
+    pooled.reserve(n1 + n2);
+    for (const double value : a) {
+        pooled.emplace_back(value, true);
+    }
+    for (const double value : b) {
+        pooled.emplace_back(value, false);
+    }
+    std::sort(pooled.begin(), pooled.end(),
+        [](const std::pair<double, bool>& x, const std::pair<double, bool>& y) { return x.first < y.first; });
+
+    double rank_sum = 0.0;
+    double tie_term = 0.0;
+    for (std::size_t i = 0; i < pooled.size();) {
+        std::size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+            ++j;
+        }
+        const double average_rank = static_cast<double>(i + j + 1) / 2.0; // ranks are 1-based
+        for (std::size_t k = i; k < j; ++k) {
+            if (pooled[k].second) {
+                rank_sum += average_rank;
+            }
+        }
+        const double ties = static_cast<double>(j - i);
+        tie_term += ties * ties * ties - ties;
+        i = j;
+    }
+
+    const double m = static_cast<double>(n1);
+    const double n = static_cast<double>(n2);
+    const double total = m + n;
+    result.u = rank_sum - m * (m + 1.0) / 2.0;
+    const double mean = m * n / 2.0;
+    const double variance = m * n / 12.0 * ((total + 1.0) - tie_term / (total * (total - 1.0)));
+    if (variance <= 0.0) {
+        return result; // every value tied
+    }
+    const double deviation = result.u - mean;
+    const double corrected = std::max(std::fabs(deviation) - 0.5, 0.0);
+    result.z = std::copysign(corrected / std::sqrt(variance), deviation);
+    result.p_value = std::min(1.0, std::erfc(std::fabs(result.z) / std::sqrt(2.0)));
+    return result;
+}
+
+struct BenchmarkCompareOptions {
+    double alpha = 0.05;     // significance level of the U test
+    double threshold = 0.05; // relative median change that counts, 0.05 = 5%
+};
+
+enum class BenchmarkVerdict { Unchanged, Improved, Regressed, OnlyInBaseline, OnlyInCandidate };
+
+inline const char* benchmark_verdict_name(BenchmarkVerdict verdict) noexcept {
+    static constexpr const char* names[] = {"unchanged", "improved", "REGRESSED", "only in baseline", "only in candidate"};
+    return names[static_cast<int>(verdict)];
+}
+
+struct BenchmarkComparison {
+    std::string name;
+    double baseline_median = 0.0;
+    double candidate_median = 0.0;
+    double change = 0.0; // candidate / baseline - 1; positive is slower
+    double p_value = 1.0;
+    BenchmarkVerdict verdict = BenchmarkVerdict::Unchanged;
+};
+
+// Matches benchmarks by name. A benchmark regressed when its samples differ
+// significantly (p < alpha) and its median is more than threshold slower;
+// improved likewise in the other direction.
+inline std::vector<BenchmarkComparison> compare_benchmark_results(const std::vector<BenchmarkResult>& baseline,
+    const std::vector<BenchmarkResult>& candidate, const BenchmarkCompareOptions& options = {}) {
+    std::vector<BenchmarkComparison> out;
+    const auto find = [](const std::vector<BenchmarkResult>& results, const std::string& name) -> const BenchmarkResult* {
+        for (const auto& result : results) {
+            if (result.name == name) {
+                return &result;
+            }
+        }
+        return nullptr;
+    };
+    for (const auto& base : baseline) {
+        BenchmarkComparison comparison;
+        comparison.name = base.name;
+        comparison.baseline_median = base.stats.median;
+        const BenchmarkResult* cand = find(candidate, base.name);
+        if (cand == nullptr) {
+            comparison.verdict = BenchmarkVerdict::OnlyInBaseline;
+            out.push_back(std::move(comparison));
+            continue;
+        }
+        comparison.candidate_median = cand->stats.median;
+        comparison.change = base.stats.median > 0.0 ? cand->stats.median / base.stats.median - 1.0 : 0.0;
+        comparison.p_value = mann_whitney_u(base.samples, cand->samples).p_value;
+        if (comparison.p_value < options.alpha && comparison.change > options.threshold) {
+            comparison.verdict = BenchmarkVerdict::Regressed;
+        } else if (comparison.p_value < options.alpha && comparison.change < -options.threshold) {
+            comparison.verdict = BenchmarkVerdict::Improved;
+        }
+        out.push_back(std::move(comparison));
+    }
+    for (const auto& cand : candidate) {
+        if (find(baseline, cand.name) == nullptr) {
+            BenchmarkComparison comparison;
+            comparison.name = cand.name;
+            comparison.candidate_median = cand.stats.median;
+            comparison.verdict = BenchmarkVerdict::OnlyInCandidate;
+            out.push_back(std::move(comparison));
+        }
+    }
+    return out;
+}
+
+inline bool any_benchmark_regressed(const std::vector<BenchmarkComparison>& comparisons) noexcept {
+    return std::any_of(comparisons.begin(), comparisons.end(),
+        [](const BenchmarkComparison& c) { return c.verdict == BenchmarkVerdict::Regressed; });
+}
+
+inline void print_benchmark_comparison(const std::vector<BenchmarkComparison>& comparisons, std::FILE* out = stdout) {
+    std::fprintf(out, "%-40s %12s %12s %9s %9s  %s\n", "benchmark", "base ns", "new ns", "change", "p", "verdict");
+    for (const auto& c : comparisons) {
+        if (c.verdict == BenchmarkVerdict::OnlyInBaseline || c.verdict == BenchmarkVerdict::OnlyInCandidate) {
+            std::fprintf(out, "%-40s %12.2f %12.2f %9s %9s  %s\n", c.name.c_str(), c.baseline_median, c.candidate_median,
+                "-", "-", benchmark_verdict_name(c.verdict));
+            continue;
+        }
+        std::fprintf(out, "%-40s %12.2f %12.2f %+8.1f%% %9.4f  %s\n", c.name.c_str(), c.baseline_median,
+            c.candidate_median, c.change * 100.0, c.p_value, benchmark_verdict_name(c.verdict));
+    }
+}
+
+} // namespace hot_utils
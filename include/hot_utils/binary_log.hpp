@@ -0,0 +1,557 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hot_utils/log_utils.hpp"
+
+namespace hot_utils {
+
+// Text with static storage duration, written to the binary log as a small id
+// and spelled out once per stream. Use for literals and type names.
+struct InternedString {
+    std::string_view text;
+};
+
+namespace detail {
+    // Stream layout: the magic, then tagged records. Integers are LEB128 varints
+    // (zigzag for signed values) and strings are a varint length plus bytes.
+    //   'F' id level signature format   format definition, written once per stream
+    //   'S' id text                     interned string definition, written once per stream
+    //   'E' id args...                  event; args follow the format's signature
+    // Signature characters: i signed, u unsigned, d double, s interned string id, t inline text.
+    inline constexpr char kBinaryLogMagic[8] = {'H', 'U', 'B', 'L', 'O', 'G', '0', '1'};
+    inline constexpr std::size_t kBinaryLogBufferBytes = std::size_t{16} << 10;
+    inline constexpr std::size_t kBinaryLogMaxText = 1024;
+
+    inline std::atomic<bool> binary_log_enabled{false};
+
+    inline char* put_varint(char* out, std::uint64_t value) noexcept {
+        while (value >= 0x80) {
+            *out++ = static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        *out++ = static_cast<char>(value);
+        return out;
+    }
+
+    inline std::uint64_t zigzag(std::int64_t value) noexcept {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    inline std::int64_t unzigzag(std::uint64_t value) noexcept {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    inline void append_varint(std::string& out, std::uint64_t value) {
+        char buf[10];
+        out.append(buf, put_varint(buf, value));
+    }
+
+    inline void append_text(std::string& out, std::string_view text) {
+        append_varint(out, text.size());
+        out.append(text);
+    }
+
+    template <typename T>
+    struct IsDuration : std::false_type {};
+
+    template <typename Rep, typename Period>
+    struct IsDuration<std::chrono::duration<Rep, Period>> : std::true_type {};
+
+    template <typename T>
+    constexpr char binary_arg_code() {
+        using D = std::decay_t<T>;
+        if constexpr (std::is_same_v<D, InternedString>) {
+            return 's';
+        } else if constexpr (IsDuration<D>::value) {
+            return 'i';
+        } else if constexpr (std::is_same_v<D, bool> || (std::is_integral_v<D> && std::is_unsigned_v<D>)) {
+            return 'u';
+        } else if constexpr (std::is_integral_v<D>) {
+            return 'i';
+        } else if constexpr (std::is_floating_point_v<D>) {
+            return 'd';
+        } else {
+            static_assert(std::is_convertible_v<const D&, std::string_view>, "unsupported binary log argument type");
+            return 't';
+        }
+    }
+
+    struct BinaryLogSite {
+        const char* level;
+        const char* format;
+    };
+
+    // Per-thread staging area; events are appended here and handed to the file in bulk.
+    struct BinaryLogBuffer {
+        std::mutex mutex;
+        std::size_t size = 0;
+        char data[kBinaryLogBufferBytes];
+    };
+
+    class BinaryLogger {
+    public:
+        static BinaryLogger& instance() {
+            static BinaryLogger logger;
+            return logger;
+        }
+
+        BinaryLogger(const BinaryLogger&) = delete;
+        BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+        ~BinaryLogger() { disable(); }
+
+        void enable(std::FILE* out) {
+            disable();
+            std::lock_guard<std::mutex> lock(mutex_);
+            out_ = out;
+            std::string header(kBinaryLogMagic, sizeof(kBinaryLogMagic));
+            for (std::size_t id = 0; id < strings_.size(); ++id) {
+                append_string_def(header, static_cast<std::uint32_t>(id), strings_[id]);
+            }
+            for (std::size_t id = 0; id < formats_.size(); ++id) {
+                append_format_def(header, static_cast<std::uint32_t>(id), formats_[id]);
+            }
+            std::fwrite(header.data(), 1, header.size(), out_);
+            binary_log_enabled.store(true, std::memory_order_release);
+            active_log_sink.store(&kSink, std::memory_order_release);
+        }
+
+        void disable() {
+            if (!binary_log_enabled.exchange(false, std::memory_order_acq_rel)) {
+                return;
+            }
+            const LogSink* expected = &kSink;
+            active_log_sink.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+            flush();
+            std::lock_guard<std::mutex> lock(mutex_);
+            out_ = nullptr;
+        }
+
+        // Writes every thread's staged events and flushes the stream.
+        void flush() {
+            std::vector<std::shared_ptr<BinaryLogBuffer>> buffers;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                buffers = buffers_;
+            }
+            for (const auto& buffer : buffers) {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                write_buffer(*buffer);
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (out_ != nullptr) {
+                std::fflush(out_);
+            }
+        }
+
+        std::uint32_t register_format(const char* level, const char* format, std::string signature) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto id = static_cast<std::uint32_t>(formats_.size());
+            formats_.push_back(FormatDef{level, format, std::move(signature)});
+            if (out_ != nullptr) {
+                std::string def;
+                append_format_def(def, id, formats_.back());
+                std::fwrite(def.data(), 1, def.size(), out_);
+            }
+            return id;
+        }
+
+        std::uint32_t intern(std::string_view text) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto found = string_ids_.find(std::string(text));
+            if (found != string_ids_.end()) {
+                return found->second;
+            }
+            const auto id = static_cast<std::uint32_t>(strings_.size());
+            strings_.emplace_back(text);
+            string_ids_.emplace(strings_.back(), id);
+            if (out_ != nullptr) {
+                std::string def;
+                append_string_def(def, id, text);
+                std::fwrite(def.data(), 1, def.size(), out_);
+            }
+            return id;
+        }
+
+        // Most call sites pass the same few literals; a direct-mapped per-thread
+        // cache keyed by address keeps the registry lock off the hot path.
+        std::uint32_t intern_cached(InternedString string) {
+            struct Entry {
+                const char* data = nullptr;
+                std::size_t size = 0;
+                std::uint32_t id = 0;
+            };
+            thread_local Entry cache[64];
+            auto& entry = cache[(reinterpret_cast<std::uintptr_t>(string.text.data()) >> 3) % 64];
+            if (entry.data != string.text.data() || entry.size != string.text.size()) {
+                entry = Entry{string.text.data(), string.text.size(), intern(string.text)};
+            }
+            return entry.id;
+        }
+
+        template <typename... Args>
+        void write_event(std::uint32_t format_id, const Args&... args) {
+            BinaryLogBuffer& buffer = this_thread_buffer();
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            const std::size_t bound = 1 + 10 + (0 + ... + arg_bound(args));
+            if (buffer.size + bound > kBinaryLogBufferBytes) {
+                write_buffer(buffer);
+            }
+            char* out = buffer.data + buffer.size;
+            *out++ = 'E';
+            out = put_varint(out, format_id);
+            ((out = encode_arg(out, args)), ...);
+            buffer.size = static_cast<std::size_t>(out - buffer.data);
+        }
+
+    private:
+        BinaryLogger() = default;
+
+        struct FormatDef {
+            std::string level;
+            std::string format;
+            std::string signature;
+        };
+
+        struct BufferHandle {
+            std::shared_ptr<BinaryLogBuffer> buffer;
+
+            ~BufferHandle() {
+                if (buffer) {
+                    instance().retire(buffer);
+                }
+            }
+        };
+
+        static void sink_line(const char* level, std::string_view msg);
+        static void sink_call(const char* file, int line, const char* func, const char* expr, std::size_t depth);
+
+        static constexpr LogSink kSink{&sink_line, &sink_call};
+
+        static void append_string_def(std::string& out, std::uint32_t id, std::string_view text) {
+            out.push_back('S');
+            append_varint(out, id);
+            append_text(out, text);
+        }
+
+        static void append_format_def(std::string& out, std::uint32_t id, const FormatDef& def) {
+            out.push_back('F');
+            append_varint(out, id);
+            append_text(out, def.level);
+            append_text(out, def.signature);
+            append_text(out, def.format);
+        }
+
+        template <typename T>
+        static std::size_t arg_bound(const T& arg) {
+            if constexpr (binary_arg_code<T>() == 't') {
+                return 10 + std::min(std::string_view(arg).size(), kBinaryLogMaxText);
+            } else {
+                return 10;
+            }
+        }
+
+        template <typename T>
+        char* encode_arg(char* out, const T& arg) {
+            constexpr char code = binary_arg_code<T>();
+            if constexpr (code == 's') {
+                return put_varint(out, intern_cached(arg));
+            } else if constexpr (code == 'i') {
+                if constexpr (IsDuration<T>::value) {
+                    return put_varint(out, zigzag(static_cast<std::int64_t>(arg.count())));
+                } else {
+                    return put_varint(out, zigzag(static_cast<std::int64_t>(arg)));
+                }
+            } else if constexpr (code == 'u') {
+                return put_varint(out, static_cast<std::uint64_t>(arg));
+            } else if constexpr (code == 'd') {
+                const double value = static_cast<double>(arg);
+                std::memcpy(out, &value, sizeof(value));
+                return out + sizeof(value);
+            } else {
+                const std::string_view text(arg);
+                const std::size_t size = std::min(text.size(), kBinaryLogMaxText);
+                out = put_varint(out, size);
+                std::memcpy(out, text.data(), size);
+                return out + size;
+            }
+        }
+
+        BinaryLogBuffer& this_thread_buffer() {
+            thread_local BufferHandle handle;
+            if (!handle.buffer) {
+                handle.buffer = std::make_shared<BinaryLogBuffer>();
+                std::lock_guard<std::mutex> lock(mutex_);
+                buffers_.push_back(handle.buffer);
+            }
+            return *handle.buffer;
+        }
+
+        // Caller holds buffer.mutex.
+        void write_buffer(BinaryLogBuffer& buffer) {
+            if (buffer.size == 0) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (out_ != nullptr) {
+                std::fwrite(buffer.data, 1, buffer.size, out_);
+            }
+            buffer.size = 0;
+        }
+
+        void retire(const std::shared_ptr<BinaryLogBuffer>& buffer) {
+            {
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                write_buffer(*buffer);
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers_.erase(std::remove(buffers_.begin(), buffers_.end(), buffer), buffers_.end());
+        }
+
+        std::mutex mutex_;
+        std::FILE* out_ = nullptr;
+        std::vector<FormatDef> formats_;
+        std::vector<std::string> strings_;
+        std::unordered_map<std::string, std::uint32_t> string_ids_;
+        std::vector<std::shared_ptr<BinaryLogBuffer>> buffers_;
+    };
+
+    // Site is a captureless lambda returning a BinaryLogSite; its unique type gives
+    // every call site its own format id, registered on first use.
+    template <typename Site, typename... Args>
+    void binary_log_at(Site site, const Args&... args) {
+        static const std::uint32_t format_id = [&site] {
+            const BinaryLogSite info = site();
+            return BinaryLogger::instance().register_format(
+                info.level, info.format, std::string{binary_arg_code<Args>()...});
+        }();
+        BinaryLogger::instance().write_event(format_id, args...);
+    }
+
+    inline void BinaryLogger::sink_line(const char* level, std::string_view msg) {
+        if (std::strcmp(level, "DEBUG") == 0) {
+            binary_log_at([] { return BinaryLogSite{"DEBUG", "{}"}; }, msg);
+        } else {
+            binary_log_at([] { return BinaryLogSite{"", "[{}] {}"}; }, InternedString{level}, msg);
+        }
+    }
+
+    inline void BinaryLogger::sink_call(
+        const char* file, int line, const char* func, const char* expr, std::size_t depth) {
+        binary_log_at([] { return BinaryLogSite{"CALL", "{:indent}{}:{} {} -> {}"}; }, depth, InternedString{file},
+            line, InternedString{func}, InternedString{expr});
+    }
+
+    inline bool binary_logging_active() noexcept { return binary_log_enabled.load(std::memory_order_relaxed); }
+
+    // Parses one varint; returns false past the end of the input.
+    inline bool read_varint(const char*& in, const char* end, std::uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; in != end && shift < 64; shift += 7) {
+            const auto byte = static_cast<unsigned char>(*in++);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool read_text(const char*& in, const char* end, std::string_view& text) {
+        std::uint64_t size = 0;
+        if (!read_varint(in, end, size) || static_cast<std::uint64_t>(end - in) < size) {
+            return false;
+        }
+        text = std::string_view(in, static_cast<std::size_t>(size));
+        in += size;
+        return true;
+    }
+} // namespace detail
+
+// Logs a structured event in the binary stream: format is registered once per
+// call site and only the raw arguments are written per call. "{}" marks each
+// argument in order; "{:duration}" prints a nanosecond count with a scaled unit.
+// A no-op while binary logging is disabled.
+#define HOT_UTILS_BINARY_LOG(level, format, ...)                                                                      \
+    do {                                                                                                              \
+        if (::hot_utils::detail::binary_logging_active()) {                                                           \
+            ::hot_utils::detail::binary_log_at(                                                                       \
+                [] { return ::hot_utils::detail::BinaryLogSite{level, format}; }, __VA_ARGS__);                       \
+        }                                                                                                             \
+    } while (false)
+
+// Switches every log path to the binary format written to out (opened in binary
+// mode). Structured events (CopyMoveLog, ScopedTimer) keep their arguments raw;
+// other lines are stored as text. Replaces any other active backend.
+inline void enable_binary_logging(std::FILE* out) {
+    detail::BinaryLogger::instance().enable(out);
+}
+
+// Writes pending events and restores synchronous text logging. Does not close the stream.
+inline void disable_binary_logging() {
+    detail::BinaryLogger::instance().disable();
+}
+
+inline bool binary_logging_enabled() noexcept {
+    return detail::binary_logging_active();
+}
+
+inline void flush_binary_log() {
+    detail::BinaryLogger::instance().flush();
+}
+
+// Turns a binary stream back into the lines the text backend writes. Returns
+// false, with a reason in error when given, if the input is malformed.
+inline bool decode_binary_log(std::string_view input, std::FILE* out, std::string* error = nullptr) {
+    struct Format {
+        std::string level;
+        std::string signature;
+        std::string format;
+    };
+    std::unordered_map<std::uint64_t, Format> formats;
+    std::unordered_map<std::uint64_t, std::string> strings;
+    const auto fail = [error](const char* reason) {
+        if (error != nullptr) {
+            *error = reason;
+        }
+        return false;
+    };
+
+    const char* in = input.data();
+    const char* const end = in + input.size();
+    const std::string_view magic(detail::kBinaryLogMagic, sizeof(detail::kBinaryLogMagic));
+    if (input.substr(0, magic.size()) != magic) {
+        return fail("missing binary log header");
+    }
+    std::string line;
+    std::string arg;
+    while (in != end) {
+        // Streams appended to the same file each start with their own header.
+        if (std::string_view(in, static_cast<std::size_t>(end - in)).substr(0, magic.size()) == magic) {
+            in += magic.size();
+            continue;
+        }
+        const char tag = *in++;
+        std::uint64_t id = 0;
+        if (!detail::read_varint(in, end, id)) {
+            return fail("truncated record id");
+        }
+        if (tag == 'S') {
+            std::string_view text;
+            if (!detail::read_text(in, end, text)) {
+                return fail("truncated string definition");
+            }
+            strings[id] = std::string(text);
+            continue;
+        }
+        if (tag == 'F') {
+            std::string_view level;
+            std::string_view signature;
+            std::string_view format;
+            if (!detail::read_text(in, end, level) || !detail::read_text(in, end, signature)
+                || !detail::read_text(in, end, format)) {
+                return fail("truncated format definition");
+            }
+            formats[id] = Format{std::string(level), std::string(signature), std::string(format)};
+            continue;
+        }
+        if (tag != 'E') {
+            return fail("unknown record tag");
+        }
+        const auto found = formats.find(id);
+        if (found == formats.end()) {
+            return fail("event references an undefined format");
+        }
+        const Format& format = found->second;
+        line.clear();
+        if (!format.level.empty()) {
+            line += "[" + format.level + "] ";
+        }
+        std::size_t next_arg = 0;
+        for (std::size_t pos = 0; pos < format.format.size();) {
+            const bool plain = format.format.compare(pos, 2, "{}") == 0;
+            const bool indent = !plain && format.format.compare(pos, 9, "{:indent}") == 0;
+            const bool duration = !plain && !indent && format.format.compare(pos, 11, "{:duration}") == 0;
+            if (!plain && !indent && !duration) {
+                line += format.format[pos++];
+                continue;
+            }
+            pos += plain ? 2 : indent ? 9 : 11;
+            if (next_arg >= format.signature.size()) {
+                return fail("format has more placeholders than arguments");
+            }
+            const char code = format.signature[next_arg++];
+            arg.clear();
+            std::uint64_t raw = 0;
+            if (code == 'd') {
+                if (end - in < static_cast<std::ptrdiff_t>(sizeof(double))) {
+                    return fail("truncated argument");
+                }
+                double value = 0.0;
+                std::memcpy(&value, in, sizeof(value));
+                in += sizeof(value);
+                char buf[32];
+                std::snprintf(buf, sizeof(buf), "%g", value);
+                arg = buf;
+            } else if (code == 't') {
+                std::string_view text;
+                if (!detail::read_text(in, end, text)) {
+                    return fail("truncated argument");
+                }
+                arg = std::string(text);
+            } else if (!detail::read_varint(in, end, raw)) {
+                return fail("truncated argument");
+            } else if (code == 's') {
+                const auto string = strings.find(raw);
+                if (string == strings.end()) {
+                    return fail("event references an undefined string");
+                }
+                arg = string->second;
+            } else if (code == 'i') {
+                arg = std::to_string(detail::unzigzag(raw));
+            } else {
+                arg = std::to_string(raw);
+            }
+            if (indent) {
+                line.append(static_cast<std::size_t>(std::stoll(arg)) * 2, ' ');
+            } else if (duration) {
+                char buf[32];
+                detail::format_duration(buf, sizeof(buf), std::stoll(arg));
+                line += buf;
+            } else {
+                line += arg;
+            }
+        }
+        line += '\n';
+        std::fwrite(line.data(), 1, line.size(), out);
+    }
+    return true;
+}
+
+// Reads the rest of in and decodes it.
+inline bool decode_binary_log(std::FILE* in, std::FILE* out, std::string* error = nullptr) {
+    std::string input;
+    char buf[1 << 14];
+    std::size_t read = 0;
+    while ((read = std::fread(buf, 1, sizeof(buf), in)) != 0) {
+        input.append(buf, read);
+    }
+    return decode_binary_log(std::string_view(input), out, error);
+}
+
+} // namespace hot_utils
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#define HOT_UTILS_HAS_THREAD_PINNING 1
+#else
+#define HOT_UTILS_HAS_THREAD_PINNING 0
+#endif
+
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+
+namespace hot_utils {
+
+struct ContentionOptions {
+    // Thread counts to measure; empty means 1, 2, 4, ... up to max_threads, and max_threads itself.
+    std::vector<std::size_t> thread_counts;
+    std::size_t max_threads = 0; // 0: std::thread::hardware_concurrency()
+    std::chrono::nanoseconds warmup = std::chrono::milliseconds(20);
+    std::chrono::nanoseconds duration = std::chrono::milliseconds(100); // the measured window
+    std::size_t batch = 64; // body calls between publishing the count and checking for the end
+    bool pin_threads = false; // thread i runs on the i-th CPU of the process affinity mask, wrapping around
+};
+
+// One thread count. Operations are body calls counted inside the common window.
+struct ContentionPoint {
+    std::size_t threads = 0;
+    double seconds = 0.0;
+    std::vector<std::uint64_t> operations; // per thread
+    double ops_per_second = 0.0;           // all threads together
+    double ns_per_op = 0.0;                // per thread: the cost one call sees
+    double speedup = 0.0;                  // throughput over the first point's
+    double efficiency = 0.0;               // speedup / threads, relative to the first point
+    double fairness = 0.0;                 // Jain's index: 1 when every thread did the same work
+    double min_share = 0.0;                // slowest thread's operations over the per-thread mean
+    bool pinned = false;
+};
+
+struct ContentionResult {
+    std::string name;
+    std::vector<ContentionPoint> points;
+};
+
+namespace detail {
+    inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ volatile("yield");
+#endif
+    }
+
+    // Spins, then yields, so it also completes with more threads than CPUs.
+    template <typename Done>
+    inline void spin_until(Done done) {
+        for (std::size_t spins = 0; !done(); ++spins) {
+            if (spins < 1024) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Releases all threads together once the last one arrives; reusable.
+    class SpinBarrier {
+    public:
+        explicit SpinBarrier(std::size_t count) noexcept
+            : count_(count) {}
+
+        void arrive_and_wait() noexcept {
+            const std::size_t generation = generation_.load(std::memory_order_acquire);
+            if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == count_) {
+                arrived_.store(0, std::memory_order_relaxed);
+                generation_.store(generation + 1, std::memory_order_release);
+                return;
+            }
+            spin_until([&] { return generation_.load(std::memory_order_acquire) != generation; });
+        }
+
+    private:
+        const std::size_t count_;
+        alignas(64) std::atomic<std::size_t> arrived_{0};
+        alignas(64) std::atomic<std::size_t> generation_{0};
+    };
+
+    // Pins the calling thread to the index-th CPU it may run on. False when unsupported or refused.
+    inline bool pin_this_thread(std::size_t index) noexcept {
+#if HOT_UTILS_HAS_THREAD_PINNING
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+            return false;
+        }
+        const std::size_t target = index % static_cast<std::size_t>(CPU_COUNT(&allowed));
+        for (std::size_t cpu = 0, seen = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &allowed) || seen++ != target) {
+                continue;
+            }
+            cpu_set_t one;
+            CPU_ZERO(&one);
+            CPU_SET(cpu, &one);
+            return pthread_setaffinity_np(pthread_self(), sizeof(one), &one) == 0;
+        }
+        return false;
+#else
+        (void)index;
+        return false;
+#endif
+    }
+
+    template <typename F>
+    inline void invoke_contention_body(F& body, std::size_t thread) {
+        if constexpr (std::is_invocable_v<F&, std::size_t>) {
+            if constexpr (std::is_void_v<std::invoke_result_t<F&, std::size_t>>) {
+                body(thread);
+                compiler_barrier();
+            } else {
+                do_not_optimize(body(thread));
+            }
+        } else {
+            invoke_benchmark_body(body);
+        }
+    }
+
+    inline std::vector<std::size_t> contention_thread_counts(const ContentionOptions& options) {
+        if (!options.thread_counts.empty()) {
+            return options.thread_counts;
+        }
+        const std::size_t max_threads = options.max_threads != 0
+            ? options.max_threads
+            : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        std::vector<std::size_t> counts;
+        for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+            counts.push_back(threads);
+        }
+        counts.push_back(max_threads);
+        return counts;
+    }
+
+    template <typename F>
+    ContentionPoint run_contention_point(F& body, std::size_t threads, const ContentionOptions& options) {
+        struct alignas(64) Counter {
+            std::atomic<std::uint64_t> operations{0};
+        };
+        std::vector<Counter> counters(threads);
+        std::atomic<bool> stop{false};
+        std::atomic<std::size_t> pinned{0};
+        SpinBarrier start(threads + 1);
+        const std::size_t batch = std::max<std::size_t>(options.batch, 1);
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                if (options.pin_threads && pin_this_thread(t)) {
+                    pinned.fetch_add(1, std::memory_order_relaxed);
+                }
+                start.arrive_and_wait();
+                std::uint64_t done = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    for (std::size_t i = 0; i < batch; ++i) {
+                        invoke_contention_body(body, t);
+                    }
+                    done += batch;
+                    counters[t].operations.store(done, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        // The controlling thread opens and closes one window for everyone by
+        // reading every count at its start and end.
+        start.arrive_and_wait();
+        std::this_thread::sleep_for(options.warmup);
+        std::vector<std::uint64_t> before(threads);
+        for (std::size_t t = 0; t < threads; ++t) {
+            before[t] = counters[t].operations.load(std::memory_order_relaxed);
+        }
+        const auto window_start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(options.duration);
+        ContentionPoint point;
+        point.threads = threads;
+        point.operations.resize(threads);
+        for (std::size_t t = 0; t < threads; ++t) {
+            point.operations[t] = counters[t].operations.load(std::memory_order_relaxed) - before[t];
+        }
+        const auto window_end = std::chrono::steady_clock::now();
+        stop.store(true, std::memory_order_relaxed);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        point.seconds = std::chrono::duration<double>(window_end - window_start).count();
+        point.pinned = options.pin_threads && pinned.load(std::memory_order_relaxed) == threads;
+        double total = 0.0;
+        double squares = 0.0;
+        double fewest = static_cast<double>(point.operations.front());
+        for (const std::uint64_t ops : point.operations) {
+            const double value = static_cast<double>(ops);
+            total += value;
+            squares += value * value;
+            fewest = std::min(fewest, value);
+        }
+        point.ops_per_second = point.seconds > 0.0 ? total / point.seconds : 0.0;
+        point.ns_per_op = total > 0.0 ? point.seconds * 1e9 * static_cast<double>(threads) / total : 0.0;
+        point.fairness = squares > 0.0 ? total * total / (static_cast<double>(threads) * squares) : 0.0;
+        point.min_share = total > 0.0 ? fewest * static_cast<double>(threads) / total : 0.0;
+        return point;
+    }
+} // namespace detail
+
+// Runs body on each thread count in turn. The threads start together on a
+// spinning barrier, run for options.warmup, and are then measured over one
+// common window of options.duration. body() or body(thread_index) is called
+// back to back; non-void results go through do_not_optimize.
+template <typename F>
+ContentionResult run_contention_benchmark(std::string name, F&& body, const ContentionOptions& options = {}) {
+    auto& fn = body;
+    ContentionResult result;
+    result.name = std::move(name);
+    for (const std::size_t threads : detail::contention_thread_counts(options)) {
+        result.points.push_back(detail::run_contention_point(fn, std::max<std::size_t>(threads, 1), options));
+    }
+    if (!result.points.empty() && result.points.front().ops_per_second > 0.0) {
+        const ContentionPoint& first = result.points.front();
+        for (auto& point : result.points) {
+            point.speedup = point.ops_per_second / first.ops_per_second;
+            point.efficiency = point.speedup * static_cast<double>(first.threads) / static_cast<double>(point.threads);
+        }
+    }
+    return result;
+}
+
+// The scalability curve: one row per thread count.
+inline void print_contention_results(const ContentionResult& result, std::FILE* out = stdout) {
+    std::fprintf(out, "%s\n%8s %14s %12s %9s %11s %9s %10s\n", result.name.c_str(), "threads", "Mops/s",
+        "ns/op/thread", "speedup", "efficiency", "fairness", "min share");
+    for (const auto& point : result.points) {
+        std::fprintf(out, "%8zu %14.2f %12.2f %9.2f %10.0f%% %9.3f %9.0f%%%s\n", point.threads,
+            point.ops_per_second / 1e6, point.ns_per_op, point.speedup, point.efficiency * 100.0, point.fairness,
+            point.min_share * 100.0, point.pinned ? "  pinned" : "");
+    }
+}
+
+// One BenchmarkResult per thread count, named "name/threads:N", for
+// print_benchmark_results and the JSON/CSV writers. The samples are the
+// per-thread ns/op; the curve figures are counters.
+inline std::vector<BenchmarkResult> contention_benchmark_results(const ContentionResult& result) {
+    std::vector<BenchmarkResult> out;
+    for (const auto& point : result.points) {
+        BenchmarkResult entry;
+        entry.name = result.name + "/threads:" + std::to_string(point.threads);
+        for (const std::uint64_t ops : point.operations) {
+            entry.iterations += static_cast<std::size_t>(ops);
+            entry.samples.push_back(ops != 0 ? point.seconds * 1e9 / static_cast<double>(ops) : 0.0);
+        }
+        entry.stats = compute_benchmark_stats(entry.samples);
+        entry.counters = {BenchmarkCounter{"ops_per_second", point.ops_per_second},
+            BenchmarkCounter{"speedup", point.speedup}, BenchmarkCounter{"fairness", point.fairness}};
+        out.push_back(std::move(entry));
+    }
+    return out;
+}
+
+} // namespace hot_utils
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "hot_utils/allocation_log.hpp"
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/log_utils.hpp"
+
+namespace hot_utils {
+
+using CopyMoveBudgetHandler = void (*)(std::string_view label, const std::string& report);
+
+namespace detail {
+    // Internal linkage for the same reason as report_unexpected_allocation: a
+    // translation unit that included gtest first fails the current test.
+    [[maybe_unused]] static void report_copy_move_budget_overrun(std::string_view label, const std::string& report) {
+        const std::string message = std::string(label.empty() ? "copy/move budget" : label) + " over budget:\n" + report;
+#if defined(GTEST_INCLUDE_GTEST_GTEST_H_) || defined(GOOGLETEST_INCLUDE_GTEST_GTEST_H_)
+        ADD_FAILURE() << message;
+#else
+        log_line("ERROR", message);
+        std::abort();
+#endif
+    }
+
+    inline void append_budget_figure(std::string& out, const char* what, std::size_t used, std::size_t limit) {
+        char buf[96];
+        if (limit == std::numeric_limits<std::size_t>::max()) {
+            std::snprintf(buf, sizeof(buf), "%s %zu", what, used);
+        } else {
+            std::snprintf(buf, sizeof(buf), "%s %zu/%zu%s", what, used, limit, used > limit ? " OVER" : "");
+        }
+        out += buf;
+    }
+} // namespace detail
+
+// Performance contract for a scope: at most so many copies and moves of each
+// listed wrapper type, and at most so many heap allocations. Checked when the
+// scope ends; an overrun goes to the handler with a per-type diff. The default
+// handler adds a gtest failure in tests (include gtest first) and aborts elsewhere.
+//
+//     hot_utils::CopyMoveBudget budget("push_back");
+//     budget.limit<hot_utils::CopyMoveLog<Matrix>>(0, 1).max_allocations(0);
+//
+// Copies and moves are read from the wrappers' global counters, so they include
+// every thread: join or synchronize with the workers before the scope ends, and
+// expect other threads copying the same type to be charged too. Allocations are
+// this thread's only and need HOT_UTILS_DEFINE_ALLOCATION_HOOKS for plain new.
+// Budgets nest; an inner scope's usage also counts against the outer one.
+class CopyMoveBudget {
+public:
+    static constexpr std::size_t kUnlimited = std::numeric_limits<std::size_t>::max();
+    static constexpr std::size_t kMaxTypes = 8;
+
+    explicit CopyMoveBudget(
+        std::string_view label = "", CopyMoveBudgetHandler handler = &detail::report_copy_move_budget_overrun)
+        : label_(label)
+        , handler_(handler) {
+        allocations_.parent = detail::allocation_scope;
+        detail::allocation_scope = &allocations_;
+    }
+
+    CopyMoveBudget(const CopyMoveBudget&) = delete;
+    CopyMoveBudget& operator=(const CopyMoveBudget&) = delete;
+
+    ~CopyMoveBudget() {
+        if (detail::allocation_scope == &allocations_) {
+            detail::allocation_scope = allocations_.parent;
+        }
+        if (!within_budget() && handler_ != nullptr) {
+            handler_(label_, report());
+        }
+    }
+
+    // Limits Wrapper, e.g. CopyMoveLog<Matrix>, from this call on. Copies are
+    // copy construction plus copy assignment, moves likewise. Does not allocate.
+    // Limits past kMaxTypes cannot be checked, so they put the budget over.
+    template <class Wrapper>
+    CopyMoveBudget& limit(std::size_t max_copies, std::size_t max_moves = kUnlimited) {
+        if (type_count_ == kMaxTypes) {
+            ++dropped_types_;
+            return *this;
+        }
+        types_[type_count_++] =
+            TypeBudget{&detail::type_name<Wrapper>, &Wrapper::counts, Wrapper::counts(), max_copies, max_moves};
+        return *this;
+    }
+
+    // Heap allocations on this thread while in scope.
+    CopyMoveBudget& max_allocations(std::size_t max) noexcept {
+        max_allocations_ = max;
+        return *this;
+    }
+
+    bool within_budget() const noexcept {
+        if (dropped_types_ != 0) {
+            return false;
+        }
+        for (std::size_t i = 0; i < type_count_; ++i) {
+            const LogCounts used = types_[i].used();
+            if (copies(used) > types_[i].max_copies || moves(used) > types_[i].max_moves) {
+                return false;
+            }
+        }
+        return allocations() <= max_allocations_;
+    }
+
+    // One line per limit: "CopyMoveLog<int>: copies 3/1 OVER (copy_ctor +2,
+    // copy_assign +1), moves 0/2". Allocates, so call it after the checked code.
+    std::string report() const {
+        std::string out;
+        char buf[128];
+        for (std::size_t i = 0; i < type_count_; ++i) {
+            const TypeBudget& type = types_[i];
+            const LogCounts used = type.used();
+            out += "  " + type.name() + ": ";
+            detail::append_budget_figure(out, "copies", copies(used), type.max_copies);
+            std::snprintf(buf, sizeof(buf), " (copy_ctor +%zu, copy_assign +%zu), ", used.copy_ctor, used.copy_assign);
+            out += buf;
+            detail::append_budget_figure(out, "moves", moves(used), type.max_moves);
+            std::snprintf(buf, sizeof(buf), " (move_ctor +%zu, move_assign +%zu)\n", used.move_ctor, used.move_assign);
+            out += buf;
+        }
+        if (dropped_types_ != 0) {
+            std::snprintf(buf, sizeof(buf), "  limits not checked: %zu (at most %zu types per budget)\n",
+                dropped_types_, kMaxTypes);
+            out += buf;
+        }
+        if (max_allocations_ != kUnlimited) {
+            out += "  heap: ";
+            detail::append_budget_figure(out, "allocations", allocations(), max_allocations_);
+            std::snprintf(buf, sizeof(buf), " (%llu bytes)\n",
+                static_cast<unsigned long long>(allocations_.stats.bytes_allocated));
+            out += buf;
+        }
+        return out;
+    }
+
+private:
+    struct TypeBudget {
+        const std::string& (*name)() = nullptr;
+        LogCounts (*counts)() = nullptr;
+        LogCounts start;
+        std::size_t max_copies = kUnlimited;
+        std::size_t max_moves = kUnlimited;
+
+        LogCounts used() const noexcept {
+            const LogCounts now = counts();
+            return LogCounts{now.copy_ctor - start.copy_ctor, now.copy_assign - start.copy_assign,
+                now.move_ctor - start.move_ctor, now.move_assign - start.move_assign};
+        }
+    };
+
+    static std::size_t copies(const LogCounts& counts) noexcept { return counts.copy_ctor + counts.copy_assign; }
+    static std::size_t moves(const LogCounts& counts) noexcept { return counts.move_ctor + counts.move_assign; }
+
+    std::size_t allocations() const noexcept { return static_cast<std::size_t>(allocations_.stats.allocations); }
+
+    std::string_view label_;
+    CopyMoveBudgetHandler handler_;
+    std::array<TypeBudget, kMaxTypes> types_{};
+    std::size_t type_count_ = 0;
+    std::size_t dropped_types_ = 0;
+    std::size_t max_allocations_ = kUnlimited;
+    detail::AllocationScopeState allocations_;
+};
+
+} // namespace hot_utils
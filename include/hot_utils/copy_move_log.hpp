@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstdio>
 #include <string>
@@ -9,11 +11,9 @@
 #include <type_traits>
 #include <typeinfo>
 #include <utility>
+#include <vector>
 
-#if defined(__GNUG__)
-#include <cxxabi.h>
-#endif
-
+#include "hot_utils/binary_log.hpp"
 #include "hot_utils/log_utils.hpp"
 
 namespace hot_utils {
@@ -25,12 +25,232 @@ struct LogCounts {
     std::size_t move_assign = 0;
 };
 
+// Where a copy or move happened. As a defaulted constructor argument, current()
+// captures the line that asked for the copy, like std::source_location in C++20.
+struct CallSite {
+    const char* file = nullptr;
+    int line = 0;
+
+#if defined(__GNUC__) || defined(__clang__)
+    static constexpr CallSite current(const char* file = __builtin_FILE(), int line = __builtin_LINE()) noexcept {
+        return CallSite{file, line};
+    }
+#else
+    static constexpr CallSite current() noexcept { return CallSite{}; }
+#endif
+};
+
+// One type's totals in the copy/move report.
+struct CopyMoveTypeStats {
+    std::string type; // e.g. "CopyMoveLog<Matrix>"
+    std::size_t size = 0;
+    LogCounts counts;
+};
+
+// One call site's totals. bytes is count * sizeof(T), the shallow size copied or moved.
+struct CopySiteStats {
+    std::string type;
+    const char* action = "";
+    const char* file = nullptr; // null for assignments, which cannot see their caller
+    int line = 0;
+    const char* tag = nullptr;  // innermost CopySiteTag at the time, if any
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+};
+
+// LifetimeLog<T> counters at one point in time; subtract two with lifetime_delta.
+struct LifetimeCounts {
+    std::size_t default_ctor = 0;
+    std::size_t value_ctor = 0;
+    std::size_t copy_ctor = 0;
+    std::size_t move_ctor = 0;
+    std::size_t copy_assign = 0;
+    std::size_t move_assign = 0;
+    std::size_t destroyed = 0;
+    std::int64_t live = 0;
+    std::int64_t peak_live = 0;
+    std::size_t object_size = 0; // sizeof(T)
+
+    std::size_t constructed() const noexcept { return default_ctor + value_ctor + copy_ctor + move_ctor; }
+    std::size_t peak_bytes() const noexcept {
+        return object_size * static_cast<std::size_t>(std::max<std::int64_t>(peak_live, 0));
+    }
+};
+
+// Churn between two snapshots of the same type: event counts and live become
+// differences, and peak_live the peak's rise above before.live. Call
+// reset_peak() when taking before to get the peak of the window itself.
+inline LifetimeCounts lifetime_delta(const LifetimeCounts& before, const LifetimeCounts& after) {
+    LifetimeCounts out;
+    out.default_ctor = after.default_ctor - before.default_ctor;
+    out.value_ctor = after.value_ctor - before.value_ctor;
+    out.copy_ctor = after.copy_ctor - before.copy_ctor;
+    out.move_ctor = after.move_ctor - before.move_ctor;
+    out.copy_assign = after.copy_assign - before.copy_assign;
+    out.move_assign = after.move_assign - before.move_assign;
+    out.destroyed = after.destroyed - before.destroyed;
+    out.live = after.live - before.live;
+    out.peak_live = std::max<std::int64_t>(after.peak_live - before.live, 0);
+    out.object_size = after.object_size;
+    return out;
+}
+
 namespace detail {
+    enum CopyMoveCounter : std::size_t { kCopyCtor, kCopyAssign, kMoveCtor, kMoveAssign, kCopyMoveCounters };
+
+    inline constexpr std::size_t kCounterShards = 64;
+
+    inline std::atomic<std::size_t> next_counter_shard{0};
+    // Constant-initialized, so reading it needs no thread_local init guard.
+    inline thread_local std::size_t this_thread_counter_shard = kCounterShards;
+
+    // Shard of the calling thread, handed out round robin on first use.
+    inline std::size_t counter_shard() noexcept {
+        std::size_t shard = this_thread_counter_shard;
+        if (shard == kCounterShards) {
+            shard = next_counter_shard.fetch_add(1, std::memory_order_relaxed) % kCounterShards;
+            this_thread_counter_shard = shard;
+        }
+        return shard;
+    }
+
+    // Copy/move counters split into cache-line shards so threads copying
+    // concurrently do not fight over one line. Increments are relaxed; reads sum
+    // the shards and are exact once the counting threads are synchronized with
+    // the reader (e.g. joined).
+    class ShardedCopyMoveCounts {
+    public:
+        void increment(CopyMoveCounter counter) noexcept {
+            shards_[counter_shard()].values[counter].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::size_t load(CopyMoveCounter counter) const noexcept {
+            std::size_t total = 0;
+            for (const auto& shard : shards_) {
+                total += shard.values[counter].load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        LogCounts counts() const noexcept {
+            return LogCounts{load(kCopyCtor), load(kCopyAssign), load(kMoveCtor), load(kMoveAssign)};
+        }
+
+        void reset() noexcept {
+            for (auto& shard : shards_) {
+                for (auto& value : shard.values) {
+                    value.store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        struct alignas(64) Shard {
+            std::atomic<std::size_t> values[kCopyMoveCounters];
+        };
+
+        Shard shards_[kCounterShards]{};
+    };
+
+    enum LifetimeCounter : std::size_t { kDefaultCtor, kValueCtor, kDestroyed, kLifetimeCounters };
+
+    // Live objects a shard may hold back before folding them into the shared count.
+    inline constexpr std::int64_t kLiveBatch = 32;
+
+    // Construction and destruction counters sharded like ShardedCopyMoveCounts.
+    // Each shard also keeps its unfolded live delta, so live is exact once the
+    // counting threads are synchronized with the reader. The peak is kept from
+    // the shared count plus the calling shard's delta: exact on one thread, and
+    // it may miss up to kLiveBatch objects per other concurrently active thread.
+    class ShardedLifetimeCounts {
+    public:
+        // Copies and moves: counted by ShardedCopyMoveCounts, only live here.
+        void constructed() noexcept { add_live(shards_[counter_shard()], 1); }
+
+        void constructed(LifetimeCounter kind) noexcept {
+            Shard& shard = shards_[counter_shard()];
+            shard.values[kind].fetch_add(1, std::memory_order_relaxed);
+            add_live(shard, 1);
+        }
+
+        void destroyed() noexcept {
+            Shard& shard = shards_[counter_shard()];
+            shard.values[kDestroyed].fetch_add(1, std::memory_order_relaxed);
+            add_live(shard, -1);
+        }
+
+        std::size_t load(LifetimeCounter counter) const noexcept {
+            std::size_t total = 0;
+            for (const auto& shard : shards_) {
+                total += shard.values[counter].load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        std::int64_t live() const noexcept {
+            std::int64_t total = shared_.folded.load(std::memory_order_relaxed);
+            for (const auto& shard : shards_) {
+                total += shard.pending.load(std::memory_order_relaxed);
+            }
+            return total;
+        }
+
+        std::int64_t peak() const noexcept { return std::max(shared_.peak.load(std::memory_order_relaxed), live()); }
+
+        void reset_peak() noexcept { shared_.peak.store(live(), std::memory_order_relaxed); }
+
+        // Zeroes the event counts. Objects alive now stay counted as live.
+        void reset() noexcept {
+            for (auto& shard : shards_) {
+                for (auto& value : shard.values) {
+                    value.store(0, std::memory_order_relaxed);
+                }
+            }
+            reset_peak();
+        }
+
+    private:
+        struct alignas(64) Shard {
+            std::atomic<std::size_t> values[kLifetimeCounters];
+            std::atomic<std::int64_t> pending; // live delta not yet folded into shared_.folded
+        };
+
+        // Written once per kLiveBatch objects per thread and on new peaks.
+        struct alignas(64) Shared {
+            std::atomic<std::int64_t> folded{0};
+            std::atomic<std::int64_t> peak{0};
+        };
+
+        void add_live(Shard& shard, std::int64_t delta) noexcept {
+            const std::int64_t pending = shard.pending.fetch_add(delta, std::memory_order_relaxed) + delta;
+            if (delta > 0) {
+                const std::int64_t estimate = shared_.folded.load(std::memory_order_relaxed) + pending;
+                std::int64_t peak = shared_.peak.load(std::memory_order_relaxed);
+                while (estimate > peak
+                    && !shared_.peak.compare_exchange_weak(peak, estimate, std::memory_order_relaxed)) {
+                }
+            }
+            if (pending >= kLiveBatch || pending <= -kLiveBatch) {
+                shared_.folded.fetch_add(shard.pending.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+
+        Shard shards_[kCounterShards]{};
+        Shared shared_;
+    };
+
     inline void log_action(std::string_view type, std::string_view action) {
+        if (!log_enabled<LogLevel::Debug>(log_categories::copy_move)) {
+            return;
+        }
+        if (binary_logging_active()) {
+            binary_log_at([] { return BinaryLogSite{"DEBUG", "{}: {}"}; }, type, action);
+            return;
+        }
         char buf[128];
         std::snprintf(buf, sizeof(buf), "%.*s: %.*s", static_cast<int>(type.size()), type.data(),
             static_cast<int>(action.size()), action.data());
-        log_debug(buf);
+        log_line("DEBUG", buf);
     }
 
     inline void strip_hot_utils_namespace(std::string& type) {
@@ -44,30 +264,176 @@ namespace detail {
     template <typename T>
     inline const std::string& type_name() {
         static const std::string name = [] {
-#if defined(__GNUG__)
-            int status = 0;
-            const char* const raw = typeid(T).name();
-            char* const demangled = abi::__cxa_demangle(raw, nullptr, nullptr, &status);
-            std::string out = (status == 0 && demangled != nullptr) ? demangled : raw;
-            std::free(demangled);
-            strip_hot_utils_namespace(out);
-            return out;
-#else
-            std::string out = typeid(T).name();
+            std::string out = demangle(typeid(T).name());
             strip_hot_utils_namespace(out);
             return out;
-#endif
         }();
         return name;
     }
 
+    // wrapper and action are literals; the binary log records them by id.
     template <typename T>
-    inline void log_action_for(std::string_view wrapper, std::string_view action) {
+    inline void log_action_for(const char* wrapper, const char* action) {
+        if (!log_enabled<LogLevel::Debug>(log_categories::copy_move)) {
+            return;
+        }
         const auto& type = type_name<T>();
+        if (binary_logging_active()) {
+            binary_log_at([] { return BinaryLogSite{"DEBUG", "{}<{}>: {}"}; }, InternedString{wrapper},
+                InternedString{type}, InternedString{action});
+            return;
+        }
         char buf[256];
-        std::snprintf(buf, sizeof(buf), "%.*s<%.*s>: %.*s", static_cast<int>(wrapper.size()), wrapper.data(),
-            static_cast<int>(type.size()), type.data(), static_cast<int>(action.size()), action.data());
-        log_debug(buf);
+        std::snprintf(buf, sizeof(buf), "%s<%s>: %s", wrapper, type.c_str(), action);
+        log_line("DEBUG", buf);
+    }
+
+    inline const char* copy_move_action_name(CopyMoveCounter action) noexcept {
+        static constexpr const char* names[kCopyMoveCounters] = {"copy_ctor", "copy_assign", "move_ctor", "move_assign"};
+        return names[action];
+    }
+
+    // Registry entry of one instantiated wrapper, e.g. CopyMoveLog<Matrix>.
+    // Constant-initialized; linked into the registry on its first copy or move.
+    struct CopyMoveType {
+        constexpr CopyMoveType(const char* wrapper, const std::string& (*type)(), std::size_t size,
+            const ShardedCopyMoveCounts* counts) noexcept
+            : wrapper(wrapper)
+            , type(type)
+            , size(size)
+            , counts(counts) {}
+
+        std::string name() const { return std::string(wrapper) + "<" + type() + ">"; }
+
+        const char* const wrapper;
+        const std::string& (*const type)();
+        const std::size_t size;
+        const ShardedCopyMoveCounts* const counts;
+        std::atomic<bool> registered{false};
+        CopyMoveType* next = nullptr;
+    };
+
+    inline std::atomic<CopyMoveType*> copy_move_types{nullptr};
+
+    inline void register_copy_move_type(CopyMoveType& type) noexcept {
+        if (type.registered.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        CopyMoveType* head = copy_move_types.load(std::memory_order_relaxed);
+        do {
+            type.next = head;
+        } while (!copy_move_types.compare_exchange_weak(head, &type, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    inline std::atomic<bool> copy_sites_on{false};
+    inline thread_local const char* copy_site_tag = nullptr;
+
+    // Fixed-size open-addressing table of (type, action, site, tag) counters.
+    // A slot is claimed by CAS on its hash, filled, then published with ready;
+    // counting never locks or allocates. Sites beyond capacity are counted as
+    // overflow.
+    class CopySiteTable {
+    public:
+        static constexpr std::size_t kCapacity = 4096;
+
+        static CopySiteTable& instance() noexcept {
+            static CopySiteTable table;
+            return table;
+        }
+
+        void record(const CopyMoveType& type, CopyMoveCounter action, const CallSite& site, const char* tag) noexcept {
+            const std::uint64_t hash = hash_key(type, action, site, tag);
+            for (std::size_t probe = 0; probe < kCapacity; ++probe) {
+                Slot& slot = slots_[(hash + probe) & (kCapacity - 1)];
+                std::uint64_t current = slot.hash.load(std::memory_order_acquire);
+                if (current == 0) {
+                    if (slot.hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel)) {
+                        slot.type = &type;
+                        slot.action = action;
+                        slot.site = site;
+                        slot.tag = tag;
+                        slot.ready.store(true, std::memory_order_release);
+                        slot.count.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+                if (current != hash) {
+                    continue;
+                }
+                while (!slot.ready.load(std::memory_order_acquire)) {
+                }
+                if (slot.type == &type && slot.action == action && slot.site.file == site.file
+                    && slot.site.line == site.line && slot.tag == tag) {
+                    slot.count.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+            }
+            overflow_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template <typename Visit>
+        void for_each(Visit&& visit) const {
+            for (const Slot& slot : slots_) {
+                if (slot.hash.load(std::memory_order_acquire) != 0 && slot.ready.load(std::memory_order_acquire)) {
+                    visit(*slot.type, slot.action, slot.site, slot.tag, slot.count.load(std::memory_order_relaxed));
+                }
+            }
+        }
+
+        std::uint64_t overflow() const noexcept { return overflow_.load(std::memory_order_relaxed); }
+
+        // Not safe against concurrent record().
+        void reset() noexcept {
+            for (Slot& slot : slots_) {
+                slot.ready.store(false, std::memory_order_relaxed);
+                slot.count.store(0, std::memory_order_relaxed);
+                slot.hash.store(0, std::memory_order_release);
+            }
+            overflow_.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        struct Slot {
+            std::atomic<std::uint64_t> hash{0}; // 0 while empty
+            std::atomic<bool> ready{false};
+            const CopyMoveType* type = nullptr;
+            CopyMoveCounter action = kCopyCtor;
+            CallSite site;
+            const char* tag = nullptr;
+            std::atomic<std::uint64_t> count{0};
+        };
+
+        // Pointers are stable, so identity hashing is enough: files and tags are literals.
+        static std::uint64_t hash_key(
+            const CopyMoveType& type, CopyMoveCounter action, const CallSite& site, const char* tag) noexcept {
+            std::uint64_t h = 0xcbf29ce484222325ull;
+            const auto mix = [&h](std::uint64_t value) {
+                h ^= value;
+                h *= 0x100000001b3ull;
+                h ^= h >> 29;
+            };
+            mix(reinterpret_cast<std::uintptr_t>(&type));
+            mix(action);
+            mix(reinterpret_cast<std::uintptr_t>(site.file));
+            mix(static_cast<std::uint64_t>(site.line));
+            mix(reinterpret_cast<std::uintptr_t>(tag));
+            return h | 1;
+        }
+
+        Slot slots_[kCapacity];
+        std::atomic<std::uint64_t> overflow_{0};
+    };
+
+    // The counting path shared by the wrappers.
+    inline void count_copy_move(
+        ShardedCopyMoveCounts& counts, CopyMoveType& type, CopyMoveCounter action, const CallSite& site) noexcept {
+        counts.increment(action);
+        if (!type.registered.load(std::memory_order_relaxed)) {
+            register_copy_move_type(type);
+        }
+        if (copy_sites_on.load(std::memory_order_relaxed)) {
+            CopySiteTable::instance().record(type, action, site, copy_site_tag);
+        }
     }
 } // namespace detail
 
@@ -80,26 +446,23 @@ public:
     explicit CopyLog(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
         : value_(std::move(value)) {}
 
-    CopyLog(const CopyLog& other)
+    CopyLog(const CopyLog& other, CallSite site = CallSite::current())
         : value_(other.value_) {
-        ++copy_ctor_;
+        detail::count_copy_move(counts_, type_, detail::kCopyCtor, site);
         detail::log_action_for<T>("CopyLog", "copy_ctor");
     }
     CopyLog& operator=(const CopyLog& other) {
         value_ = other.value_;
-        ++copy_assign_;
+        detail::count_copy_move(counts_, type_, detail::kCopyAssign, CallSite{});
         detail::log_action_for<T>("CopyLog", "copy_assign");
         return *this;
     }
     CopyLog(CopyLog&&) = delete;
     CopyLog& operator=(CopyLog&&) = delete;
 
-    static void reset() {
-        copy_ctor_ = 0;
-        copy_assign_ = 0;
-    }
+    static void reset() { counts_.reset(); }
 
-    static LogCounts counts() { return LogCounts{copy_ctor_.load(), copy_assign_.load(), 0, 0}; }
+    static LogCounts counts() { return counts_.counts(); }
 
     T& value() & { return value_; }
     const T& value() const & { return value_; }
@@ -107,8 +470,8 @@ public:
 
 private:
     T value_{};
-    inline static std::atomic<std::size_t> copy_ctor_{0};
-    inline static std::atomic<std::size_t> copy_assign_{0};
+    inline static detail::ShardedCopyMoveCounts counts_;
+    inline static detail::CopyMoveType type_{"CopyLog", &detail::type_name<T>, sizeof(T), &counts_};
 };
 
 template <typename T = int>
@@ -120,26 +483,23 @@ public:
     explicit MoveLog(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
         : value_(std::move(value)) {}
 
-    MoveLog(MoveLog&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    MoveLog(MoveLog&& other, CallSite site = CallSite::current()) noexcept(std::is_nothrow_move_constructible_v<T>)
         : value_(std::move(other.value_)) {
-        ++move_ctor_;
+        detail::count_copy_move(counts_, type_, detail::kMoveCtor, site);
         detail::log_action_for<T>("MoveLog", "move_ctor");
     }
     MoveLog& operator=(MoveLog&& other) noexcept(std::is_nothrow_move_assignable_v<T>) {
         value_ = std::move(other.value_);
-        ++move_assign_;
+        detail::count_copy_move(counts_, type_, detail::kMoveAssign, CallSite{});
         detail::log_action_for<T>("MoveLog", "move_assign");
         return *this;
     }
     MoveLog(const MoveLog&) = delete;
     MoveLog& operator=(const MoveLog&) = delete;
 
-    static void reset() {
-        move_ctor_ = 0;
-        move_assign_ = 0;
-    }
+    static void reset() { counts_.reset(); }
 
-    static LogCounts counts() { return LogCounts{0, 0, move_ctor_.load(), move_assign_.load()}; }
+    static LogCounts counts() { return counts_.counts(); }
 
     T& value() & { return value_; }
     const T& value() const & { return value_; }
@@ -147,8 +507,8 @@ public:
 
 private:
     T value_{};
-    inline static std::atomic<std::size_t> move_ctor_{0};
-    inline static std::atomic<std::size_t> move_assign_{0};
+    inline static detail::ShardedCopyMoveCounts counts_;
+    inline static detail::CopyMoveType type_{"MoveLog", &detail::type_name<T>, sizeof(T), &counts_};
 };
 
 template <typename T = int>
@@ -160,38 +520,112 @@ public:
     explicit CopyMoveLog(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
         : value_(std::move(value)) {}
 
-    CopyMoveLog(const CopyMoveLog& other)
+    CopyMoveLog(const CopyMoveLog& other, CallSite site = CallSite::current())
         : value_(other.value_) {
-        ++copy_ctor_;
+        detail::count_copy_move(counts_, type_, detail::kCopyCtor, site);
         detail::log_action_for<T>("CopyMoveLog", "copy_ctor");
     }
     CopyMoveLog& operator=(const CopyMoveLog& other) {
         value_ = other.value_;
-        ++copy_assign_;
+        detail::count_copy_move(counts_, type_, detail::kCopyAssign, CallSite{});
         detail::log_action_for<T>("CopyMoveLog", "copy_assign");
         return *this;
     }
-    CopyMoveLog(CopyMoveLog&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    CopyMoveLog(CopyMoveLog&& other, CallSite site = CallSite::current()) noexcept(std::is_nothrow_move_constructible_v<T>)
         : value_(std::move(other.value_)) {
-        ++move_ctor_;
+        detail::count_copy_move(counts_, type_, detail::kMoveCtor, site);
         detail::log_action_for<T>("CopyMoveLog", "move_ctor");
     }
     CopyMoveLog& operator=(CopyMoveLog&& other) noexcept(std::is_nothrow_move_assignable_v<T>) {
         value_ = std::move(other.value_);
-        ++move_assign_;
+        detail::count_copy_move(counts_, type_, detail::kMoveAssign, CallSite{});
         detail::log_action_for<T>("CopyMoveLog", "move_assign");
         return *this;
     }
 
+    static void reset() { counts_.reset(); }
+
+    static LogCounts counts() { return counts_.counts(); }
+
+    T& value() & { return value_; }
+    const T& value() const & { return value_; }
+    T&& value() && { return std::move(value_); }
+
+private:
+    T value_{};
+    inline static detail::ShardedCopyMoveCounts counts_;
+    inline static detail::CopyMoveType type_{"CopyMoveLog", &detail::type_name<T>, sizeof(T), &counts_};
+};
+
+// CopyMoveLog that also counts default and value construction and destruction,
+// so live and peak live instances (and their bytes) can be read per type.
+// Copies and moves are counted, attributed and reported like CopyMoveLog's.
+template <typename T = int>
+class LifetimeLog {
+public:
+    LifetimeLog() { lifetime_.constructed(detail::kDefaultCtor); }
+    explicit LifetimeLog(const T& value)
+        : value_(value) {
+        lifetime_.constructed(detail::kValueCtor);
+    }
+    explicit LifetimeLog(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(value)) {
+        lifetime_.constructed(detail::kValueCtor);
+    }
+
+    LifetimeLog(const LifetimeLog& other, CallSite site = CallSite::current())
+        : value_(other.value_) {
+        lifetime_.constructed();
+        detail::count_copy_move(counts_, type_, detail::kCopyCtor, site);
+        detail::log_action_for<T>("LifetimeLog", "copy_ctor");
+    }
+    LifetimeLog& operator=(const LifetimeLog& other) {
+        value_ = other.value_;
+        detail::count_copy_move(counts_, type_, detail::kCopyAssign, CallSite{});
+        detail::log_action_for<T>("LifetimeLog", "copy_assign");
+        return *this;
+    }
+    LifetimeLog(LifetimeLog&& other, CallSite site = CallSite::current()) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(other.value_)) {
+        lifetime_.constructed();
+        detail::count_copy_move(counts_, type_, detail::kMoveCtor, site);
+        detail::log_action_for<T>("LifetimeLog", "move_ctor");
+    }
+    LifetimeLog& operator=(LifetimeLog&& other) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        value_ = std::move(other.value_);
+        detail::count_copy_move(counts_, type_, detail::kMoveAssign, CallSite{});
+        detail::log_action_for<T>("LifetimeLog", "move_assign");
+        return *this;
+    }
+
+    ~LifetimeLog() { lifetime_.destroyed(); }
+
+    // Zeroes every count; instances alive now stay live.
     static void reset() {
-        copy_ctor_ = 0;
-        copy_assign_ = 0;
-        move_ctor_ = 0;
-        move_assign_ = 0;
+        counts_.reset();
+        lifetime_.reset();
     }
 
-    static LogCounts counts() {
-        return LogCounts{copy_ctor_.load(), copy_assign_.load(), move_ctor_.load(), move_assign_.load()};
+    // Restarts peak tracking from the current live count, e.g. at the start of a request.
+    static void reset_peak() { lifetime_.reset_peak(); }
+
+    static LogCounts counts() { return counts_.counts(); }
+
+    static LifetimeCounts snapshot() {
+        const LogCounts copies = counts_.counts();
+        LifetimeCounts out;
+        out.default_ctor = lifetime_.load(detail::kDefaultCtor);
+        out.value_ctor = lifetime_.load(detail::kValueCtor);
+        out.copy_ctor = copies.copy_ctor;
+        out.move_ctor = copies.move_ctor;
+        out.copy_assign = copies.copy_assign;
+        out.move_assign = copies.move_assign;
+        out.destroyed = lifetime_.load(detail::kDestroyed);
+        out.live = lifetime_.live();
+        out.peak_live = lifetime_.peak();
+        out.object_size = sizeof(T);
+        return out;
     }
 
     T& value() & { return value_; }
@@ -200,10 +634,128 @@ public:
 
 private:
     T value_{};
-    inline static std::atomic<std::size_t> copy_ctor_{0};
-    inline static std::atomic<std::size_t> copy_assign_{0};
-    inline static std::atomic<std::size_t> move_ctor_{0};
-    inline static std::atomic<std::size_t> move_assign_{0};
+    inline static detail::ShardedCopyMoveCounts counts_;
+    inline static detail::CopyMoveType type_{"LifetimeLog", &detail::type_name<T>, sizeof(T), &counts_};
+    inline static detail::ShardedLifetimeCounts lifetime_;
+};
+
+// While enabled, every copy and move of the wrappers is also counted per call
+// site in a lock-free table. Constructors see the line that asked for the copy;
+// assignments only see the innermost CopySiteTag.
+inline void enable_copy_site_tracking() {
+    detail::copy_sites_on.store(true, std::memory_order_relaxed);
+}
+
+inline void disable_copy_site_tracking() {
+    detail::copy_sites_on.store(false, std::memory_order_relaxed);
+}
+
+inline bool copy_site_tracking_enabled() noexcept {
+    return detail::copy_sites_on.load(std::memory_order_relaxed);
+}
+
+// Attributes copies and moves on this thread to tag until the scope ends, e.g.
+// CopySiteTag tag("parse_batch"); tag must outlive the report.
+class CopySiteTag {
+public:
+    explicit CopySiteTag(const char* tag) noexcept
+        : previous_(detail::copy_site_tag) {
+        detail::copy_site_tag = tag;
+    }
+
+    CopySiteTag(const CopySiteTag&) = delete;
+    CopySiteTag& operator=(const CopySiteTag&) = delete;
+
+    ~CopySiteTag() { detail::copy_site_tag = previous_; }
+
+private:
+    const char* previous_;
 };
 
+// Every wrapper instantiation that has copied or moved, by name.
+inline std::vector<CopyMoveTypeStats> copy_move_type_stats() {
+    std::vector<CopyMoveTypeStats> out;
+    for (const detail::CopyMoveType* type = detail::copy_move_types.load(std::memory_order_acquire); type != nullptr;
+         type = type->next) {
+        out.push_back(CopyMoveTypeStats{type->name(), type->size, type->counts->counts()});
+    }
+    std::sort(out.begin(), out.end(),
+        [](const CopyMoveTypeStats& a, const CopyMoveTypeStats& b) { return a.type < b.type; });
+    return out;
+}
+
+// Per-site counts recorded while tracking was enabled, most frequent first.
+inline std::vector<CopySiteStats> copy_site_stats() {
+    std::vector<CopySiteStats> out;
+    detail::CopySiteTable::instance().for_each([&out](const detail::CopyMoveType& type,
+                                                   detail::CopyMoveCounter action, const CallSite& site,
+                                                   const char* tag, std::uint64_t count) {
+        out.push_back(CopySiteStats{type.name(), detail::copy_move_action_name(action), site.file, site.line, tag,
+            count, count * type.size});
+    });
+    std::sort(out.begin(), out.end(),
+        [](const CopySiteStats& a, const CopySiteStats& b) { return a.count > b.count; });
+    return out;
+}
+
+// Clears the per-site table. Call while no tracked copies are in flight.
+inline void reset_copy_sites() {
+    detail::CopySiteTable::instance().reset();
+}
+
+namespace detail {
+    inline void write_copy_sites(std::FILE* out, std::vector<CopySiteStats>& sites, std::size_t top_n) {
+        std::fprintf(out, "%12s %14s %-12s %-40s %s\n", "count", "bytes", "action", "type", "site");
+        for (std::size_t i = 0; i < sites.size() && i < top_n; ++i) {
+            const CopySiteStats& site = sites[i];
+            std::string where = site.file != nullptr ? std::string(site.file) + ":" + std::to_string(site.line)
+                                                     : std::string("<assignment>");
+            if (site.tag != nullptr) {
+                where += std::string(" [") + site.tag + "]";
+            }
+            std::fprintf(out, "%12llu %14llu %-12s %-40s %s\n", static_cast<unsigned long long>(site.count),
+                static_cast<unsigned long long>(site.bytes), site.action, site.type.c_str(), where.c_str());
+        }
+    }
+} // namespace detail
+
+// Totals of every wrapper type, then the top_n call sites by count and by bytes.
+inline void write_copy_move_report(std::FILE* out = stderr, std::size_t top_n = 10) {
+    std::fprintf(out, "copies and moves by type\n%-48s %8s %12s %12s %12s %12s\n", "type", "size", "copy_ctor",
+        "copy_assign", "move_ctor", "move_assign");
+    for (const auto& type : copy_move_type_stats()) {
+        std::fprintf(out, "%-48s %8zu %12zu %12zu %12zu %12zu\n", type.type.c_str(), type.size, type.counts.copy_ctor,
+            type.counts.copy_assign, type.counts.move_ctor, type.counts.move_assign);
+    }
+    auto sites = copy_site_stats();
+    if (sites.empty()) {
+        if (!copy_site_tracking_enabled()) {
+            std::fputs("(call sites not tracked; see enable_copy_site_tracking)\n", out);
+        }
+        return;
+    }
+    std::fprintf(out, "\ntop %zu sites by count\n", top_n);
+    detail::write_copy_sites(out, sites, top_n);
+    std::stable_sort(sites.begin(), sites.end(),
+        [](const CopySiteStats& a, const CopySiteStats& b) { return a.bytes > b.bytes; });
+    std::fprintf(out, "\ntop %zu sites by bytes\n", top_n);
+    detail::write_copy_sites(out, sites, top_n);
+    if (const std::uint64_t overflow = detail::CopySiteTable::instance().overflow(); overflow != 0) {
+        std::fprintf(out, "(%llu events from sites past the table capacity not shown)\n",
+            static_cast<unsigned long long>(overflow));
+    }
+}
+
+// Enables site tracking and prints write_copy_move_report(stderr, top_n) when the process exits.
+inline void report_copy_moves_at_exit(std::size_t top_n = 10) {
+    static std::size_t report_top_n = top_n;
+    report_top_n = top_n;
+    enable_copy_site_tracking();
+    static const bool registered = [] {
+        std::atexit([] { write_copy_move_report(stderr, report_top_n); });
+        return true;
+    }();
+    (void)registered;
+}
+
 } // namespace hot_utils
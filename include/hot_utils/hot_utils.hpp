@@ -1,7 +1,30 @@
 #pragma once
 
+#include "hot_utils/allocation_log.hpp"
+#include "hot_utils/allocators.hpp"
+#include "hot_utils/async_log.hpp"
+#include "hot_utils/batch.hpp"
+#include "hot_utils/binary_log.hpp"
+#include "hot_utils/benchmark.hpp"
+#include "hot_utils/benchmark_compare.hpp"
+#include "hot_utils/contention_benchmark.hpp"
+#include "hot_utils/copy_move_budget.hpp"
 #include "hot_utils/copy_move_log.hpp"
 #include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/latency_histogram.hpp"
 #include "hot_utils/log_utils.hpp"
+#include "hot_utils/perf_counters.hpp"
+#include "hot_utils/profiler.hpp"
+#include "hot_utils/sampling_profiler.hpp"
 #include "hot_utils/scoped_timer.hpp"
+#include "hot_utils/simd_kernels.hpp"
+#include "hot_utils/streamlined_algorithms.hpp"
+#include "hot_utils/streamlined_buffer.hpp"
+#include "hot_utils/streamlined_expr.hpp"
+#include "hot_utils/streamlined_soa.hpp"
+#include "hot_utils/streamlined_span.hpp"
 #include "hot_utils/streamlined_vector.hpp"
+#include "hot_utils/symbolize.hpp"
+#include "hot_utils/thread_pool.hpp"
+#include "hot_utils/trace.hpp"
+#include "hot_utils/tsc_clock.hpp"
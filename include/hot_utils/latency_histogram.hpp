@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "hot_utils/log_utils.hpp"
+
+namespace hot_utils {
+
+// HDR-style log-linear histogram of nanosecond latencies. Values up to
+// max_value keep significant_digits decimal digits of precision: each power of
+// two is split into the same number of linear sub-buckets, so the relative
+// error is bounded everywhere. record() is O(1) and never allocates; all memory
+// is sized in the constructor. Not thread-safe: give each thread its own
+// histogram and merge() them for the report.
+class LatencyHistogram {
+public:
+    // Defaults cover one nanosecond to one hour at 0.1% precision: 33 buckets of 1024
+    // eight-byte counters, about 264 KiB.
+    explicit LatencyHistogram(std::uint64_t max_value = 3'600'000'000'000, int significant_digits = 3)
+        : max_value_(std::max<std::uint64_t>(max_value, 2))
+        , significant_digits_(std::clamp(significant_digits, 1, 5)) {
+        std::uint64_t largest_single_unit = 2;
+        for (int i = 0; i < significant_digits_; ++i) {
+            largest_single_unit *= 10;
+        }
+        sub_bucket_count_magnitude_ = 0;
+        while ((std::uint64_t{1} << sub_bucket_count_magnitude_) < largest_single_unit) {
+            ++sub_bucket_count_magnitude_;
+        }
+        sub_bucket_half_count_magnitude_ = sub_bucket_count_magnitude_ - 1;
+        sub_bucket_count_ = std::uint64_t{1} << sub_bucket_count_magnitude_;
+        sub_bucket_half_count_ = sub_bucket_count_ / 2;
+        sub_bucket_mask_ = sub_bucket_count_ - 1;
+
+        bucket_count_ = 1;
+        for (std::uint64_t untrackable = sub_bucket_count_; untrackable <= max_value_; untrackable <<= 1) {
+            ++bucket_count_;
+            if (untrackable > std::numeric_limits<std::uint64_t>::max() / 2) {
+                break;
+            }
+        }
+        counts_.assign(static_cast<std::size_t>(bucket_count_ + 1) * sub_bucket_half_count_, 0);
+    }
+
+    std::uint64_t max_trackable() const noexcept { return max_value_; }
+    int significant_digits() const noexcept { return significant_digits_; }
+
+    // Values above max_trackable() are recorded as max_trackable().
+    void record(std::uint64_t value, std::uint64_t count = 1) noexcept {
+        value = std::min(value, max_value_);
+        counts_[counts_index_for(value)] += count;
+        total_ += count;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    template <class Rep, class Period>
+    void record(std::chrono::duration<Rep, Period> elapsed) noexcept {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record(ns < 0 ? 0 : static_cast<std::uint64_t>(ns));
+    }
+
+    // Adds other's samples. Histograms with a different layout are re-binned at
+    // the midpoint of each of other's buckets.
+    void merge(const LatencyHistogram& other) {
+        if (other.total_ == 0) {
+            return;
+        }
+        if (same_layout(other)) {
+            for (std::size_t i = 0; i < counts_.size(); ++i) {
+                counts_[i] += other.counts_[i];
+            }
+            total_ += other.total_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+            return;
+        }
+        for (std::size_t i = 0; i < other.counts_.size(); ++i) {
+            if (other.counts_[i] != 0) {
+                record(other.median_equivalent(other.value_at_index(i)), other.counts_[i]);
+            }
+        }
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, std::min(other.max_, max_value_));
+    }
+
+    void reset() noexcept {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        min_ = std::numeric_limits<std::uint64_t>::max();
+        max_ = 0;
+    }
+
+    std::uint64_t count() const noexcept { return total_; }
+    std::uint64_t min() const noexcept { return total_ == 0 ? 0 : min_; }
+    std::uint64_t max() const noexcept { return max_; }
+
+    double mean() const noexcept {
+        if (total_ == 0) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for_each_bucket([&sum](std::uint64_t value, std::uint64_t count) {
+            sum += static_cast<double>(value) * static_cast<double>(count);
+        });
+        return sum / static_cast<double>(total_);
+    }
+
+    double stddev() const noexcept {
+        if (total_ == 0) {
+            return 0.0;
+        }
+        const double average = mean();
+        double squares = 0.0;
+        for_each_bucket([&](std::uint64_t value, std::uint64_t count) {
+            const double delta = static_cast<double>(value) - average;
+            squares += delta * delta * static_cast<double>(count);
+        });
+        return std::sqrt(squares / static_cast<double>(total_));
+    }
+
+    // Smallest recorded value v such that percentile% of samples are <= v, reported
+    // as the highest value equivalent to v at this precision (capped at max()).
+    std::uint64_t value_at_percentile(double percentile) const noexcept {
+        if (total_ == 0) {
+            return 0;
+        }
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const auto target = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total_))));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(highest_equivalent(value_at_index(i)), max_);
+            }
+        }
+        return max_;
+    }
+
+    // p50 through p99.99 and max, scaled to readable units.
+    void print_percentiles(std::FILE* out = stdout, std::string_view title = "latency") const {
+        char buf[32];
+        std::fprintf(out, "%.*s: %llu samples", static_cast<int>(title.size()), title.data(),
+            static_cast<unsigned long long>(total_));
+        detail::format_duration(buf, sizeof(buf), static_cast<long long>(mean()));
+        std::fprintf(out, ", mean %s\n", buf);
+        static constexpr double percentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+        for (const double percentile : percentiles) {
+            detail::format_duration(buf, sizeof(buf), static_cast<long long>(value_at_percentile(percentile)));
+            std::fprintf(out, "  p%-8g %14s\n", percentile, buf);
+        }
+        detail::format_duration(buf, sizeof(buf), static_cast<long long>(max()));
+        std::fprintf(out, "  %-9s %14s\n", "max", buf);
+    }
+
+    // The HdrHistogram percentile distribution (.hgrm) format, readable by its
+    // plotting tools. Values are divided by value_scale, e.g. 1000 for microseconds.
+    void write_percentile_distribution(
+        std::FILE* out, double value_scale = 1.0, int ticks_per_half_distance = 5) const {
+        std::fprintf(out, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+        if (total_ != 0) {
+            // Percentile steps halve the remaining distance to 100% every
+            // ticks_per_half_distance rows, as HdrHistogram does.
+            double percentile = 0.0;
+            double step = 100.0 / (2.0 * std::max(ticks_per_half_distance, 1));
+            int ticks = 0;
+            while (true) {
+                const std::uint64_t value = value_at_percentile(percentile);
+                const std::uint64_t below = count_at_or_below(value);
+                const double fraction = static_cast<double>(below) / static_cast<double>(total_);
+                if (below >= total_) {
+                    std::fprintf(out, "%12.3f %2.12f %10llu\n", static_cast<double>(value) / value_scale, 1.0,
+                        static_cast<unsigned long long>(below));
+                    break;
+                }
+                std::fprintf(out, "%12.3f %2.12f %10llu %14.2f\n", static_cast<double>(value) / value_scale,
+                    percentile / 100.0, static_cast<unsigned long long>(below), 1.0 / (1.0 - percentile / 100.0));
+                // Skip steps that land inside the same bucket.
+                do {
+                    percentile += step;
+                    if (++ticks == std::max(ticks_per_half_distance, 1)) {
+                        ticks = 0;
+                        step /= 2.0;
+                    }
+                } while (percentile / 100.0 < fraction && step > 1e-12 && percentile < 100.0);
+                if (step <= 1e-12 || percentile >= 100.0) {
+                    percentile = 100.0;
+                }
+            }
+        }
+        std::fprintf(out, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean() / value_scale,
+            stddev() / value_scale);
+        std::fprintf(out, "#[Max     = %12.3f, Total count    = %12llu]\n", static_cast<double>(max_) / value_scale,
+            static_cast<unsigned long long>(total_));
+        std::fprintf(out, "#[Buckets = %12d, SubBuckets     = %12llu]\n", bucket_count_,
+            static_cast<unsigned long long>(sub_bucket_count_));
+    }
+
+private:
+    bool same_layout(const LatencyHistogram& other) const noexcept {
+        return max_value_ == other.max_value_ && significant_digits_ == other.significant_digits_;
+    }
+
+    int bucket_index(std::uint64_t value) const noexcept {
+        const int pow2_ceiling = 64 - __builtin_clzll(value | sub_bucket_mask_);
+        return pow2_ceiling - (sub_bucket_half_count_magnitude_ + 1);
+    }
+
+    std::size_t counts_index_for(std::uint64_t value) const noexcept {
+        const int bucket = bucket_index(value);
+        const std::uint64_t sub_bucket = value >> bucket;
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(bucket + 1) << sub_bucket_half_count_magnitude_)
+            + (sub_bucket - sub_bucket_half_count_));
+    }
+
+    std::uint64_t value_at_index(std::size_t index) const noexcept {
+        int bucket = static_cast<int>(index >> sub_bucket_half_count_magnitude_) - 1;
+        std::uint64_t sub_bucket = (index & (sub_bucket_half_count_ - 1)) + sub_bucket_half_count_;
+        if (bucket < 0) {
+            sub_bucket -= sub_bucket_half_count_;
+            bucket = 0;
+        }
+        return sub_bucket << bucket;
+    }
+
+    std::uint64_t equivalent_range(std::uint64_t value) const noexcept {
+        const int bucket = bucket_index(value);
+        const std::uint64_t sub_bucket = value >> bucket;
+        return std::uint64_t{1} << (sub_bucket >= sub_bucket_count_ ? bucket + 1 : bucket);
+    }
+
+    std::uint64_t lowest_equivalent(std::uint64_t value) const noexcept {
+        const int bucket = bucket_index(value);
+        return (value >> bucket) << bucket;
+    }
+
+    std::uint64_t highest_equivalent(std::uint64_t value) const noexcept {
+        return lowest_equivalent(value) + equivalent_range(value) - 1;
+    }
+
+    std::uint64_t median_equivalent(std::uint64_t value) const noexcept {
+        return lowest_equivalent(value) + equivalent_range(value) / 2;
+    }
+
+    std::uint64_t count_at_or_below(std::uint64_t value) const noexcept {
+        const std::size_t last = counts_index_for(std::min(value, max_value_));
+        std::uint64_t below = 0;
+        for (std::size_t i = 0; i <= last && i < counts_.size(); ++i) {
+            below += counts_[i];
+        }
+        return below;
+    }
+
+    // Calls fn(median value, count) for every non-empty bucket.
+    template <typename F>
+    void for_each_bucket(F&& fn) const {
+        for (std::size_t i = 0; i < counts_.size(); ++i) {
+            if (counts_[i] != 0) {
+                fn(median_equivalent(value_at_index(i)), counts_[i]);
+            }
+        }
+    }
+
+    std::uint64_t max_value_;
+    int significant_digits_;
+    int sub_bucket_count_magnitude_ = 0;
+    int sub_bucket_half_count_magnitude_ = 0;
+    std::uint64_t sub_bucket_count_ = 0;
+    std::uint64_t sub_bucket_half_count_ = 0;
+    std::uint64_t sub_bucket_mask_ = 0;
+    int bucket_count_ = 0;
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t total_ = 0;
+    std::uint64_t min_ = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max_ = 0;
+};
+
+// ScopedTimer logger that records each scope's duration into a histogram
+// instead of printing, e.g.
+//   ScopedTimer<std::chrono::nanoseconds, TscClock, HistogramTimerLogger> t("", HistogramTimerLogger{&h});
+struct HistogramTimerLogger {
+    LatencyHistogram* histogram = nullptr;
+
+    template <class Rep, class Period>
+    void operator()(std::string_view, std::chrono::duration<Rep, Period> elapsed) const noexcept {
+        assert(histogram != nullptr && "HistogramTimerLogger needs a histogram");
+        histogram->record(elapsed);
+    }
+};
+
+} // namespace hot_utils
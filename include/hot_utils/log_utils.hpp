@@ -1,9 +1,23 @@
 #pragma once
 
+#include <atomic>
+#include <cctype>
+#include <climits>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <mutex>
+#include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include "hot_utils/trace.hpp"
 
 namespace hot_utils {
 
@@ -13,15 +27,346 @@ inline constexpr bool kDebugEnabled = false;
 inline constexpr bool kDebugEnabled = true;
 #endif
 
+enum class LogLevel : int { Trace, Debug, Info, Warn, Error, Off };
+
+// Levels below HOT_UTILS_LOG_MIN_LEVEL (a LogLevel value, 0 = Trace) are removed
+// at compile time; define it to 5 (Off) to compile every log statement out.
+#ifndef HOT_UTILS_LOG_MIN_LEVEL
+#define HOT_UTILS_LOG_MIN_LEVEL 0
+#endif
+
+inline constexpr LogLevel kLogMinLevel = static_cast<LogLevel>(HOT_UTILS_LOG_MIN_LEVEL);
+
+template <LogLevel Level>
+inline constexpr bool kLogCompiled = Level >= kLogMinLevel && Level != LogLevel::Off;
+
+// Runtime default for categories without an explicit level: Debug in debug builds, Info otherwise.
+inline constexpr LogLevel kDefaultLogLevel = kDebugEnabled ? LogLevel::Debug : LogLevel::Info;
+
+inline const char* log_level_name(LogLevel level) noexcept {
+    switch (level) {
+    case LogLevel::Trace:
+        return "TRACE";
+    case LogLevel::Debug:
+        return "DEBUG";
+    case LogLevel::Info:
+        return "INFO";
+    case LogLevel::Warn:
+        return "WARN";
+    case LogLevel::Error:
+        return "ERROR";
+    case LogLevel::Off:
+        break;
+    }
+    return "OFF";
+}
+
+// Accepts the lower- or upper-case level names.
+inline bool parse_log_level(std::string_view text, LogLevel& level) noexcept {
+    static constexpr std::string_view names[] = {"trace", "debug", "info", "warn", "error", "off"};
+    for (std::size_t i = 0; i < std::size(names); ++i) {
+        if (text.size() == names[i].size()) {
+            std::size_t c = 0;
+            while (c < text.size() && std::tolower(static_cast<unsigned char>(text[c])) == names[i][c]) {
+                ++c;
+            }
+            if (c == text.size()) {
+                level = static_cast<LogLevel>(i);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+class LogCategory;
+
+namespace detail {
+    class LogConfig;
+    void configure_log_category(LogCategory& category);
+} // namespace detail
+
+// Named log category with its own runtime level. Define one per subsystem with
+// static storage duration, e.g. `inline hot_utils::LogCategory net_log{"net"};`.
+// The level is resolved from the logging configuration on first use.
+class LogCategory {
+public:
+    constexpr explicit LogCategory(const char* name) noexcept
+        : name_(name) {}
+
+    LogCategory(const LogCategory&) = delete;
+    LogCategory& operator=(const LogCategory&) = delete;
+
+    const char* name() const noexcept { return name_; }
+
+    // One relaxed load and a compare when disabled. An unconfigured category
+    // compares as enabled and resolves its level on that first call.
+    bool enabled(LogLevel level) noexcept {
+        const int threshold = threshold_.load(std::memory_order_relaxed);
+        return static_cast<int>(level) >= threshold && (threshold != kUnconfigured || configure_and_check(level));
+    }
+
+    LogLevel level() noexcept {
+        if (threshold_.load(std::memory_order_relaxed) == kUnconfigured) {
+            detail::configure_log_category(*this);
+        }
+        return static_cast<LogLevel>(threshold_.load(std::memory_order_relaxed));
+    }
+
+private:
+    friend class detail::LogConfig;
+
+    static constexpr int kUnconfigured = INT_MIN;
+
+    bool configure_and_check(LogLevel level) noexcept {
+        detail::configure_log_category(*this);
+        return static_cast<int>(level) >= threshold_.load(std::memory_order_relaxed);
+    }
+
+    const char* name_;
+    std::atomic<int> threshold_{kUnconfigured};
+    bool registered_ = false; // guarded by the LogConfig mutex
+};
+
+// Categories used by the library itself.
+namespace log_categories {
+    inline LogCategory general{"general"};     // log_debug
+    inline LogCategory copy_move{"copy_move"}; // CopyLog, MoveLog, CopyMoveLog
+    inline LogCategory timer{"timer"};         // DefaultTimerLogger
+    inline LogCategory call{"call"};           // HOT_UTILS_LOG_CALL, log_call
+    inline LogCategory alloc{"alloc"};         // DefaultAllocationLogger
+} // namespace log_categories
+
+namespace detail {
+    // Process-wide level configuration, seeded from the HOT_UTILS_LOG environment variable.
+    class LogConfig {
+    public:
+        static LogConfig& instance() {
+            static LogConfig config;
+            return config;
+        }
+
+        void configure(LogCategory& category) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!category.registered_) {
+                category.registered_ = true;
+                categories_.push_back(&category);
+            }
+            store_threshold(category);
+        }
+
+        // Spec: comma-separated entries, each a level ("info") setting the default
+        // or category=level ("copy_move=trace"). Returns false, changing nothing, on a malformed spec.
+        bool apply(std::string_view spec, bool reset) {
+            LogLevel default_level = reset ? kDefaultLogLevel : LogLevel::Off;
+            bool has_default = reset;
+            std::vector<std::pair<std::string, LogLevel>> overrides;
+            while (!spec.empty()) {
+                const std::size_t comma = spec.find(',');
+                std::string_view entry = spec.substr(0, comma);
+                spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+                entry = trim(entry);
+                if (entry.empty()) {
+                    continue;
+                }
+                const std::size_t equals = entry.find('=');
+                LogLevel level = LogLevel::Off;
+                if (!parse_log_level(trim(entry.substr(equals == std::string_view::npos ? 0 : equals + 1)), level)) {
+                    return false;
+                }
+                if (equals == std::string_view::npos) {
+                    default_level = level;
+                    has_default = true;
+                } else {
+                    const std::string_view name = trim(entry.substr(0, equals));
+                    if (name.empty()) {
+                        return false;
+                    }
+                    overrides.emplace_back(std::string(name), level);
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (reset) {
+                overrides_.clear();
+            }
+            if (has_default) {
+                default_level_ = default_level;
+            }
+            for (auto& entry : overrides) {
+                set_override(std::move(entry.first), entry.second);
+            }
+            refresh();
+            return true;
+        }
+
+        void set_default(LogLevel level) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            default_level_ = level;
+            refresh();
+        }
+
+        void set_category(std::string_view name, LogLevel level) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            set_override(std::string(name), level);
+            refresh();
+        }
+
+    private:
+        LogConfig() {
+            if (const char* env = std::getenv("HOT_UTILS_LOG")) {
+                if (!apply(env, false)) {
+                    std::fputs("[LOG] ignoring malformed HOT_UTILS_LOG\n", stderr);
+                }
+            }
+        }
+
+        static std::string_view trim(std::string_view text) {
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        void set_override(std::string name, LogLevel level) {
+            for (auto& entry : overrides_) {
+                if (entry.first == name) {
+                    entry.second = level;
+                    return;
+                }
+            }
+            overrides_.emplace_back(std::move(name), level);
+        }
+
+        int resolve(std::string_view name) const {
+            for (const auto& entry : overrides_) {
+                if (entry.first == name) {
+                    return static_cast<int>(entry.second);
+                }
+            }
+            return static_cast<int>(default_level_);
+        }
+
+        void refresh() {
+            for (LogCategory* category : categories_) {
+                store_threshold(*category);
+            }
+        }
+
+        // The call category is mirrored into call_gate for log_call_expr.
+        void store_threshold(LogCategory& category) {
+            const int threshold = resolve(category.name());
+            category.threshold_.store(threshold, std::memory_order_relaxed);
+            if (&category == &log_categories::call) {
+                if (static_cast<int>(LogLevel::Debug) >= threshold) {
+                    call_gate.fetch_or(kCallGateLog, std::memory_order_relaxed);
+                } else {
+                    call_gate.fetch_and(~kCallGateLog, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::mutex mutex_;
+        LogLevel default_level_ = kDefaultLogLevel;
+        std::vector<std::pair<std::string, LogLevel>> overrides_;
+        std::vector<LogCategory*> categories_;
+    };
+
+    inline void configure_log_category(LogCategory& category) {
+        LogConfig::instance().configure(category);
+    }
+} // namespace detail
+
+// True when Level is compiled in and enabled for category. Use as the guard
+// around expensive message construction; HOT_UTILS_LOG does this for you.
+template <LogLevel Level>
+inline bool log_enabled(LogCategory& category) noexcept {
+    if constexpr (kLogCompiled<Level>) {
+        return category.enabled(Level);
+    } else {
+        return false;
+    }
+}
+
+// Replaces the whole configuration with spec, using the HOT_UTILS_LOG syntax:
+// "info,copy_move=trace,timer=off". An empty spec restores the build default.
+inline bool configure_logging(std::string_view spec) {
+    return detail::LogConfig::instance().apply(spec, true);
+}
+
+// Level for every category without its own setting.
+inline void set_log_level(LogLevel level) {
+    detail::LogConfig::instance().set_default(level);
+}
+
+inline void set_log_level(std::string_view category, LogLevel level) {
+    detail::LogConfig::instance().set_category(category, level);
+}
+
 namespace detail {
+    inline void write_log_line(std::FILE* out, const char* level, std::string_view msg) {
+        std::fprintf(out, "[%s] %.*s\n", level, static_cast<int>(msg.size()), msg.data());
+    }
+
+    // Human-scaled duration: ns below 10 us, then us, ms and s with three decimals.
+    inline void format_duration(char* buf, std::size_t size, long long ns) {
+        const long long magnitude = ns < 0 ? -ns : ns;
+        if (magnitude < 10'000) {
+            std::snprintf(buf, size, "%lld ns", ns);
+        } else if (magnitude < 10'000'000) {
+            std::snprintf(buf, size, "%.3f us", static_cast<double>(ns) / 1e3);
+        } else if (magnitude < 10'000'000'000) {
+            std::snprintf(buf, size, "%.3f ms", static_cast<double>(ns) / 1e6);
+        } else {
+            std::snprintf(buf, size, "%.3f s", static_cast<double>(ns) / 1e9);
+        }
+    }
+
+    // Readable form of a mangled C++ name; other names are returned unchanged.
+    inline std::string demangle(const char* mangled) {
+#if defined(__GNUG__)
+        int status = 0;
+        char* const demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+        std::string out = (status == 0 && demangled != nullptr) ? demangled : mangled;
+        std::free(demangled);
+        return out;
+#else
+        return mangled;
+#endif
+    }
+
+    inline void write_log_call(
+        std::FILE* out, const char* file, int line, const char* func, const char* expr, std::size_t depth) {
+        std::fprintf(out, "[CALL] %*s%s:%d %s -> %s\n", static_cast<int>(depth * 2), "", file, line, func, expr);
+    }
+
+    // Replaces the synchronous stderr writes, e.g. with the async backend.
+    // Call records carry their raw fields so a sink can format them later.
+    struct LogSink {
+        void (*line)(const char* level, std::string_view msg);
+        void (*call)(const char* file, int line, const char* func, const char* expr, std::size_t depth);
+    };
+
+    inline std::atomic<const LogSink*> active_log_sink{nullptr};
+
     inline void log_line(const char* level, std::string_view msg) {
-        std::fprintf(stderr, "[%s] %.*s\n", level, static_cast<int>(msg.size()), msg.data());
+        if (const LogSink* sink = active_log_sink.load(std::memory_order_acquire)) {
+            sink->line(level, msg);
+            return;
+        }
+        write_log_line(stderr, level, msg);
     }
 
     inline thread_local std::size_t call_depth = 0;
 
     inline void log_call_impl(const char* file, int line, const char* func, const char* expr, std::size_t depth) {
-        std::fprintf(stderr, "[CALL] %*s%s:%d %s -> %s\n", static_cast<int>(depth * 2), "", file, line, func, expr);
+        if (const LogSink* sink = active_log_sink.load(std::memory_order_acquire)) {
+            sink->call(file, line, func, expr, depth);
+            return;
+        }
+        write_log_call(stderr, file, line, func, expr, depth);
     }
 
     struct CallDepthGuard {
@@ -46,37 +391,77 @@ namespace detail {
         std::size_t depth_ = 0;
     };
 
+    template <typename F>
+    decltype(auto) log_call_traced(
+        bool logged, bool traced, const char* file, int line, const char* func, const char* expr, F&& f) {
+        CallDepthGuard guard(logged);
+        if (logged) {
+            log_call_impl(file, line, func, expr, guard.depth());
+        }
+        TraceSpan span(traced ? expr : nullptr, "call", file, line);
+        return std::forward<F>(f)();
+    }
+
+    // Enabled is the compile-time switch; the call category decides at runtime.
+    // While tracing, the evaluation of f is also recorded as a span. With both
+    // off, the only cost is one relaxed load of call_gate.
     template <bool Enabled, typename F>
     decltype(auto) log_call_expr(const char* file, int line, const char* func, const char* expr, F&& f) {
-        CallDepthGuard guard(Enabled);
         if constexpr (Enabled) {
-            log_call_impl(file, line, func, expr, guard.depth());
+            const unsigned gate = call_gate.load(std::memory_order_relaxed);
+            if (gate != 0) {
+                const bool logged = (gate & kCallGateLog) != 0 && log_categories::call.enabled(LogLevel::Debug);
+                return log_call_traced(
+                    logged, (gate & kCallGateTrace) != 0, file, line, func, expr, std::forward<F>(f));
+            }
         }
         return std::forward<F>(f)();
     }
+
+    // Enabled alone decides whether the call is logged; the call category is not consulted.
+    template <bool Enabled, typename F>
+    decltype(auto) log_call_expr_if(const char* file, int line, const char* func, const char* expr, F&& f) {
+        if constexpr (Enabled) {
+            return log_call_traced(true, tracing_active(), file, line, func, expr, std::forward<F>(f));
+        } else {
+            return std::forward<F>(f)();
+        }
+    }
 } // namespace detail
 
-// Compile-time controllable logging.
+// Enabled removes the call at compile time; the call category filters at runtime.
 template <bool Enabled>
 inline void log_call(const char* file, int line, const char* func) {
     if constexpr (Enabled) {
-        detail::log_call_impl(file, line, func, "<manual>", detail::call_depth);
+        if (log_categories::call.enabled(LogLevel::Debug)) {
+            detail::log_call_impl(file, line, func, "<manual>", detail::call_depth);
+        }
     }
 }
 
 // Convenience macros for capturing call site without changing expression semantics.
 #define HOT_UTILS_LOG_CALL(expr)                                                                                       \
-    ::hot_utils::detail::log_call_expr<::hot_utils::kDebugEnabled>(__FILE__, __LINE__, __func__, #expr, [&]()       \
-                                                                    -> decltype(auto) { return (expr); })
+    ::hot_utils::detail::log_call_expr<::hot_utils::kLogCompiled<::hot_utils::LogLevel::Debug>>(                       \
+        __FILE__, __LINE__, __func__, #expr, [&]() -> decltype(auto) { return (expr); })
 
+// Logs whenever Enabled is true, regardless of the call category.
 #define HOT_UTILS_LOG_CALL_IF(Enabled, expr)                                                                          \
-    ::hot_utils::detail::log_call_expr<Enabled>(__FILE__, __LINE__, __func__, #expr, [&]() -> decltype(auto) {      \
+    ::hot_utils::detail::log_call_expr_if<Enabled>(__FILE__, __LINE__, __func__, #expr, [&]() -> decltype(auto) {      \
         return (expr);                                                                                                \
     })
 
-// Debug logging toggled by NDEBUG.
+// Logs msg at level in category. msg is only evaluated when the category is enabled,
+// so it may build the message, e.g. HOT_UTILS_LOG(net_log, LogLevel::Trace, describe(packet)).
+#define HOT_UTILS_LOG(category, level, msg)                                                                           \
+    do {                                                                                                              \
+        if (::hot_utils::log_enabled<level>(category)) {                                                              \
+            ::hot_utils::detail::log_line(::hot_utils::log_level_name(level), (msg));                                 \
+        }                                                                                                             \
+    } while (false)
+
+// Debug line in the general category.
 inline void log_debug(std::string_view msg) {
-    if constexpr (kDebugEnabled) {
+    if (log_enabled<LogLevel::Debug>(log_categories::general)) {
         detail::log_line("DEBUG", msg);
     }
 }
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HOT_UTILS_HAS_PERF_EVENTS 1
+#else
+#define HOT_UTILS_HAS_PERF_EVENTS 0
+#endif
+
+#include "hot_utils/log_utils.hpp"
+
+namespace hot_utils {
+
+enum class PerfEvent : std::size_t { Cycles, Instructions, BranchMisses, L1dMisses, LlcMisses };
+
+inline constexpr std::size_t kPerfEventCount = 5;
+
+inline const char* perf_event_name(PerfEvent event) noexcept {
+    static constexpr const char* names[kPerfEventCount] = {
+        "cycles", "instructions", "branch-misses", "L1d-misses", "LLC-misses"};
+    return names[static_cast<std::size_t>(event)];
+}
+
+// Counter deltas over one PerfCounterTimer scope. Events the kernel or the
+// hardware refused are absent; elapsed is always filled in.
+struct PerfCounts {
+    std::chrono::nanoseconds elapsed{0};
+    std::uint64_t iterations = 1;
+    std::array<std::uint64_t, kPerfEventCount> values{};
+    std::array<bool, kPerfEventCount> available{};
+
+    bool has(PerfEvent event) const noexcept { return available[static_cast<std::size_t>(event)]; }
+    std::uint64_t operator[](PerfEvent event) const noexcept { return values[static_cast<std::size_t>(event)]; }
+
+    bool any_counter() const noexcept {
+        for (const bool present : available) {
+            if (present) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Instructions per cycle; 0 when either counter is missing.
+    double ipc() const noexcept {
+        if (!has(PerfEvent::Cycles) || !has(PerfEvent::Instructions) || (*this)[PerfEvent::Cycles] == 0) {
+            return 0.0;
+        }
+        return static_cast<double>((*this)[PerfEvent::Instructions]) / static_cast<double>((*this)[PerfEvent::Cycles]);
+    }
+
+    double per_iteration(PerfEvent event) const noexcept {
+        return static_cast<double>((*this)[event]) / static_cast<double>(iterations == 0 ? 1 : iterations);
+    }
+};
+
+namespace detail {
+#if HOT_UTILS_HAS_PERF_EVENTS
+    inline perf_event_attr perf_attr_for(PerfEvent event) noexcept {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        switch (event) {
+        case PerfEvent::Cycles:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::Instructions:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::BranchMisses:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfEvent::L1dMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PerfEvent::LlcMisses:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        }
+        // User-space only, so perf_event_paranoid up to 2 still allows it.
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return attr;
+    }
+
+    inline std::uint64_t read_pmc(std::uint32_t counter) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        std::uint32_t low = 0;
+        std::uint32_t high = 0;
+        __asm__ volatile("rdpmc" : "=a"(low), "=d"(high) : "c"(counter));
+        return (static_cast<std::uint64_t>(high) << 32) | low;
+#else
+        (void)counter;
+        return 0;
+#endif
+    }
+#endif
+
+    // One thread's counter group: cycles leads, the other events join it so they
+    // are scheduled together. Events that fail to open are skipped.
+    class PerfCounterGroup {
+    public:
+        static PerfCounterGroup& this_thread() {
+            thread_local PerfCounterGroup group;
+            return group;
+        }
+
+        PerfCounterGroup(const PerfCounterGroup&) = delete;
+        PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+        ~PerfCounterGroup() {
+#if HOT_UTILS_HAS_PERF_EVENTS
+            for (auto& counter : counters_) {
+                if (counter.page != nullptr) {
+                    munmap(counter.page, page_size());
+                }
+                if (counter.fd >= 0) {
+                    close(counter.fd);
+                }
+            }
+#endif
+        }
+
+        bool available() const noexcept { return count_ != 0; }
+
+        // Reads every open counter into out. Uses rdpmc through the mmapped control
+        // page when the kernel allows it, otherwise one read() of the whole group.
+        // Returns false when the group is not counting (e.g. multiplexed out).
+        bool read(PerfCounts& out) const noexcept {
+#if HOT_UTILS_HAS_PERF_EVENTS
+            if (count_ == 0) {
+                return false;
+            }
+            if (read_user_space(out)) {
+                return true;
+            }
+            std::uint64_t buf[3 + kPerfEventCount] = {};
+            if (::read(counters_[0].fd, buf, sizeof(buf)) < static_cast<ssize_t>(3 * sizeof(std::uint64_t))) {
+                return false;
+            }
+            // nr, time_enabled, time_running, values in open order
+            if (buf[2] == 0) {
+                return false;
+            }
+            for (std::size_t i = 0; i < count_ && i < buf[0]; ++i) {
+                out.values[static_cast<std::size_t>(counters_[i].event)] = buf[3 + i];
+                out.available[static_cast<std::size_t>(counters_[i].event)] = true;
+            }
+            return true;
+#else
+            (void)out;
+            return false;
+#endif
+        }
+
+    private:
+        struct Counter {
+            PerfEvent event = PerfEvent::Cycles;
+            int fd = -1;
+            void* page = nullptr;
+        };
+
+        PerfCounterGroup() {
+#if HOT_UTILS_HAS_PERF_EVENTS
+            int leader = -1;
+            for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+                const auto event = static_cast<PerfEvent>(i);
+                perf_event_attr attr = perf_attr_for(event);
+                attr.disabled = leader < 0 ? 1 : 0;
+                const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+                if (fd < 0) {
+                    if (leader < 0) {
+                        return; // no cycles counter: containers, paranoid settings or no PMU
+                    }
+                    continue;
+                }
+                if (leader < 0) {
+                    leader = fd;
+                }
+                void* page = mmap(nullptr, page_size(), PROT_READ, MAP_SHARED, fd, 0);
+                counters_[count_++] = Counter{event, fd, page == MAP_FAILED ? nullptr : page};
+            }
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+#if HOT_UTILS_HAS_PERF_EVENTS
+        static std::size_t page_size() noexcept { return static_cast<std::size_t>(sysconf(_SC_PAGESIZE)); }
+
+        // The seqlock read sequence from perf_event_open(2).
+        bool read_user_space(PerfCounts& out) const noexcept {
+            std::array<std::uint64_t, kPerfEventCount> values{};
+            for (std::size_t i = 0; i < count_; ++i) {
+                const auto* page = static_cast<const volatile perf_event_mmap_page*>(counters_[i].page);
+                if (page == nullptr) {
+                    return false;
+                }
+                std::uint32_t sequence = 0;
+                std::uint64_t value = 0;
+                do {
+                    sequence = page->lock;
+                    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+                    const std::uint32_t index = page->index;
+                    if (!page->cap_user_rdpmc || index == 0) {
+                        return false;
+                    }
+                    const unsigned width = page->pmc_width;
+                    if (width == 0 || width > 64) {
+                        return false;
+                    }
+                    std::uint64_t pmc = read_pmc(index - 1);
+                    pmc <<= 64 - width;
+                    value = page->offset + static_cast<std::uint64_t>(static_cast<std::int64_t>(pmc) >> (64 - width));
+                    __atomic_signal_fence(__ATOMIC_SEQ_CST);
+                } while (page->lock != sequence);
+                values[i] = value;
+            }
+            for (std::size_t i = 0; i < count_; ++i) {
+                out.values[static_cast<std::size_t>(counters_[i].event)] = values[i];
+                out.available[static_cast<std::size_t>(counters_[i].event)] = true;
+            }
+            return true;
+        }
+#endif
+
+        std::array<Counter, kPerfEventCount> counters_{};
+        std::size_t count_ = 0;
+    };
+} // namespace detail
+
+// Whether this thread could open at least the cycles counter.
+inline bool perf_counters_available() {
+    return detail::PerfCounterGroup::this_thread().available();
+}
+
+// Reports "[PERF] label: <time>, IPC x, <n> <event>/iter ..." or only the time
+// when no counter could be read.
+struct DefaultPerfLogger {
+    void operator()(std::string_view label, const PerfCounts& counts) const {
+        if (!log_enabled<LogLevel::Info>(log_categories::timer)) {
+            return;
+        }
+        char duration[32];
+        detail::format_duration(duration, sizeof(duration), static_cast<long long>(counts.elapsed.count()));
+        std::string line = std::string(label) + ": " + duration;
+        char buf[64];
+        if (!counts.any_counter()) {
+            line += " (counters unavailable)";
+        } else if (counts.has(PerfEvent::Cycles) && counts.has(PerfEvent::Instructions)) {
+            std::snprintf(buf, sizeof(buf), ", IPC %.2f", counts.ipc());
+            line += buf;
+        }
+        for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+            const auto event = static_cast<PerfEvent>(i);
+            if (counts.has(event)) {
+                std::snprintf(buf, sizeof(buf), ", %.2f %s/iter", counts.per_iteration(event), perf_event_name(event));
+                line += buf;
+            }
+        }
+        detail::log_line("PERF", line);
+    }
+};
+
+// ScopedTimer counterpart that also reads this thread's hardware counters at
+// scope entry and exit. iterations divides the per-iteration figures. Counts are
+// not scaled for multiplexing; a scope the group was switched out for reports
+// time only, as does a thread without counter access (no PMU, containers,
+// perf_event_paranoid).
+template <class Logger = DefaultPerfLogger, class Clock = std::chrono::steady_clock>
+class PerfCounterTimer {
+public:
+    explicit PerfCounterTimer(std::string_view label = "", std::uint64_t iterations = 1, Logger logger = Logger{})
+        : label_(label)
+        , logger_(std::move(logger))
+        , group_(detail::PerfCounterGroup::this_thread()) {
+        start_.iterations = iterations;
+        counting_ = group_.read(start_);
+        start_time_ = Clock::now();
+    }
+
+    PerfCounterTimer(const PerfCounterTimer&) = delete;
+    PerfCounterTimer& operator=(const PerfCounterTimer&) = delete;
+
+    ~PerfCounterTimer() {
+        const auto end_time = Clock::now();
+        PerfCounts end;
+        const bool counted = counting_ && group_.read(end);
+        PerfCounts delta;
+        delta.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time_);
+        delta.iterations = start_.iterations;
+        for (std::size_t i = 0; i < kPerfEventCount; ++i) {
+            if (counted && start_.available[i] && end.available[i]) {
+                delta.values[i] = end.values[i] - start_.values[i];
+                delta.available[i] = true;
+            }
+        }
+        logger_(label_, delta);
+    }
+
+private:
+    std::string_view label_;
+    Logger logger_;
+    const detail::PerfCounterGroup& group_;
+    PerfCounts start_;
+    bool counting_ = false;
+    typename Clock::time_point start_time_;
+};
+
+} // namespace hot_utils
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hot_utils {
+
+// One node of the merged call tree, in depth-first order.
+struct ProfileEntry {
+    std::string label;
+    std::size_t depth = 0; // 0 for outermost scopes
+    std::uint64_t calls = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds self{0}; // total minus the time spent in nested scopes
+    std::chrono::nanoseconds max{0};
+};
+
+namespace detail {
+    inline std::atomic<bool> profiler_on{false};
+
+    inline bool profiler_active() noexcept { return profiler_on.load(std::memory_order_relaxed); }
+
+    inline std::uint64_t profile_now_ns() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    struct ProfileStats {
+        std::uint64_t calls = 0;
+        std::uint64_t total_ns = 0;
+        std::uint64_t child_ns = 0;
+        std::uint64_t max_ns = 0;
+
+        void add(const ProfileStats& other) {
+            calls += other.calls;
+            total_ns += other.total_ns;
+            child_ns += other.child_ns;
+            max_ns = std::max(max_ns, other.max_ns);
+        }
+    };
+
+    struct ProfileNode {
+        std::string label;
+        std::uint32_t parent = 0;
+        std::vector<std::uint32_t> children;
+        ProfileStats stats;
+    };
+
+    // One thread's call tree keyed by label. Node 0 is the root and current is
+    // the innermost open scope, the tree counterpart of call_depth. The mutex is
+    // only contended while a report is being built.
+    class ProfileTree {
+    public:
+        ProfileTree()
+            : nodes_(1) {}
+
+        void enter(std::string_view label) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const std::uint32_t child : nodes_[current_].children) {
+                if (nodes_[child].label == label) {
+                    current_ = child;
+                    return;
+                }
+            }
+            const auto child = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.push_back(ProfileNode{std::string(label), current_, {}, {}});
+            nodes_[current_].children.push_back(child);
+            current_ = child;
+        }
+
+        void exit(std::uint64_t elapsed_ns) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (current_ == 0) {
+                return; // scope opened before reset_profiler()
+            }
+            ProfileNode& node = nodes_[current_];
+            ++node.stats.calls;
+            node.stats.total_ns += elapsed_ns;
+            node.stats.max_ns = std::max(node.stats.max_ns, elapsed_ns);
+            current_ = node.parent;
+            nodes_[current_].stats.child_ns += elapsed_ns;
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lock(mutex);
+            nodes_.resize(1);
+            nodes_[0] = ProfileNode{};
+            current_ = 0;
+        }
+
+        // Caller holds mutex.
+        const std::vector<ProfileNode>& nodes() const noexcept { return nodes_; }
+
+        std::mutex mutex;
+
+    private:
+        std::vector<ProfileNode> nodes_;
+        std::uint32_t current_ = 0;
+    };
+
+    struct MergedProfileNode {
+        std::string label;
+        ProfileStats stats;
+        std::vector<MergedProfileNode> children;
+    };
+
+    inline void merge_profile(MergedProfileNode& into, const std::vector<ProfileNode>& nodes, std::uint32_t index) {
+        for (const std::uint32_t child : nodes[index].children) {
+            const ProfileNode& node = nodes[child];
+            auto found = std::find_if(into.children.begin(), into.children.end(),
+                [&node](const MergedProfileNode& merged) { return merged.label == node.label; });
+            if (found == into.children.end()) {
+                into.children.push_back(MergedProfileNode{node.label, {}, {}});
+                found = into.children.end() - 1;
+            }
+            found->stats.add(node.stats);
+            merge_profile(*found, nodes, child);
+        }
+    }
+
+    inline std::uint64_t self_ns(const ProfileStats& stats) noexcept {
+        return stats.total_ns > stats.child_ns ? stats.total_ns - stats.child_ns : 0;
+    }
+
+    // Owns every thread's tree, including those of threads that already exited.
+    class Profiler {
+    public:
+        static Profiler& instance() {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        ProfileTree& this_thread_tree() {
+            thread_local std::shared_ptr<ProfileTree> tree;
+            if (!tree) {
+                tree = std::make_shared<ProfileTree>();
+                std::lock_guard<std::mutex> lock(mutex_);
+                trees_.push_back(tree);
+            }
+            return *tree;
+        }
+
+        void reset() {
+            for (const auto& tree : trees()) {
+                tree->reset();
+            }
+        }
+
+        // Merges the threads by label path; siblings are ordered by total time.
+        MergedProfileNode merged() {
+            MergedProfileNode root;
+            for (const auto& tree : trees()) {
+                std::lock_guard<std::mutex> lock(tree->mutex);
+                merge_profile(root, tree->nodes(), 0);
+            }
+            sort(root);
+            return root;
+        }
+
+    private:
+        Profiler() = default;
+
+        std::vector<std::shared_ptr<ProfileTree>> trees() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return trees_;
+        }
+
+        static void sort(MergedProfileNode& node) {
+            std::sort(node.children.begin(), node.children.end(),
+                [](const MergedProfileNode& a, const MergedProfileNode& b) { return a.stats.total_ns > b.stats.total_ns; });
+            for (auto& child : node.children) {
+                sort(child);
+            }
+        }
+
+        std::mutex mutex_;
+        std::vector<std::shared_ptr<ProfileTree>> trees_;
+    };
+
+    // The profiled part of one ScopedTimer: opens a node on construction and
+    // closes it, once, with the elapsed steady_clock time. Unlabelled timers,
+    // such as the benchmark harness's, are not profiled.
+    class ProfileFrame {
+    public:
+        explicit ProfileFrame(std::string_view label)
+            : active_(!label.empty() && profiler_active()) {
+            if (active_) {
+                Profiler::instance().this_thread_tree().enter(label);
+                start_ns_ = profile_now_ns();
+            }
+        }
+
+        bool active() const noexcept { return active_; }
+
+        void close() {
+            if (active_) {
+                const std::uint64_t elapsed = profile_now_ns() - start_ns_;
+                Profiler::instance().this_thread_tree().exit(elapsed);
+            }
+        }
+
+    private:
+        bool active_;
+        std::uint64_t start_ns_ = 0;
+    };
+
+    inline void flatten_profile(
+        const MergedProfileNode& node, std::size_t depth, std::vector<ProfileEntry>& out) {
+        for (const auto& child : node.children) {
+            out.push_back(ProfileEntry{child.label, depth, child.stats.calls,
+                std::chrono::nanoseconds(child.stats.total_ns), std::chrono::nanoseconds(self_ns(child.stats)),
+                std::chrono::nanoseconds(child.stats.max_ns)});
+            flatten_profile(child, depth + 1, out);
+        }
+    }
+
+    inline void write_folded(const MergedProfileNode& node, std::string& path, std::FILE* out) {
+        for (const auto& child : node.children) {
+            const std::size_t length = path.size();
+            if (!path.empty()) {
+                path += ';';
+            }
+            // ';' separates frames, so it cannot appear inside one.
+            for (const char c : child.label) {
+                path += c == ';' ? ',' : c;
+            }
+            if (const std::uint64_t self = self_ns(child.stats); self != 0) {
+                std::fprintf(out, "%s %llu\n", path.c_str(), static_cast<unsigned long long>(self));
+            }
+            write_folded(child, path, out);
+            path.resize(length);
+        }
+    }
+} // namespace detail
+
+// While enabled, every labelled ScopedTimer records into its thread's call tree
+// and DefaultTimerLogger stays silent: nested timers become child nodes keyed by
+// label, and each node aggregates call count, total, self and max time.
+inline void enable_profiler() {
+    detail::profiler_on.store(true, std::memory_order_relaxed);
+}
+
+inline void disable_profiler() {
+    detail::profiler_on.store(false, std::memory_order_relaxed);
+}
+
+inline bool profiler_enabled() noexcept {
+    return detail::profiler_active();
+}
+
+// Drops everything recorded so far. Scopes still open keep running but are not recorded.
+inline void reset_profiler() {
+    detail::Profiler::instance().reset();
+}
+
+// Merged call tree of every thread, depth first, siblings ordered by total time.
+inline std::vector<ProfileEntry> profile_snapshot() {
+    std::vector<ProfileEntry> out;
+    detail::flatten_profile(detail::Profiler::instance().merged(), 0, out);
+    return out;
+}
+
+// Indented summary table of profile_snapshot().
+inline void write_profile_summary(std::FILE* out = stdout) {
+    std::fprintf(out, "%-48s %12s %12s %12s %12s %12s\n", "scope", "calls", "total ms", "self ms", "mean us",
+        "max us");
+    for (const auto& entry : profile_snapshot()) {
+        const std::string scope = std::string(entry.depth * 2, ' ') + entry.label;
+        const double mean_us = entry.calls == 0 ? 0.0 : static_cast<double>(entry.total.count()) / 1e3 / entry.calls;
+        std::fprintf(out, "%-48s %12llu %12.3f %12.3f %12.3f %12.3f\n", scope.c_str(),
+            static_cast<unsigned long long>(entry.calls), entry.total.count() / 1e6, entry.self.count() / 1e6, mean_us,
+            entry.max.count() / 1e3);
+    }
+}
+
+// Folded stacks ("outer;inner <self ns>" per line) for flamegraph.pl or speedscope.
+inline void write_profile_folded(std::FILE* out) {
+    std::string path;
+    detail::write_folded(detail::Profiler::instance().merged(), path, out);
+}
+
+} // namespace hot_utils
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#include <cerrno>
+#include <csignal>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#define HOT_UTILS_HAS_SAMPLING_PROFILER 1
+#else
+#define HOT_UTILS_HAS_SAMPLING_PROFILER 0
+#endif
+
+#include "hot_utils/log_utils.hpp"
+#include "hot_utils/symbolize.hpp"
+
+namespace hot_utils {
+
+struct SamplingProfilerOptions {
+    // Process CPU time between samples. 10 ms (100 Hz) is cheap enough to stay
+    // attached; 1 ms gives detailed profiles of short runs.
+    std::chrono::microseconds interval{10'000};
+    // Frames kept per sample, including the interrupted instruction.
+    std::size_t max_depth = 64;
+    // Samples kept until reset_sampling_profile(); later ones are dropped and counted.
+    // The buffer takes max_samples * (max_depth + 1) words, 8.5 MiB by default.
+    std::size_t max_samples = std::size_t{1} << 14;
+    // Roots every folded stack in a "thread <tid>" frame.
+    bool split_by_thread = false;
+};
+
+struct SamplingProfileStats {
+    std::uint64_t samples = 0;
+    std::uint64_t dropped = 0;
+};
+
+namespace detail {
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+    // Largest distance between two frame pointers accepted while unwinding.
+    inline constexpr std::uintptr_t kMaxFrameBytes = std::uintptr_t{1} << 20;
+
+    // Asks the kernel to read one word at address: rt_sigprocmask fails with
+    // EFAULT before it looks at the (invalid) how argument, and changes nothing.
+    // Async-signal-safe, unlike touching the address directly.
+    inline bool address_readable(std::uintptr_t address) noexcept {
+        const long result = syscall(SYS_rt_sigprocmask, ~0, reinterpret_cast<void*>(address), nullptr, 8);
+        return !(result == -1 && errno == EFAULT);
+    }
+
+    // Preallocated sample slots: [tid, pcs...], with the depth published last so
+    // readers skip slots a handler is still filling.
+    class SampleBuffer {
+    public:
+        explicit SampleBuffer(const SamplingProfilerOptions& options)
+            : max_depth_(std::max<std::size_t>(options.max_depth, 1))
+            , max_samples_(std::max<std::size_t>(options.max_samples, 1))
+            , words_(std::make_unique<std::uintptr_t[]>(max_samples_ * (max_depth_ + 1)))
+            , depths_(std::make_unique<std::atomic<std::uint32_t>[]>(max_samples_)) {
+            reset();
+        }
+
+        // Called from the SIGPROF handler: no locks, no allocation.
+        void record(const ucontext_t& context) noexcept {
+            const std::size_t slot = next_.fetch_add(1, std::memory_order_relaxed);
+            if (slot >= max_samples_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::uintptr_t* words = &words_[slot * (max_depth_ + 1)];
+            words[0] = static_cast<std::uintptr_t>(syscall(SYS_gettid));
+            std::uintptr_t* pcs = words + 1;
+#if defined(__x86_64__)
+            const auto pc = static_cast<std::uintptr_t>(context.uc_mcontext.gregs[REG_RIP]);
+            std::uintptr_t fp = static_cast<std::uintptr_t>(context.uc_mcontext.gregs[REG_RBP]);
+            const auto sp = static_cast<std::uintptr_t>(context.uc_mcontext.gregs[REG_RSP]);
+#else
+            const auto pc = static_cast<std::uintptr_t>(context.uc_mcontext.pc);
+            std::uintptr_t fp = static_cast<std::uintptr_t>(context.uc_mcontext.regs[29]);
+            const auto sp = static_cast<std::uintptr_t>(context.uc_mcontext.sp);
+#endif
+            std::size_t depth = 0;
+            pcs[depth++] = pc;
+            // Frame records are {previous fp, return address} on both targets. Code
+            // built without frame pointers leaves garbage in fp, so every step is
+            // checked and the walk stops at the first implausible frame.
+            std::uintptr_t readable_page = 0;
+            const std::uintptr_t page_mask = ~std::uintptr_t{4095};
+            while (depth < max_depth_) {
+                if (fp < sp || fp % sizeof(void*) != 0) {
+                    break;
+                }
+                const std::uintptr_t first_page = fp & page_mask;
+                const std::uintptr_t last_page = (fp + sizeof(void*)) & page_mask;
+                if (first_page != readable_page) {
+                    if (!address_readable(fp)) {
+                        break;
+                    }
+                    readable_page = first_page;
+                }
+                if (last_page != readable_page) {
+                    if (!address_readable(fp + sizeof(void*))) {
+                        break;
+                    }
+                    readable_page = last_page;
+                }
+                const auto* record = reinterpret_cast<const std::uintptr_t*>(fp);
+                const std::uintptr_t previous = record[0];
+                const std::uintptr_t return_address = record[1];
+                if (return_address == 0) {
+                    break;
+                }
+                // Minus one lands inside the call instruction, so the caller's symbol is found.
+                pcs[depth++] = return_address - 1;
+                if (previous <= fp || previous - fp > kMaxFrameBytes) {
+                    break;
+                }
+                fp = previous;
+            }
+            depths_[slot].store(static_cast<std::uint32_t>(depth), std::memory_order_release);
+        }
+
+        void reset() noexcept {
+            for (std::size_t i = 0; i < max_samples_; ++i) {
+                depths_[i].store(0, std::memory_order_relaxed);
+            }
+            dropped_.store(0, std::memory_order_relaxed);
+            next_.store(0, std::memory_order_release);
+        }
+
+        SamplingProfileStats stats() const noexcept {
+            SamplingProfileStats out;
+            out.samples = std::min<std::uint64_t>(next_.load(std::memory_order_acquire), max_samples_);
+            out.dropped = dropped_.load(std::memory_order_relaxed);
+            return out;
+        }
+
+        // Calls visit(tid, pcs, depth) for every completed sample, leaf first.
+        template <typename Visit>
+        void for_each(Visit&& visit) const {
+            const std::size_t used = std::min(next_.load(std::memory_order_acquire), max_samples_);
+            for (std::size_t slot = 0; slot < used; ++slot) {
+                const std::uint32_t depth = depths_[slot].load(std::memory_order_acquire);
+                if (depth != 0) {
+                    const std::uintptr_t* words = &words_[slot * (max_depth_ + 1)];
+                    visit(words[0], words + 1, depth);
+                }
+            }
+        }
+
+    private:
+        const std::size_t max_depth_;
+        const std::size_t max_samples_;
+        std::unique_ptr<std::uintptr_t[]> words_;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> depths_;
+        std::atomic<std::size_t> next_{0};
+        std::atomic<std::uint64_t> dropped_{0};
+    };
+
+    inline std::atomic<SampleBuffer*> active_sample_buffer{nullptr};
+
+    inline void sampling_signal_handler(int, siginfo_t*, void* context) {
+        const int saved_errno = errno;
+        if (SampleBuffer* buffer = active_sample_buffer.load(std::memory_order_acquire)) {
+            buffer->record(*static_cast<const ucontext_t*>(context));
+        }
+        errno = saved_errno;
+    }
+#endif
+
+    // Owns the sample buffer and the SIGPROF disposition. The buffer of a stopped
+    // session is kept until the next start, so a late handler never sees it freed.
+    class SamplingProfiler {
+    public:
+        static SamplingProfiler& instance() {
+            static SamplingProfiler profiler;
+            return profiler;
+        }
+
+        SamplingProfiler(const SamplingProfiler&) = delete;
+        SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+        ~SamplingProfiler() { stop(); }
+
+        bool start(const SamplingProfilerOptions& options) {
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (running_) {
+                return false;
+            }
+            buffer_ = std::make_unique<SampleBuffer>(options);
+            split_by_thread_ = options.split_by_thread;
+            struct sigaction action {};
+            action.sa_sigaction = &sampling_signal_handler;
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            if (sigaction(SIGPROF, &action, &previous_action_) != 0) {
+                return false;
+            }
+            active_sample_buffer.store(buffer_.get(), std::memory_order_release);
+            const auto interval = std::max<long long>(options.interval.count(), 1);
+            itimerval timer{};
+            timer.it_interval.tv_sec = static_cast<time_t>(interval / 1'000'000);
+            timer.it_interval.tv_usec = static_cast<suseconds_t>(interval % 1'000'000);
+            timer.it_value = timer.it_interval;
+            if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+                active_sample_buffer.store(nullptr, std::memory_order_release);
+                sigaction(SIGPROF, &previous_action_, nullptr);
+                return false;
+            }
+            running_ = true;
+            return true;
+#else
+            (void)options;
+            return false;
+#endif
+        }
+
+        void stop() {
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!running_) {
+                return;
+            }
+            itimerval timer{};
+            setitimer(ITIMER_PROF, &timer, nullptr);
+            active_sample_buffer.store(nullptr, std::memory_order_release);
+            sigaction(SIGPROF, &previous_action_, nullptr);
+            running_ = false;
+#endif
+        }
+
+        bool running() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return running_;
+        }
+
+        void reset() {
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (buffer_) {
+                buffer_->reset();
+            }
+#endif
+        }
+
+        SamplingProfileStats stats() {
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (buffer_) {
+                return buffer_->stats();
+            }
+#endif
+            return {};
+        }
+
+        // Aggregates identical stacks, then symbolizes each distinct address once.
+        void write_folded(std::FILE* out) {
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!buffer_) {
+                return;
+            }
+            std::map<std::vector<std::uintptr_t>, std::uint64_t> stacks;
+            buffer_->for_each([&](std::uintptr_t tid, const std::uintptr_t* pcs, std::uint32_t depth) {
+                std::vector<std::uintptr_t> key;
+                key.reserve(depth + 1);
+                if (split_by_thread_) {
+                    key.push_back(tid);
+                }
+                key.insert(key.end(), pcs, pcs + depth);
+                ++stacks[key];
+            });
+            std::unordered_map<std::uintptr_t, std::string> symbols;
+            const auto symbol = [&symbols](std::uintptr_t pc) -> const std::string& {
+                auto found = symbols.find(pc);
+                if (found == symbols.end()) {
+                    std::string name = symbolize(pc);
+                    // ';' separates frames, so it cannot appear inside one.
+                    std::replace(name.begin(), name.end(), ';', ',');
+                    found = symbols.emplace(pc, std::move(name)).first;
+                }
+                return found->second;
+            };
+            std::map<std::string, std::uint64_t> folded;
+            for (const auto& [key, count] : stacks) {
+                std::string line;
+                std::size_t root = 0;
+                if (split_by_thread_) {
+                    line = "thread " + std::to_string(key[0]);
+                    root = 1;
+                }
+                // Samples are leaf first; folded stacks are root first.
+                for (std::size_t i = key.size(); i > root; --i) {
+                    if (!line.empty()) {
+                        line += ';';
+                    }
+                    line += symbol(key[i - 1]);
+                }
+                folded[line] += count;
+            }
+            for (const auto& [line, count] : folded) {
+                std::fprintf(out, "%s %llu\n", line.c_str(), static_cast<unsigned long long>(count));
+            }
+            std::fflush(out);
+#else
+            (void)out;
+#endif
+        }
+
+    private:
+        SamplingProfiler() = default;
+
+        std::mutex mutex_;
+        bool running_ = false;
+        bool split_by_thread_ = false;
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+        std::unique_ptr<SampleBuffer> buffer_;
+        struct sigaction previous_action_ {};
+#endif
+    };
+} // namespace detail
+
+// Samples the whole process on a SIGPROF timer that ticks with process CPU time;
+// each signal lands on the thread that was running and records its stack by
+// walking frame pointers, so build with -fno-omit-frame-pointer for full stacks.
+// Replaces any SIGPROF handler until stop, and interrupts blocking calls that are
+// not restarted by SA_RESTART. Returns false when already running or unsupported
+// on this platform (Linux on x86-64 and AArch64 only).
+inline bool start_sampling_profiler(const SamplingProfilerOptions& options = {}) {
+    return detail::SamplingProfiler::instance().start(options);
+}
+
+inline void stop_sampling_profiler() {
+    detail::SamplingProfiler::instance().stop();
+}
+
+inline bool sampling_profiler_running() {
+    return detail::SamplingProfiler::instance().running();
+}
+
+// Drops the samples recorded so far. Call while stopped.
+inline void reset_sampling_profile() {
+    detail::SamplingProfiler::instance().reset();
+}
+
+inline SamplingProfileStats sampling_profile_stats() {
+    return detail::SamplingProfiler::instance().stats();
+}
+
+// Folded stacks ("outer;inner <samples>" per line) for flamegraph.pl or
+// speedscope. Symbolizes with dladdr, so call after stop_sampling_profiler().
+inline void write_sampling_profile_folded(std::FILE* out) {
+    detail::SamplingProfiler::instance().write_folded(out);
+}
+
+} // namespace hot_utils
@@ -3,27 +3,53 @@
 #include <chrono>
 #include <cstdio>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
+#include "hot_utils/binary_log.hpp"
 #include "hot_utils/log_utils.hpp"
+#include "hot_utils/profiler.hpp"
+#include "hot_utils/trace.hpp"
+#include "hot_utils/tsc_clock.hpp"
 
 namespace hot_utils {
 
+// Reports "TIMER label: <duration>" with the unit scaled to the value.
 struct DefaultTimerLogger {
-    void operator()(std::string_view label, std::chrono::milliseconds us) const {
-        char buf[128];
-        std::snprintf(buf, sizeof(buf), "TIMER %.*s: %lld ms", static_cast<int>(label.size()), label.data(),
-            static_cast<long long>(us.count()));
+    template <class Rep, class Period>
+    void operator()(std::string_view label, std::chrono::duration<Rep, Period> elapsed) const {
+        if (!log_enabled<LogLevel::Info>(log_categories::timer)) {
+            return;
+        }
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+        if (detail::binary_logging_active()) {
+            detail::binary_log_at([] { return detail::BinaryLogSite{"TIME", "TIMER {}: {:duration}"}; }, label, ns);
+            return;
+        }
+        char duration[32];
+        detail::format_duration(duration, sizeof(duration), static_cast<long long>(ns.count()));
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "TIMER %.*s: %s", static_cast<int>(label.size()), label.data(), duration);
         detail::log_line("TIME", buf);
     }
 };
 
+// Duration stays milliseconds by default so existing loggers keep their signature.
+// DefaultTimerLogger is given the clock's own resolution and scales the unit itself.
 template <class Duration = std::chrono::milliseconds, class Clock = std::chrono::high_resolution_clock,
     class Logger = DefaultTimerLogger>
 class ScopedTimer {
 public:
+    // While tracing, the timed scope is also recorded as a span named after label.
+    // In profiler mode a labelled timer is aggregated into the call tree instead of
+    // being printed; custom loggers are still called.
     explicit ScopedTimer(std::string_view label = "", Logger logger = Logger{})
-        : label_(label), logger_(std::move(logger)), start_(Clock::now()) {}
+        : label_(label)
+        , logger_(std::move(logger))
+        , traced_(detail::tracing_active() && detail::Tracer::instance().begin(nullptr, label, "timer", nullptr, 0))
+        , profile_(label) {
+        start_ = Clock::now();
+    }
 
     ScopedTimer(const ScopedTimer&) = delete;
     ScopedTimer& operator=(const ScopedTimer&) = delete;
@@ -31,15 +57,31 @@ public:
     ~ScopedTimer() { log(); }
 
 private:
-    void log() const {
+    void log() {
         const auto end = Clock::now();
-        const auto elapsed = std::chrono::duration_cast<Duration>(end - start_);
-        logger_(label_, elapsed);
+        profile_.close();
+        if (traced_) {
+            detail::Tracer::instance().end();
+        }
+        if (std::is_same_v<Logger, DefaultTimerLogger> && profile_.active()) {
+            return;
+        }
+        if constexpr (std::is_same_v<Logger, DefaultTimerLogger>) {
+            logger_(label_, end - start_);
+        } else {
+            logger_(label_, std::chrono::duration_cast<Duration>(end - start_));
+        }
     }
 
     std::string_view label_;
     Logger logger_;
+    bool traced_;
+    detail::ProfileFrame profile_;
     typename Clock::time_point start_;
 };
 
+// ScopedTimer reading the calibrated TSC; see TscClock.
+template <class Logger = DefaultTimerLogger>
+using TscScopedTimer = ScopedTimer<std::chrono::nanoseconds, TscClock, Logger>;
+
 } // namespace hot_utils
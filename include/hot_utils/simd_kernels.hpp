@@ -0,0 +1,815 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HOT_UTILS_SIMD_X86 1
+#include <immintrin.h>
+#define HOT_UTILS_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define HOT_UTILS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define HOT_UTILS_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#else
+#define HOT_UTILS_SIMD_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define HOT_UTILS_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define HOT_UTILS_IS_CONSTANT_EVALUATED() false
+#endif
+
+namespace hot_utils {
+
+enum class SimdIsa { Scalar = 0, Sse42 = 1, Avx2 = 2, Avx512 = 3 };
+
+inline const char* simd_isa_name(SimdIsa isa) {
+    switch (isa) {
+    case SimdIsa::Sse42:
+        return "sse4.2";
+    case SimdIsa::Avx2:
+        return "avx2";
+    case SimdIsa::Avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+inline SimdIsa detected_simd_isa() {
+    static const SimdIsa isa = [] {
+#if HOT_UTILS_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+            return SimdIsa::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SimdIsa::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return SimdIsa::Sse42;
+        }
+#endif
+        return SimdIsa::Scalar;
+    }();
+    return isa;
+}
+
+namespace detail {
+    inline std::atomic<SimdIsa>& simd_isa_slot() {
+        static std::atomic<SimdIsa> slot{detected_simd_isa()};
+        return slot;
+    }
+} // namespace detail
+
+inline SimdIsa active_simd_isa() noexcept { return detail::simd_isa_slot().load(std::memory_order_relaxed); }
+
+// Selects the kernels used from now on, clamped to what the CPU supports. Returns the applied ISA.
+inline SimdIsa set_simd_isa(SimdIsa isa) {
+    const SimdIsa applied = isa > detected_simd_isa() ? detected_simd_isa() : isa;
+    detail::simd_isa_slot().store(applied, std::memory_order_relaxed);
+    return applied;
+}
+
+namespace detail {
+    struct AddOp {
+        template <typename L, typename R>
+        static constexpr void apply(L& lhs, const R& rhs) {
+            lhs += rhs;
+        }
+    };
+
+    struct SubOp {
+        template <typename L, typename R>
+        static constexpr void apply(L& lhs, const R& rhs) {
+            lhs -= rhs;
+        }
+    };
+
+    struct MulOp {
+        template <typename L, typename R>
+        static constexpr void apply(L& lhs, const R& rhs) {
+            lhs *= rhs;
+        }
+    };
+
+    struct DivOp {
+        template <typename L, typename R>
+        static constexpr void apply(L& lhs, const R& rhs) {
+            lhs /= rhs;
+        }
+    };
+
+    // scalar - v and scalar / v keep the vector on the left.
+    struct ReverseSubOp {
+        template <typename L, typename S>
+        static constexpr void apply(L& value, const S& scalar) {
+            value = scalar - value;
+        }
+    };
+
+    struct ReverseDivOp {
+        template <typename L, typename S>
+        static constexpr void apply(L& value, const S& scalar) {
+            value = scalar / value;
+        }
+    };
+} // namespace detail
+
+namespace detail::simd {
+    template <typename T>
+    inline constexpr bool has_kernels_v = std::is_same_v<T, float> || std::is_same_v<T, double>
+        || std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t>;
+
+    // Below this many bytes dispatch costs more than the scalar loop saves.
+    inline constexpr std::size_t kMinBytes = 128;
+
+    // Scratch size for blockwise expression evaluation; small enough to stay in L1.
+    inline constexpr std::size_t kBlockBytes = 2048;
+
+    template <typename T>
+    inline constexpr std::size_t kBlockElements = kBlockBytes / sizeof(T);
+
+    // Scalar operands only take the vector path when the scalar op is already done in T.
+    template <typename T, typename S>
+    inline constexpr bool scalar_converts_exactly_v = std::is_same_v<std::common_type_t<T, S>, T>;
+
+    template <typename Op, typename T, typename U>
+    inline void apply_scalar_loop(T* dst, const U* src, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            Op::apply(dst[i], src[i]);
+        }
+    }
+
+    template <typename Op, typename T, typename S>
+    inline void apply_broadcast_loop(T* dst, S scalar, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            Op::apply(dst[i], scalar);
+        }
+    }
+
+    // Whether std::fma on T is a single instruction in this build rather than a libm call.
+    template <typename T>
+    inline constexpr bool fast_fma_v = false;
+#if defined(FP_FAST_FMAF)
+    template <>
+    inline constexpr bool fast_fma_v<float> = true;
+#endif
+#if defined(FP_FAST_FMA)
+    template <>
+    inline constexpr bool fast_fma_v<double> = true;
+#endif
+
+    // a * b + c for the scalar paths: rounded once where the build has FMA
+    // instructions, otherwise twice, since a libm std::fma per element costs more
+    // than the loop it sits in. The AVX2 and AVX-512 kernels always round once.
+    template <typename T>
+    inline T multiply_add(T a, T b, T c) {
+        if constexpr (fast_fma_v<T>) {
+            return std::fma(a, b, c);
+        } else {
+            return a * b + c;
+        }
+    }
+
+    // dst[i] = dst[i] * mul[i] + add[i].
+    template <typename T>
+    inline void fma_loop(T* dst, const T* mul, const T* add, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            dst[i] = multiply_add(dst[i], mul[i], add[i]);
+        }
+    }
+
+    // y[i] = alpha * x[i] + y[i].
+    template <typename T>
+    inline void axpy_loop(T* y, T alpha, const T* x, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            y[i] = multiply_add(alpha, x[i], y[i]);
+        }
+    }
+
+    // Sum of a[i] * b[i] over four interleaved accumulators, so the order differs from a serial loop.
+    template <typename T>
+    inline T dot_loop(const T* a, const T* b, std::size_t n) {
+        T acc[4]{};
+        const std::size_t full = n - n % 4;
+        for (std::size_t i = 0; i < full; i += 4) {
+            for (std::size_t j = 0; j < 4; ++j) {
+                acc[j] += a[i + j] * b[i + j];
+            }
+        }
+        for (std::size_t i = full; i < n; ++i) {
+            acc[0] += a[i] * b[i];
+        }
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+
+    // Horizontal sum of a register's lanes.
+    template <typename V>
+    inline typename V::value_type lane_total(const typename V::value_type* lanes) {
+        typename V::value_type total{};
+        for (std::size_t j = 0; j < V::width; ++j) {
+            total += lanes[j];
+        }
+        return total;
+    }
+
+    template <typename V, typename Op>
+    inline constexpr bool supports_v = std::is_same_v<Op, AddOp> || std::is_same_v<Op, SubOp>
+        || std::is_same_v<Op, ReverseSubOp> || (std::is_same_v<Op, MulOp> && V::has_mul)
+        || ((std::is_same_v<Op, DivOp> || std::is_same_v<Op, ReverseDivOp>) && V::has_div);
+
+#if HOT_UTILS_SIMD_X86
+    template <typename T>
+    struct Sse42;
+
+    template <>
+    struct Sse42<float> {
+        using value_type = float;
+        using reg = __m128;
+        static constexpr std::size_t width = 4;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_SSE42 static reg load(const float* p) { return _mm_loadu_ps(p); }
+        HOT_UTILS_TARGET_SSE42 static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+        HOT_UTILS_TARGET_SSE42 static reg set1(float s) { return _mm_set1_ps(s); }
+        HOT_UTILS_TARGET_SSE42 static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+    };
+
+    template <>
+    struct Sse42<double> {
+        using value_type = double;
+        using reg = __m128d;
+        static constexpr std::size_t width = 2;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_SSE42 static reg load(const double* p) { return _mm_loadu_pd(p); }
+        HOT_UTILS_TARGET_SSE42 static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+        HOT_UTILS_TARGET_SSE42 static reg set1(double s) { return _mm_set1_pd(s); }
+        HOT_UTILS_TARGET_SSE42 static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+    };
+
+    template <>
+    struct Sse42<std::int32_t> {
+        using value_type = std::int32_t;
+        using reg = __m128i;
+        static constexpr std::size_t width = 4;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_SSE42 static reg load(const std::int32_t* p) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+        HOT_UTILS_TARGET_SSE42 static void store(std::int32_t* p, reg v) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+        HOT_UTILS_TARGET_SSE42 static reg set1(std::int32_t s) { return _mm_set1_epi32(s); }
+        HOT_UTILS_TARGET_SSE42 static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg sub(reg a, reg b) { return _mm_sub_epi32(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg mul(reg a, reg b) { return _mm_mullo_epi32(a, b); }
+        // Exact for every defined int32 quotient: the double error stays below the distance to the next integer.
+        HOT_UTILS_TARGET_SSE42 static reg div(reg a, reg b) {
+            const __m128i lo = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b)));
+            const __m128i hi = _mm_cvttpd_epi32(
+                _mm_div_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(a, a)), _mm_cvtepi32_pd(_mm_unpackhi_epi64(b, b))));
+            return _mm_unpacklo_epi64(lo, hi);
+        }
+    };
+
+    template <>
+    struct Sse42<std::int64_t> {
+        using value_type = std::int64_t;
+        using reg = __m128i;
+        static constexpr std::size_t width = 2;
+        static constexpr bool has_mul = false;
+        static constexpr bool has_div = false;
+
+        HOT_UTILS_TARGET_SSE42 static reg load(const std::int64_t* p) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+        HOT_UTILS_TARGET_SSE42 static void store(std::int64_t* p, reg v) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+        HOT_UTILS_TARGET_SSE42 static reg set1(std::int64_t s) { return _mm_set1_epi64x(s); }
+        HOT_UTILS_TARGET_SSE42 static reg add(reg a, reg b) { return _mm_add_epi64(a, b); }
+        HOT_UTILS_TARGET_SSE42 static reg sub(reg a, reg b) { return _mm_sub_epi64(a, b); }
+    };
+
+    template <typename T>
+    struct Avx2;
+
+    template <>
+    struct Avx2<float> {
+        using value_type = float;
+        using reg = __m256;
+        static constexpr std::size_t width = 8;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_AVX2 static reg load(const float* p) { return _mm256_loadu_ps(p); }
+        HOT_UTILS_TARGET_AVX2 static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+        HOT_UTILS_TARGET_AVX2 static reg set1(float s) { return _mm256_set1_ps(s); }
+        HOT_UTILS_TARGET_AVX2 static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+    };
+
+    template <>
+    struct Avx2<double> {
+        using value_type = double;
+        using reg = __m256d;
+        static constexpr std::size_t width = 4;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_AVX2 static reg load(const double* p) { return _mm256_loadu_pd(p); }
+        HOT_UTILS_TARGET_AVX2 static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+        HOT_UTILS_TARGET_AVX2 static reg set1(double s) { return _mm256_set1_pd(s); }
+        HOT_UTILS_TARGET_AVX2 static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+    };
+
+    template <>
+    struct Avx2<std::int32_t> {
+        using value_type = std::int32_t;
+        using reg = __m256i;
+        static constexpr std::size_t width = 8;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_AVX2 static reg load(const std::int32_t* p) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+        HOT_UTILS_TARGET_AVX2 static void store(std::int32_t* p, reg v) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+        HOT_UTILS_TARGET_AVX2 static reg set1(std::int32_t s) { return _mm256_set1_epi32(s); }
+        HOT_UTILS_TARGET_AVX2 static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg div(reg a, reg b) {
+            const __m128i lo = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(a)),
+                _mm256_cvtepi32_pd(_mm256_castsi256_si128(b))));
+            const __m128i hi = _mm256_cvttpd_epi32(_mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(a, 1)),
+                _mm256_cvtepi32_pd(_mm256_extracti128_si256(b, 1))));
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        }
+    };
+
+    template <>
+    struct Avx2<std::int64_t> {
+        using value_type = std::int64_t;
+        using reg = __m256i;
+        static constexpr std::size_t width = 4;
+        static constexpr bool has_mul = false;
+        static constexpr bool has_div = false;
+
+        HOT_UTILS_TARGET_AVX2 static reg load(const std::int64_t* p) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+        HOT_UTILS_TARGET_AVX2 static void store(std::int64_t* p, reg v) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+        }
+        HOT_UTILS_TARGET_AVX2 static reg set1(std::int64_t s) { return _mm256_set1_epi64x(s); }
+        HOT_UTILS_TARGET_AVX2 static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+        HOT_UTILS_TARGET_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_epi64(a, b); }
+    };
+
+    template <typename T>
+    struct Avx512;
+
+    template <>
+    struct Avx512<float> {
+        using value_type = float;
+        using reg = __m512;
+        static constexpr std::size_t width = 16;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_AVX512 static reg load(const float* p) { return _mm512_loadu_ps(p); }
+        HOT_UTILS_TARGET_AVX512 static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+        HOT_UTILS_TARGET_AVX512 static reg set1(float s) { return _mm512_set1_ps(s); }
+        HOT_UTILS_TARGET_AVX512 static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+    };
+
+    template <>
+    struct Avx512<double> {
+        using value_type = double;
+        using reg = __m512d;
+        static constexpr std::size_t width = 8;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_AVX512 static reg load(const double* p) { return _mm512_loadu_pd(p); }
+        HOT_UTILS_TARGET_AVX512 static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+        HOT_UTILS_TARGET_AVX512 static reg set1(double s) { return _mm512_set1_pd(s); }
+        HOT_UTILS_TARGET_AVX512 static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+    };
+
+    template <>
+    struct Avx512<std::int32_t> {
+        using value_type = std::int32_t;
+        using reg = __m512i;
+        static constexpr std::size_t width = 16;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = true;
+
+        HOT_UTILS_TARGET_AVX512 static reg load(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+        HOT_UTILS_TARGET_AVX512 static void store(std::int32_t* p, reg v) { _mm512_storeu_si512(p, v); }
+        HOT_UTILS_TARGET_AVX512 static reg set1(std::int32_t s) { return _mm512_set1_epi32(s); }
+        HOT_UTILS_TARGET_AVX512 static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_epi32(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg mul(reg a, reg b) { return _mm512_mullo_epi32(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg div(reg a, reg b) {
+            // Zero-masking forms with every lane set: the plain extract, convert and insert
+            // intrinsics pass an _mm*_undefined_* source that trips GCC's -Wmaybe-uninitialized.
+            constexpr __mmask8 kAll = 0xFF;
+            const __m256i lo = _mm512_maskz_cvttpd_epi32(kAll,
+                _mm512_div_pd(_mm512_maskz_cvtepi32_pd(kAll, _mm512_maskz_extracti64x4_epi64(kAll, a, 0)),
+                    _mm512_maskz_cvtepi32_pd(kAll, _mm512_maskz_extracti64x4_epi64(kAll, b, 0))));
+            const __m256i hi = _mm512_maskz_cvttpd_epi32(kAll,
+                _mm512_div_pd(_mm512_maskz_cvtepi32_pd(kAll, _mm512_maskz_extracti64x4_epi64(kAll, a, 1)),
+                    _mm512_maskz_cvtepi32_pd(kAll, _mm512_maskz_extracti64x4_epi64(kAll, b, 1))));
+            return _mm512_maskz_inserti64x4(kAll, _mm512_castsi256_si512(lo), hi, 1);
+        }
+    };
+
+    template <>
+    struct Avx512<std::int64_t> {
+        using value_type = std::int64_t;
+        using reg = __m512i;
+        static constexpr std::size_t width = 8;
+        static constexpr bool has_mul = true;
+        static constexpr bool has_div = false;
+
+        HOT_UTILS_TARGET_AVX512 static reg load(const std::int64_t* p) { return _mm512_loadu_si512(p); }
+        HOT_UTILS_TARGET_AVX512 static void store(std::int64_t* p, reg v) { _mm512_storeu_si512(p, v); }
+        HOT_UTILS_TARGET_AVX512 static reg set1(std::int64_t s) { return _mm512_set1_epi64(s); }
+        HOT_UTILS_TARGET_AVX512 static reg add(reg a, reg b) { return _mm512_add_epi64(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_epi64(a, b); }
+        HOT_UTILS_TARGET_AVX512 static reg mul(reg a, reg b) { return _mm512_mullo_epi64(a, b); }
+    };
+
+    // The loops are repeated per ISA because every function touching the
+    // registers needs the matching target attribute to be inlined.
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_SSE42 inline typename V::reg sse42_combine(typename V::reg a, typename V::reg b) {
+        if constexpr (std::is_same_v<Op, AddOp>) {
+            return V::add(a, b);
+        } else if constexpr (std::is_same_v<Op, SubOp>) {
+            return V::sub(a, b);
+        } else if constexpr (std::is_same_v<Op, MulOp>) {
+            return V::mul(a, b);
+        } else if constexpr (std::is_same_v<Op, DivOp>) {
+            return V::div(a, b);
+        } else if constexpr (std::is_same_v<Op, ReverseSubOp>) {
+            return V::sub(b, a);
+        } else {
+            return V::div(b, a);
+        }
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_SSE42 inline void sse42_apply(
+        typename V::value_type* dst, const typename V::value_type* src, std::size_t n) {
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, sse42_combine<V, Op>(V::load(dst + i), V::load(src + i)));
+        }
+        apply_scalar_loop<Op>(dst + i, src + i, n - i);
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_SSE42 inline void sse42_apply_broadcast(
+        typename V::value_type* dst, typename V::value_type scalar, std::size_t n) {
+        const auto broadcast = V::set1(scalar);
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, sse42_combine<V, Op>(V::load(dst + i), broadcast));
+        }
+        apply_broadcast_loop<Op>(dst + i, scalar, n - i);
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_AVX2 inline typename V::reg avx2_combine(typename V::reg a, typename V::reg b) {
+        if constexpr (std::is_same_v<Op, AddOp>) {
+            return V::add(a, b);
+        } else if constexpr (std::is_same_v<Op, SubOp>) {
+            return V::sub(a, b);
+        } else if constexpr (std::is_same_v<Op, MulOp>) {
+            return V::mul(a, b);
+        } else if constexpr (std::is_same_v<Op, DivOp>) {
+            return V::div(a, b);
+        } else if constexpr (std::is_same_v<Op, ReverseSubOp>) {
+            return V::sub(b, a);
+        } else {
+            return V::div(b, a);
+        }
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_AVX2 inline void avx2_apply(
+        typename V::value_type* dst, const typename V::value_type* src, std::size_t n) {
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, avx2_combine<V, Op>(V::load(dst + i), V::load(src + i)));
+        }
+        apply_scalar_loop<Op>(dst + i, src + i, n - i);
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_AVX2 inline void avx2_apply_broadcast(
+        typename V::value_type* dst, typename V::value_type scalar, std::size_t n) {
+        const auto broadcast = V::set1(scalar);
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, avx2_combine<V, Op>(V::load(dst + i), broadcast));
+        }
+        apply_broadcast_loop<Op>(dst + i, scalar, n - i);
+    }
+
+    template <typename V>
+    HOT_UTILS_TARGET_AVX2 inline void avx2_fma(typename V::value_type* dst, const typename V::value_type* mul,
+        const typename V::value_type* add, std::size_t n) {
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, V::fmadd(V::load(dst + i), V::load(mul + i), V::load(add + i)));
+        }
+        fma_loop(dst + i, mul + i, add + i, n - i);
+    }
+
+    template <typename V>
+    HOT_UTILS_TARGET_AVX2 inline void avx2_axpy(
+        typename V::value_type* y, typename V::value_type alpha, const typename V::value_type* x, std::size_t n) {
+        const auto broadcast = V::set1(alpha);
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(y + i, V::fmadd(broadcast, V::load(x + i), V::load(y + i)));
+        }
+        axpy_loop(y + i, alpha, x + i, n - i);
+    }
+
+    // Four independent FMA chains hide the add latency.
+    template <typename V>
+    HOT_UTILS_TARGET_AVX2 inline typename V::value_type avx2_dot(
+        const typename V::value_type* a, const typename V::value_type* b, std::size_t n) {
+        using T = typename V::value_type;
+        auto acc0 = V::set1(T{});
+        auto acc1 = acc0;
+        auto acc2 = acc0;
+        auto acc3 = acc0;
+        std::size_t i = 0;
+        for (; i + 4 * V::width <= n; i += 4 * V::width) {
+            acc0 = V::fmadd(V::load(a + i), V::load(b + i), acc0);
+            acc1 = V::fmadd(V::load(a + i + V::width), V::load(b + i + V::width), acc1);
+            acc2 = V::fmadd(V::load(a + i + 2 * V::width), V::load(b + i + 2 * V::width), acc2);
+            acc3 = V::fmadd(V::load(a + i + 3 * V::width), V::load(b + i + 3 * V::width), acc3);
+        }
+        for (; i + V::width <= n; i += V::width) {
+            acc0 = V::fmadd(V::load(a + i), V::load(b + i), acc0);
+        }
+        alignas(64) T lanes[V::width];
+        V::store(lanes, V::add(V::add(acc0, acc1), V::add(acc2, acc3)));
+        return lane_total<V>(lanes) + dot_loop(a + i, b + i, n - i);
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_AVX512 inline typename V::reg avx512_combine(typename V::reg a, typename V::reg b) {
+        if constexpr (std::is_same_v<Op, AddOp>) {
+            return V::add(a, b);
+        } else if constexpr (std::is_same_v<Op, SubOp>) {
+            return V::sub(a, b);
+        } else if constexpr (std::is_same_v<Op, MulOp>) {
+            return V::mul(a, b);
+        } else if constexpr (std::is_same_v<Op, DivOp>) {
+            return V::div(a, b);
+        } else if constexpr (std::is_same_v<Op, ReverseSubOp>) {
+            return V::sub(b, a);
+        } else {
+            return V::div(b, a);
+        }
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_AVX512 inline void avx512_apply(
+        typename V::value_type* dst, const typename V::value_type* src, std::size_t n) {
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, avx512_combine<V, Op>(V::load(dst + i), V::load(src + i)));
+        }
+        apply_scalar_loop<Op>(dst + i, src + i, n - i);
+    }
+
+    template <typename V, typename Op>
+    HOT_UTILS_TARGET_AVX512 inline void avx512_apply_broadcast(
+        typename V::value_type* dst, typename V::value_type scalar, std::size_t n) {
+        const auto broadcast = V::set1(scalar);
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, avx512_combine<V, Op>(V::load(dst + i), broadcast));
+        }
+        apply_broadcast_loop<Op>(dst + i, scalar, n - i);
+    }
+
+    template <typename V>
+    HOT_UTILS_TARGET_AVX512 inline void avx512_fma(typename V::value_type* dst, const typename V::value_type* mul,
+        const typename V::value_type* add, std::size_t n) {
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(dst + i, V::fmadd(V::load(dst + i), V::load(mul + i), V::load(add + i)));
+        }
+        fma_loop(dst + i, mul + i, add + i, n - i);
+    }
+
+    template <typename V>
+    HOT_UTILS_TARGET_AVX512 inline void avx512_axpy(
+        typename V::value_type* y, typename V::value_type alpha, const typename V::value_type* x, std::size_t n) {
+        const auto broadcast = V::set1(alpha);
+        std::size_t i = 0;
+        for (; i + V::width <= n; i += V::width) {
+            V::store(y + i, V::fmadd(broadcast, V::load(x + i), V::load(y + i)));
+        }
+        axpy_loop(y + i, alpha, x + i, n - i);
+    }
+
+    // Four independent FMA chains hide the add latency.
+    template <typename V>
+    HOT_UTILS_TARGET_AVX512 inline typename V::value_type avx512_dot(
+        const typename V::value_type* a, const typename V::value_type* b, std::size_t n) {
+        using T = typename V::value_type;
+        auto acc0 = V::set1(T{});
+        auto acc1 = acc0;
+        auto acc2 = acc0;
+        auto acc3 = acc0;
+        std::size_t i = 0;
+        for (; i + 4 * V::width <= n; i += 4 * V::width) {
+            acc0 = V::fmadd(V::load(a + i), V::load(b + i), acc0);
+            acc1 = V::fmadd(V::load(a + i + V::width), V::load(b + i + V::width), acc1);
+            acc2 = V::fmadd(V::load(a + i + 2 * V::width), V::load(b + i + 2 * V::width), acc2);
+            acc3 = V::fmadd(V::load(a + i + 3 * V::width), V::load(b + i + 3 * V::width), acc3);
+        }
+        for (; i + V::width <= n; i += V::width) {
+            acc0 = V::fmadd(V::load(a + i), V::load(b + i), acc0);
+        }
+        alignas(64) T lanes[V::width];
+        V::store(lanes, V::add(V::add(acc0, acc1), V::add(acc2, acc3)));
+        return lane_total<V>(lanes) + dot_loop(a + i, b + i, n - i);
+    }
+#endif
+
+    // dst[i] = dst[i] op src[i] with the best kernel for the active ISA.
+    template <typename Op, typename T>
+    inline void apply(T* dst, const T* src, std::size_t n) {
+#if HOT_UTILS_SIMD_X86
+        if constexpr (has_kernels_v<T>) {
+            switch (active_simd_isa()) {
+            case SimdIsa::Avx512:
+                if constexpr (supports_v<Avx512<T>, Op>) {
+                    avx512_apply<Avx512<T>, Op>(dst, src, n);
+                    return;
+                }
+                [[fallthrough]];
+            case SimdIsa::Avx2:
+                if constexpr (supports_v<Avx2<T>, Op>) {
+                    avx2_apply<Avx2<T>, Op>(dst, src, n);
+                    return;
+                }
+                [[fallthrough]];
+            case SimdIsa::Sse42:
+                if constexpr (supports_v<Sse42<T>, Op>) {
+                    sse42_apply<Sse42<T>, Op>(dst, src, n);
+                    return;
+                }
+                [[fallthrough]];
+            default:
+                break;
+            }
+        }
+#endif
+        apply_scalar_loop<Op>(dst, src, n);
+    }
+
+    // dst[i] = dst[i] op scalar with the best kernel for the active ISA.
+    template <typename Op, typename T, typename S>
+    inline void apply_broadcast(T* dst, S scalar, std::size_t n) {
+#if HOT_UTILS_SIMD_X86
+        if constexpr (has_kernels_v<T> && scalar_converts_exactly_v<T, S>) {
+            const T value = static_cast<T>(scalar);
+            switch (active_simd_isa()) {
+            case SimdIsa::Avx512:
+                if constexpr (supports_v<Avx512<T>, Op>) {
+                    avx512_apply_broadcast<Avx512<T>, Op>(dst, value, n);
+                    return;
+                }
+                [[fallthrough]];
+            case SimdIsa::Avx2:
+                if constexpr (supports_v<Avx2<T>, Op>) {
+                    avx2_apply_broadcast<Avx2<T>, Op>(dst, value, n);
+                    return;
+                }
+                [[fallthrough]];
+            case SimdIsa::Sse42:
+                if constexpr (supports_v<Sse42<T>, Op>) {
+                    sse42_apply_broadcast<Sse42<T>, Op>(dst, value, n);
+                    return;
+                }
+                [[fallthrough]];
+            default:
+                break;
+            }
+        }
+#endif
+        apply_broadcast_loop<Op>(dst, scalar, n);
+    }
+
+    template <typename T>
+    inline void fma(T* dst, const T* mul, const T* add, std::size_t n) {
+#if HOT_UTILS_SIMD_X86
+        if constexpr (std::is_floating_point_v<T> && has_kernels_v<T>) {
+            switch (active_simd_isa()) {
+            case SimdIsa::Avx512:
+                avx512_fma<Avx512<T>>(dst, mul, add, n);
+                return;
+            case SimdIsa::Avx2:
+                avx2_fma<Avx2<T>>(dst, mul, add, n);
+                return;
+            default:
+                break;
+            }
+        }
+#endif
+        fma_loop(dst, mul, add, n);
+    }
+
+    template <typename T>
+    inline void axpy(T* y, T alpha, const T* x, std::size_t n) {
+#if HOT_UTILS_SIMD_X86
+        if constexpr (std::is_floating_point_v<T> && has_kernels_v<T>) {
+            switch (active_simd_isa()) {
+            case SimdIsa::Avx512:
+                avx512_axpy<Avx512<T>>(y, alpha, x, n);
+                return;
+            case SimdIsa::Avx2:
+                avx2_axpy<Avx2<T>>(y, alpha, x, n);
+                return;
+            default:
+                break;
+            }
+        }
+#endif
+        axpy_loop(y, alpha, x, n);
+    }
+
+    template <typename T>
+    inline T dot(const T* a, const T* b, std::size_t n) {
+#if HOT_UTILS_SIMD_X86
+        if constexpr (std::is_floating_point_v<T> && has_kernels_v<T>) {
+            switch (active_simd_isa()) {
+            case SimdIsa::Avx512:
+                return avx512_dot<Avx512<T>>(a, b, n);
+            case SimdIsa::Avx2:
+                return avx2_dot<Avx2<T>>(a, b, n);
+            default:
+                break;
+            }
+        }
+#endif
+        return dot_loop(a, b, n);
+    }
+
+    // True when a run of count elements should go through the dispatched kernels.
+    template <typename T>
+    constexpr bool use_kernels(std::size_t count) {
+        if constexpr (has_kernels_v<T>) {
+            return count * sizeof(T) >= kMinBytes && !HOT_UTILS_IS_CONSTANT_EVALUATED();
+        } else {
+            return false;
+        }
+    }
+} // namespace detail::simd
+
+} // namespace hot_utils
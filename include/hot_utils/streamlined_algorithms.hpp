@@ -0,0 +1,296 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "hot_utils/simd_kernels.hpp"
+#include "hot_utils/streamlined_expr.hpp"
+
+namespace hot_utils {
+
+// Accumulation strategy for floating-point reductions. Integer reductions are exact and ignore it.
+enum class Summation {
+    Fast,     // independent accumulators, combined once at the end
+    Pairwise, // recursive halving; error grows with log(n) instead of n
+    Kahan,    // compensated (Kahan-Babuska) accumulators, slowest but nearly exact
+};
+
+namespace detail {
+    // Independent accumulators per reduction; enough to cover FP add latency on current cores.
+    inline constexpr std::size_t kReduceLanes = 8;
+    inline constexpr std::size_t kPairwiseBlock = 128;
+
+    template <typename V>
+    using operand_value_t = typename std::conditional_t<is_streamlined_expr_v<V>, std::decay_t<V>,
+        StreamlinedContainerTraits<std::decay_t<V>>>::value_type;
+
+    template <typename T>
+    using norm_t = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+
+    // Element accessor that reads containers through a raw pointer and expressions through value().
+    template <typename V>
+    auto element_reader(const V& operand) {
+        if constexpr (is_streamlined_expr_v<V>) {
+            return [&operand](std::size_t index) { return operand.value(index); };
+        } else {
+            const auto* first = StreamlinedContainerTraits<V>::data(operand);
+            return [first](std::size_t index) { return first[index]; };
+        }
+    }
+
+    template <typename T, std::size_t Lanes>
+    T combine_lanes(T (&acc)[Lanes]) {
+        for (std::size_t width = Lanes / 2; width > 0; width /= 2) {
+            for (std::size_t j = 0; j < width; ++j) {
+                acc[j] += acc[j + width];
+            }
+        }
+        return acc[0];
+    }
+
+    template <typename T, typename Read>
+    T lane_sum(std::size_t first, std::size_t count, const Read& read) {
+        T acc[kReduceLanes]{};
+        const std::size_t full = count - count % kReduceLanes;
+        for (std::size_t i = 0; i < full; i += kReduceLanes) {
+            for (std::size_t j = 0; j < kReduceLanes; ++j) {
+                acc[j] += read(first + i + j);
+            }
+        }
+        for (std::size_t j = 0; j < count - full; ++j) {
+            acc[j] += read(first + full + j);
+        }
+        return combine_lanes(acc);
+    }
+
+    template <typename T, typename Read>
+    T pairwise_sum(std::size_t first, std::size_t count, const Read& read) {
+        if (count <= kPairwiseBlock) {
+            return lane_sum<T>(first, count, read);
+        }
+        const std::size_t half = count / 2 / kReduceLanes * kReduceLanes;
+        return pairwise_sum<T>(first, half, read) + pairwise_sum<T>(first + half, count - half, read);
+    }
+
+    // Neumaier's variant of Kahan summation, so large addends do not swallow the compensation.
+    template <typename T>
+    struct CompensatedSum {
+        T sum{};
+        T compensation{};
+
+        void add(T value) {
+            const T t = sum + value;
+            compensation += std::abs(sum) >= std::abs(value) ? (sum - t) + value : (value - t) + sum;
+            sum = t;
+        }
+
+        T result() const { return sum + compensation; }
+    };
+
+    template <typename T, typename Read>
+    T kahan_sum(std::size_t count, const Read& read) {
+        CompensatedSum<T> acc[kReduceLanes]{};
+        const std::size_t full = count - count % kReduceLanes;
+        for (std::size_t i = 0; i < full; i += kReduceLanes) {
+            for (std::size_t j = 0; j < kReduceLanes; ++j) {
+                acc[j].add(read(i + j));
+            }
+        }
+        for (std::size_t j = 0; j < count - full; ++j) {
+            acc[j].add(read(full + j));
+        }
+        CompensatedSum<T> total;
+        for (const auto& lane : acc) {
+            total.add(lane.sum);
+            total.add(lane.compensation);
+        }
+        return total.result();
+    }
+
+    template <typename T, typename Read>
+    T reduce_sum(std::size_t count, const Read& read, Summation mode) {
+        if constexpr (std::is_floating_point_v<T>) {
+            if (mode == Summation::Pairwise) {
+                return pairwise_sum<T>(0, count, read);
+            }
+            if (mode == Summation::Kahan) {
+                return kahan_sum<T>(count, read);
+            }
+        }
+        return lane_sum<T>(0, count, read);
+    }
+
+    // Index of the first element that wins compare against every other element.
+    template <typename Compare, typename V>
+    std::size_t arg_extreme(const V& operand, Compare compare) {
+        const std::size_t count = operand_size(operand);
+        assert(count != 0 && "arg reduction of an empty StreamlinedVector");
+        const auto read = element_reader(operand);
+        std::size_t best = 0;
+        auto best_value = read(0);
+        for (std::size_t i = 1; i < count; ++i) {
+            auto value = read(i);
+            if (compare(value, best_value)) {
+                best_value = std::move(value);
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    template <typename Compare, typename V>
+    auto extreme_value(const V& operand, Compare compare) {
+        using T = operand_value_t<V>;
+        const std::size_t count = operand_size(operand);
+        assert(count != 0 && "min/max of an empty StreamlinedVector");
+        const auto read = element_reader(operand);
+        if constexpr (std::is_arithmetic_v<T>) {
+            // Lane-wise select keeps the loop branch-free so it lowers to min/max instructions.
+            T acc[kReduceLanes];
+            for (std::size_t j = 0; j < kReduceLanes; ++j) {
+                acc[j] = read(j < count ? j : 0);
+            }
+            const std::size_t full = count - count % kReduceLanes;
+            for (std::size_t i = 0; i < full; i += kReduceLanes) {
+                for (std::size_t j = 0; j < kReduceLanes; ++j) {
+                    const T value = read(i + j);
+                    acc[j] = compare(value, acc[j]) ? value : acc[j];
+                }
+            }
+            for (std::size_t j = 0; j < count - full; ++j) {
+                const T value = read(full + j);
+                acc[j] = compare(value, acc[j]) ? value : acc[j];
+            }
+            T best = acc[0];
+            for (std::size_t j = 1; j < kReduceLanes; ++j) {
+                best = compare(acc[j], best) ? acc[j] : best;
+            }
+            return best;
+        } else {
+            return read(arg_extreme(operand, compare));
+        }
+    }
+
+    struct LessCompare {
+        template <typename T>
+        constexpr bool operator()(const T& a, const T& b) const {
+            return a < b;
+        }
+    };
+
+    struct GreaterCompare {
+        template <typename T>
+        constexpr bool operator()(const T& a, const T& b) const {
+            return b < a;
+        }
+    };
+} // namespace detail
+
+template <typename V, EnableIfStreamlinedOperand<V> = 0>
+auto sum(const V& operand, Summation mode = Summation::Fast) {
+    using T = detail::operand_value_t<V>;
+    return detail::reduce_sum<T>(detail::operand_size(operand), detail::element_reader(operand), mode);
+}
+
+// Sum of a[i] * b[i] in one pass, without materializing the product.
+template <typename L, typename R, EnableIfStreamlinedOperands<L, R> = 0>
+auto dot(const L& lhs, const R& rhs, Summation mode = Summation::Fast) {
+    using T = detail::operand_value_t<L>;
+    static_assert(std::is_same_v<T, detail::operand_value_t<R>>, "dot requires matching element types");
+    assert(detail::operand_size(lhs) == detail::operand_size(rhs) && "StreamlinedVector size mismatch in dot");
+    const std::size_t count = detail::operand_size(lhs);
+    constexpr bool kContainers = !detail::is_streamlined_expr_v<L> && !detail::is_streamlined_expr_v<R>;
+    if constexpr (std::is_floating_point_v<T> && kContainers) {
+        if (mode == Summation::Fast && detail::simd::use_kernels<T>(count)) {
+            return detail::simd::dot(detail::StreamlinedContainerTraits<L>::data(lhs),
+                detail::StreamlinedContainerTraits<R>::data(rhs), count);
+        }
+    }
+    const auto read_lhs = detail::element_reader(lhs);
+    const auto read_rhs = detail::element_reader(rhs);
+    return detail::reduce_sum<T>(count, [&](std::size_t i) { return read_lhs(i) * read_rhs(i); }, mode);
+}
+
+// Sum of |x|. Integer elements are accumulated as double so the result cannot overflow.
+template <typename V, EnableIfStreamlinedOperand<V> = 0>
+auto norm1(const V& operand, Summation mode = Summation::Fast) {
+    using N = detail::norm_t<detail::operand_value_t<V>>;
+    const auto read = detail::element_reader(operand);
+    return detail::reduce_sum<N>(
+        detail::operand_size(operand), [&](std::size_t i) { return std::abs(static_cast<N>(read(i))); }, mode);
+}
+
+// Euclidean length, sqrt(sum of x^2).
+template <typename V, EnableIfStreamlinedOperand<V> = 0>
+auto norm2(const V& operand, Summation mode = Summation::Fast) {
+    using N = detail::norm_t<detail::operand_value_t<V>>;
+    if constexpr (std::is_same_v<N, detail::operand_value_t<V>> && !detail::is_streamlined_expr_v<V>) {
+        return std::sqrt(dot(operand, operand, mode));
+    } else {
+        const auto read = detail::element_reader(operand);
+        return std::sqrt(detail::reduce_sum<N>(
+            detail::operand_size(operand),
+            [&](std::size_t i) {
+                const N value = static_cast<N>(read(i));
+                return value * value;
+            },
+            mode));
+    }
+}
+
+template <typename V, EnableIfStreamlinedOperand<V> = 0>
+auto min_value(const V& operand) {
+    return detail::extreme_value(operand, detail::LessCompare{});
+}
+
+template <typename V, EnableIfStreamlinedOperand<V> = 0>
+auto max_value(const V& operand) {
+    return detail::extreme_value(operand, detail::GreaterCompare{});
+}
+
+// Index of the first smallest element.
+template <typename V, EnableIfStreamlinedOperand<V> = 0>
+std::size_t argmin(const V& operand) {
+    return detail::arg_extreme(operand, detail::LessCompare{});
+}
+
+// Index of the first largest element.
+template <typename V, EnableIfStreamlinedOperand<V> = 0>
+std::size_t argmax(const V& operand) {
+    return detail::arg_extreme(operand, detail::GreaterCompare{});
+}
+
+// Lazy a * b + c evaluated in a single pass; usable wherever a + b is.
+template <typename A, typename B, typename C,
+    std::enable_if_t<detail::is_streamlined_operand_v<A> && detail::is_streamlined_operand_v<B>
+            && detail::is_streamlined_operand_v<C>,
+        int> = 0>
+constexpr auto fma(A&& a, B&& b, C&& c) {
+    return detail::make_fma(std::forward<A>(a), std::forward<B>(b), std::forward<C>(c));
+}
+
+// y += alpha * x in place.
+template <typename X, typename Y, typename S,
+    std::enable_if_t<detail::is_streamlined_container_v<X> && detail::is_streamlined_container_v<Y>
+            && std::is_arithmetic_v<S>,
+        int> = 0>
+void axpy(S alpha, const X& x, Y&& y) {
+    using XTraits = detail::StreamlinedContainerTraits<std::decay_t<X>>;
+    using YTraits = detail::StreamlinedContainerTraits<std::decay_t<Y>>;
+    using T = typename YTraits::value_type;
+    static_assert(std::is_same_v<T, typename XTraits::value_type>, "axpy requires matching element types");
+    const std::size_t count = YTraits::size(y);
+    assert(XTraits::size(x) == count && "StreamlinedVector size mismatch in axpy");
+    T* dst = YTraits::data(y);
+    const T* src = XTraits::data(x);
+    if (detail::simd::use_kernels<T>(count)) {
+        detail::simd::axpy(dst, static_cast<T>(alpha), src, count);
+    } else {
+        detail::simd::axpy_loop(dst, static_cast<T>(alpha), src, count);
+    }
+}
+
+} // namespace hot_utils
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "hot_utils/streamlined_expr.hpp"
+#include "hot_utils/streamlined_span.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace hot_utils {
+
+// Heap-backed, runtime-sized counterpart of StreamlinedVector. Storage is
+// cache-line aligned; element types with SIMD kernels are also padded to a
+// whole number of cache lines so that buffer-wide kernels can run over full
+// registers. Move-only; use clone() for an explicit deep copy.
+template <typename T>
+class StreamlinedBuffer final {
+public:
+    using value_type = T;
+    static constexpr std::size_t kAlignment = 64;
+    static constexpr std::size_t kPadElements = sizeof(T) >= kAlignment ? 1 : kAlignment / sizeof(T);
+
+    StreamlinedBuffer() noexcept = default;
+
+    explicit StreamlinedBuffer(std::size_t size) {
+        allocate(size);
+        construct([](T* first, std::size_t n) { std::uninitialized_value_construct_n(first, n); });
+    }
+
+    StreamlinedBuffer(std::size_t size, const T& value) {
+        allocate(size);
+        construct([&value](T* first, std::size_t n) { std::uninitialized_fill_n(first, n, value); });
+    }
+
+    template <std::size_t N>
+    explicit StreamlinedBuffer(const StreamlinedVector<T, N>& vector) {
+        allocate(N);
+        construct([&vector](T* first, std::size_t) { std::uninitialized_copy_n(vector.data.data(), N, first); });
+    }
+
+    // Evaluates an expression straight into freshly allocated storage.
+    template <typename E, EnableIfStreamlinedExpr<E> = 0>
+    StreamlinedBuffer(E&& expr) {
+        allocate(expr.size());
+        if constexpr (std::is_trivially_default_constructible_v<T>) {
+            construct_padding();
+        } else {
+            construct([](T* first, std::size_t n) { std::uninitialized_value_construct_n(first, n); });
+        }
+        // The destructor does not run if this throws, so free the storage here.
+        try {
+            assign_expr(std::forward<E>(expr));
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    StreamlinedBuffer(StreamlinedBuffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0)) {}
+
+    StreamlinedBuffer& operator=(StreamlinedBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    StreamlinedBuffer(const StreamlinedBuffer&) = delete;
+    StreamlinedBuffer& operator=(const StreamlinedBuffer&) = delete;
+
+    ~StreamlinedBuffer() { release(); }
+
+    StreamlinedBuffer clone() const {
+        StreamlinedBuffer out;
+        out.allocate(size_);
+        out.construct([this](T* first, std::size_t) { std::uninitialized_copy_n(data_, size_, first); });
+        return out;
+    }
+
+    template <typename E, EnableIfStreamlinedExpr<E> = 0>
+    StreamlinedBuffer& operator=(E&& expr) {
+        assign_expr(std::forward<E>(expr));
+        return *this;
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    std::size_t padded_size() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+
+    T* begin() noexcept { return data_; }
+    T* end() noexcept { return data_ + size_; }
+    const T* begin() const noexcept { return data_; }
+    const T* end() const noexcept { return data_ + size_; }
+    const T* cbegin() const noexcept { return data_; }
+    const T* cend() const noexcept { return data_ + size_; }
+
+    T& operator[](std::size_t index) noexcept { return data_[index]; }
+    const T& operator[](std::size_t index) const noexcept { return data_[index]; }
+
+    // Fixed-size window [offset, offset + N) usable wherever a StreamlinedVector operand is.
+    template <std::size_t N>
+    StreamlinedSpan<T, N> view(std::size_t offset = 0) noexcept {
+        assert(offset + N <= size_ && "StreamlinedBuffer view out of range");
+        return StreamlinedSpan<T, N>(data_ + offset);
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    StreamlinedBuffer& operator+=(const V& operand) {
+        compound<detail::AddOp>(operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    StreamlinedBuffer& operator-=(const V& operand) {
+        compound<detail::SubOp>(operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    StreamlinedBuffer& operator*=(const V& operand) {
+        compound<detail::MulOp>(operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    StreamlinedBuffer& operator/=(const V& operand) {
+        compound<detail::DivOp>(operand);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedBuffer& operator+=(S scalar) {
+        detail::compound_assign_scalar<detail::AddOp>(data_, kernel_size<detail::AddOp>(), scalar);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedBuffer& operator-=(S scalar) {
+        detail::compound_assign_scalar<detail::SubOp>(data_, kernel_size<detail::SubOp>(), scalar);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedBuffer& operator*=(S scalar) {
+        detail::compound_assign_scalar<detail::MulOp>(data_, kernel_size<detail::MulOp>(), scalar);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedBuffer& operator/=(S scalar) {
+        detail::compound_assign_scalar<detail::DivOp>(data_, kernel_size<detail::DivOp>(), scalar);
+        return *this;
+    }
+
+    bool operator==(const StreamlinedBuffer& rhs) const {
+        return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+    }
+    bool operator!=(const StreamlinedBuffer& rhs) const { return !(*this == rhs); }
+
+    void print(std::ostream& os) const {
+        os << "{";
+        for (std::size_t i = 0; i < size_; ++i) {
+            os << (i == 0 ? "" : ", ") << data_[i];
+        }
+        os << "}";
+    }
+
+private:
+    // Padding lanes only ever hold garbage, so they may take part in ops that cannot trap.
+    template <typename Op>
+    static constexpr bool kPaddedOp = std::is_floating_point_v<T> && !std::is_same_v<Op, detail::DivOp>
+        && !std::is_same_v<Op, detail::ReverseDivOp>;
+
+    template <typename Op>
+    std::size_t kernel_size() const noexcept {
+        return kPaddedOp<Op> ? capacity_ : size_;
+    }
+
+    // Two buffers of equal size share the same padding, so kernels can skip the scalar tail.
+    template <typename Op, typename V>
+    void compound(const V& operand) {
+        if constexpr (std::is_same_v<V, StreamlinedBuffer>) {
+            assert(operand.size_ == size_ && "StreamlinedBuffer size mismatch");
+            const std::size_t count = kernel_size<Op>();
+            if (detail::simd::use_kernels<T>(count)) {
+                detail::simd::apply<Op>(data_, operand.data_, count);
+                return;
+            }
+        }
+        detail::compound_assign_operand<Op>(data_, size_, operand);
+    }
+
+    template <typename E>
+    void assign_expr(E&& expr) {
+        assert(expr.size() == size_ && "StreamlinedBuffer size mismatch in expression");
+        if constexpr (std::is_lvalue_reference_v<E> || std::is_const_v<std::remove_reference_t<E>>) {
+            detail::evaluate_into<false>(data_, size_, expr);
+        } else {
+            detail::evaluate_into<true>(data_, size_, expr);
+        }
+    }
+
+    void allocate(std::size_t size) {
+        size_ = size;
+        // Only kernels read the padding, so other element types do not construct any.
+        capacity_ = detail::simd::has_kernels_v<T> ? (size + kPadElements - 1) / kPadElements * kPadElements : size;
+        if (capacity_ != 0) {
+            data_ = static_cast<T*>(::operator new(capacity_ * sizeof(T), std::align_val_t{kAlignment}));
+        }
+    }
+
+    template <typename Construct>
+    void construct(Construct&& construct_elements) {
+        try {
+            construct_elements(data_, size_);
+        } catch (...) {
+            deallocate();
+            throw;
+        }
+        construct_padding();
+    }
+
+    void construct_padding() {
+        try {
+            std::uninitialized_value_construct_n(data_ + size_, capacity_ - size_);
+        } catch (...) {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                std::destroy_n(data_, size_);
+            }
+            deallocate();
+            throw;
+        }
+    }
+
+    void deallocate() noexcept {
+        if (data_ != nullptr) {
+            ::operator delete(data_, std::align_val_t{kAlignment});
+        }
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+    void release() noexcept {
+        if (data_ != nullptr) {
+            std::destroy_n(data_, capacity_);
+        }
+        deallocate();
+    }
+
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t capacity_ = 0;
+};
+
+namespace detail {
+    template <typename T>
+    struct StreamlinedContainerTraits<StreamlinedBuffer<T>> {
+        static constexpr bool value = true;
+        static constexpr bool is_view = false;
+        using value_type = T;
+        static constexpr std::size_t extent = kDynamicExtent;
+
+        static const T* data(const StreamlinedBuffer<T>& v) noexcept { return v.data(); }
+        static T* data(StreamlinedBuffer<T>& v) noexcept { return v.data(); }
+        static std::size_t size(const StreamlinedBuffer<T>& v) noexcept { return v.size(); }
+    };
+} // namespace detail
+
+} // namespace hot_utils
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hot_utils/simd_kernels.hpp"
+
+namespace hot_utils {
+
+// Extent of operands whose size is only known at runtime.
+inline constexpr std::size_t kDynamicExtent = static_cast<std::size_t>(-1);
+
+template <typename T, std::size_t N>
+struct StreamlinedVector;
+
+template <typename T>
+class StreamlinedBuffer;
+
+template <typename S>
+using EnableIfArithmetic = std::enable_if_t<std::is_arithmetic_v<std::decay_t<S>>, int>;
+
+namespace detail {
+    // Containers take part in expressions by specializing this trait with
+    // value_type, extent, is_view, data() and size(). Views are held by value.
+    template <typename C>
+    struct StreamlinedContainerTraits {
+        static constexpr bool value = false;
+    };
+
+    template <typename C>
+    inline constexpr bool is_streamlined_container_v = StreamlinedContainerTraits<std::decay_t<C>>::value;
+
+    struct StreamlinedExprBase {};
+
+    template <typename E>
+    inline constexpr bool is_streamlined_expr_v = std::is_base_of_v<StreamlinedExprBase, std::decay_t<E>>;
+
+    template <typename V>
+    inline constexpr bool is_streamlined_operand_v = is_streamlined_container_v<V> || is_streamlined_expr_v<V>;
+
+    template <typename T>
+    constexpr bool ranges_overlap(const T* a, std::size_t a_size, const T* b, std::size_t b_size) noexcept {
+        return a < b + b_size && b < a + a_size;
+    }
+
+    // Lvalue operand or view: read in place, copied only when it becomes the destination value.
+    template <typename C>
+    struct ContainerRef {
+        using Traits = StreamlinedContainerTraits<C>;
+        using value_type = typename Traits::value_type;
+        static constexpr std::size_t extent = Traits::extent;
+
+        std::conditional_t<Traits::is_view, C, const C*> stored;
+
+        constexpr const C& container() const noexcept {
+            if constexpr (Traits::is_view) {
+                return stored;
+            } else {
+                return *stored;
+            }
+        }
+
+        constexpr std::size_t size() const noexcept { return Traits::size(container()); }
+        constexpr const value_type& value(std::size_t index) const { return Traits::data(container())[index]; }
+        constexpr const value_type& consume_value(std::size_t index) { return value(index); }
+        constexpr void eval_into(value_type& out, std::size_t index) const { out = value(index); }
+        constexpr void consume_into(value_type& out, std::size_t index) { out = value(index); }
+
+        const value_type* block_data(std::size_t begin) const { return Traits::data(container()) + begin; }
+        void eval_block(value_type* out, std::size_t begin, std::size_t count) const {
+            std::copy_n(block_data(begin), count, out);
+        }
+
+        constexpr bool aliases(const value_type* dest, std::size_t count) const noexcept {
+            return ranges_overlap(Traits::data(container()), size(), dest, count);
+        }
+
+        // Overlaps dest at another offset, so element i reads what dest[j != i] holds.
+        constexpr bool aliases_shifted(const value_type* dest, std::size_t count) const noexcept {
+            return Traits::data(container()) != dest && aliases(dest, count);
+        }
+    };
+
+    // Rvalue operand: owned by the node so elements can be moved into the destination.
+    template <typename C>
+    struct ContainerOwned {
+        using Traits = StreamlinedContainerTraits<C>;
+        using value_type = typename Traits::value_type;
+        static constexpr std::size_t extent = Traits::extent;
+
+        C container;
+
+        constexpr std::size_t size() const noexcept { return Traits::size(container); }
+        constexpr const value_type& value(std::size_t index) const { return Traits::data(container)[index]; }
+        constexpr const value_type& consume_value(std::size_t index) { return value(index); }
+        constexpr void eval_into(value_type& out, std::size_t index) const { out = value(index); }
+        constexpr void consume_into(value_type& out, std::size_t index) {
+            out = std::move(Traits::data(container)[index]);
+        }
+
+        const value_type* block_data(std::size_t begin) const { return Traits::data(container) + begin; }
+        void eval_block(value_type* out, std::size_t begin, std::size_t count) const {
+            std::copy_n(block_data(begin), count, out);
+        }
+
+        constexpr bool aliases(const value_type*, std::size_t) const noexcept { return false; }
+        constexpr bool aliases_shifted(const value_type*, std::size_t) const noexcept { return false; }
+    };
+
+    template <typename S>
+    struct ScalarOperand {
+        S scalar;
+
+        constexpr const S& value(std::size_t) const noexcept { return scalar; }
+        constexpr const S& consume_value(std::size_t) noexcept { return scalar; }
+        template <typename T>
+        constexpr bool aliases(const T*, std::size_t) const noexcept {
+            return false;
+        }
+        template <typename T>
+        constexpr bool aliases_shifted(const T*, std::size_t) const noexcept {
+            return false;
+        }
+    };
+
+    template <typename S>
+    struct IsScalarOperand : std::false_type {};
+
+    template <typename S>
+    struct IsScalarOperand<ScalarOperand<S>> : std::true_type {};
+
+    template <typename L, typename R>
+    constexpr bool operands_compatible() {
+        if constexpr (IsScalarOperand<R>::value) {
+            return true;
+        } else {
+            return std::is_same_v<typename L::value_type, typename R::value_type>
+                && (L::extent == R::extent || L::extent == kDynamicExtent || R::extent == kDynamicExtent);
+        }
+    }
+
+    // A static extent wins over a dynamic one; sizes are then checked at runtime.
+    constexpr std::size_t combine_extents(std::size_t a, std::size_t b) noexcept {
+        return a == kDynamicExtent ? b : a;
+    }
+
+    template <typename L, typename R>
+    constexpr std::size_t combined_extent() {
+        if constexpr (IsScalarOperand<R>::value) {
+            return L::extent;
+        } else {
+            return combine_extents(L::extent, R::extent);
+        }
+    }
+
+    template <typename V>
+    constexpr std::size_t operand_size(const V& operand) noexcept {
+        if constexpr (is_streamlined_expr_v<V>) {
+            return operand.size();
+        } else {
+            return StreamlinedContainerTraits<V>::size(operand);
+        }
+    }
+
+    template <typename T, typename E>
+    void evaluate_blocks(T* dest, std::size_t count, const E& expr, bool aliased) {
+        alignas(64) T block[simd::kBlockElements<T>];
+        for (std::size_t begin = 0; begin < count; begin += simd::kBlockElements<T>) {
+            const std::size_t n = std::min(simd::kBlockElements<T>, count - begin);
+            if (aliased) {
+                expr.eval_block(block, begin, n);
+                std::copy_n(block, n, dest + begin);
+            } else {
+                expr.eval_block(dest + begin, begin, n);
+            }
+        }
+    }
+
+    // dest op= src element by element, for a src that does not overlap dest at another offset.
+    template <typename Op, typename T>
+    constexpr void compound_assign_elements(T* dest, const T* src, std::size_t count) {
+        if (simd::use_kernels<T>(count)) {
+            simd::apply<Op>(dest, src, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            Op::apply(dest[i], src[i]);
+        }
+    }
+
+    template <typename Op, typename T, typename E>
+    void compound_assign_blocks(T* dest, std::size_t count, const E& expr) {
+        alignas(64) T block[simd::kBlockElements<T>];
+        for (std::size_t begin = 0; begin < count; begin += simd::kBlockElements<T>) {
+            const std::size_t n = std::min(simd::kBlockElements<T>, count - begin);
+            expr.eval_block(block, begin, n);
+            simd::apply<Op>(dest + begin, block, n);
+        }
+    }
+
+    // Writes expr into dest. Falls back to per-element temporaries when dest is
+    // also read by the expression, since the left spine is written before the right side is read.
+    // An operand that overlaps dest at another offset would read elements already written,
+    // so that case is evaluated into a temporary first.
+    // Arithmetic element types are evaluated block by block through the SIMD kernels.
+    template <bool Consume, typename T, typename E>
+    constexpr void evaluate_into(T* dest, std::size_t count, E& expr) {
+        if (expr.aliases_shifted(dest, count)) {
+            std::vector<T> staged(count);
+            evaluate_into<Consume>(staged.data(), count, expr);
+            std::move(staged.begin(), staged.end(), dest);
+            return;
+        }
+        const bool aliased = expr.aliases(dest, count);
+        if constexpr (simd::has_kernels_v<T>) {
+            if (simd::use_kernels<T>(count)) {
+                evaluate_blocks(dest, count, expr, aliased);
+                return;
+            }
+        }
+        if (aliased) {
+            for (std::size_t i = 0; i < count; ++i) {
+                T tmp{};
+                if constexpr (Consume) {
+                    expr.consume_into(tmp, i);
+                } else {
+                    expr.eval_into(tmp, i);
+                }
+                dest[i] = std::move(tmp);
+            }
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            if constexpr (Consume) {
+                expr.consume_into(dest[i], i);
+            } else {
+                expr.eval_into(dest[i], i);
+            }
+        }
+    }
+
+    template <typename Op, typename T, typename E>
+    constexpr void compound_assign(T* dest, std::size_t count, const E& expr) {
+        if (expr.aliases_shifted(dest, count)) {
+            std::vector<T> staged(count);
+            evaluate_into<false>(staged.data(), count, expr);
+            compound_assign_elements<Op>(dest, staged.data(), count);
+            return;
+        }
+        if constexpr (simd::has_kernels_v<T>) {
+            if (simd::use_kernels<T>(count)) {
+                compound_assign_blocks<Op>(dest, count, expr);
+                return;
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            Op::apply(dest[i], expr.value(i));
+        }
+    }
+
+    // dest op= operand for a container or an expression of the same element type.
+    template <typename Op, typename T, typename V>
+    constexpr void compound_assign_operand(T* dest, std::size_t count, const V& operand) {
+        assert(operand_size(operand) == count && "StreamlinedVector size mismatch");
+        if constexpr (is_streamlined_expr_v<V>) {
+            compound_assign<Op>(dest, count, operand);
+        } else {
+            const T* src = StreamlinedContainerTraits<V>::data(operand);
+            if (src != dest && ranges_overlap(src, count, dest, count)) {
+                const std::vector<T> staged(src, src + count);
+                compound_assign_elements<Op>(dest, staged.data(), count);
+                return;
+            }
+            compound_assign_elements<Op>(dest, src, count);
+        }
+    }
+
+    template <typename Op, typename T, typename S>
+    constexpr void compound_assign_scalar(T* dest, std::size_t count, S scalar) {
+        if (simd::use_kernels<T>(count)) {
+            simd::apply_broadcast<Op>(dest, scalar, count);
+            return;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            Op::apply(dest[i], scalar);
+        }
+    }
+
+    // Materialization shared by every node: static extents evaluate into a
+    // StreamlinedVector, dynamic ones into a StreamlinedBuffer.
+    template <typename Derived, typename T, std::size_t Extent>
+    struct MaterializingExpr : StreamlinedExprBase {
+        constexpr auto eval() && {
+            auto& self = static_cast<Derived&>(*this);
+            if constexpr (Extent == kDynamicExtent) {
+                return StreamlinedBuffer<T>(std::move(self));
+            } else {
+                StreamlinedVector<T, Extent> out{};
+                evaluate_into<true>(out.data.data(), Extent, self);
+                return out;
+            }
+        }
+
+        constexpr auto eval() const& {
+            const auto& self = static_cast<const Derived&>(*this);
+            if constexpr (Extent == kDynamicExtent) {
+                return StreamlinedBuffer<T>(self);
+            } else {
+                StreamlinedVector<T, Extent> out{};
+                evaluate_into<false>(out.data.data(), Extent, self);
+                return out;
+            }
+        }
+
+        template <typename V, std::enable_if_t<std::is_same_v<V, StreamlinedVector<T, Extent>>, int> = 0>
+        constexpr operator V() && {
+            return std::move(*this).eval();
+        }
+
+        template <typename V, std::enable_if_t<std::is_same_v<V, StreamlinedVector<T, Extent>>, int> = 0>
+        constexpr operator V() const& {
+            return eval();
+        }
+    };
+
+    // Pointer to count elements of operand starting at begin; nested nodes are evaluated into scratch.
+    template <typename V>
+    const typename V::value_type* block_source(
+        const V& operand, typename V::value_type* scratch, std::size_t begin, std::size_t count) {
+        if constexpr (is_streamlined_expr_v<V>) {
+            operand.eval_block(scratch, begin, count);
+            return scratch;
+        } else {
+            return operand.block_data(begin);
+        }
+    }
+
+    // Lazy element-wise node. Nested nodes are held by value, containers by
+    // reference (lvalues) or by value (rvalues), so the node never dangles.
+    template <typename Op, typename L, typename R>
+    struct BinaryExpr : MaterializingExpr<BinaryExpr<Op, L, R>, typename L::value_type, combined_extent<L, R>()> {
+        using value_type = typename L::value_type;
+        static constexpr std::size_t extent = combined_extent<L, R>();
+
+        static_assert(operands_compatible<L, R>(), "StreamlinedVector expressions require matching types and sizes");
+
+        L lhs;
+        R rhs;
+
+        constexpr std::size_t size() const noexcept { return lhs.size(); }
+
+        constexpr void eval_into(value_type& out, std::size_t index) const {
+            lhs.eval_into(out, index);
+            Op::apply(out, rhs.value(index));
+        }
+
+        constexpr void consume_into(value_type& out, std::size_t index) {
+            lhs.consume_into(out, index);
+            Op::apply(out, rhs.consume_value(index));
+        }
+
+        constexpr value_type value(std::size_t index) const {
+            value_type out{};
+            eval_into(out, index);
+            return out;
+        }
+
+        constexpr value_type consume_value(std::size_t index) {
+            value_type out{};
+            consume_into(out, index);
+            return out;
+        }
+
+        void eval_block(value_type* out, std::size_t begin, std::size_t count) const {
+            lhs.eval_block(out, begin, count);
+            if constexpr (IsScalarOperand<R>::value) {
+                simd::apply_broadcast<Op>(out, rhs.scalar, count);
+            } else {
+                alignas(64) value_type block[is_streamlined_expr_v<R> ? simd::kBlockElements<value_type> : 1];
+                simd::apply<Op>(out, block_source(rhs, block, begin, count), count);
+            }
+        }
+
+        constexpr bool aliases(const value_type* dest, std::size_t count) const noexcept {
+            return lhs.aliases(dest, count) || rhs.aliases(dest, count);
+        }
+
+        constexpr bool aliases_shifted(const value_type* dest, std::size_t count) const noexcept {
+            return lhs.aliases_shifted(dest, count) || rhs.aliases_shifted(dest, count);
+        }
+    };
+
+    // Lazy a * b + c. Rounding follows simd::multiply_add.
+    template <typename A, typename B, typename C>
+    struct FmaExpr : MaterializingExpr<FmaExpr<A, B, C>, typename A::value_type,
+                         combine_extents(combined_extent<A, B>(), C::extent)> {
+        using value_type = typename A::value_type;
+        static constexpr std::size_t extent = combine_extents(combined_extent<A, B>(), C::extent);
+
+        static_assert(operands_compatible<A, B>() && operands_compatible<A, C>(),
+            "StreamlinedVector expressions require matching types and sizes");
+
+        A a;
+        B b;
+        C c;
+
+        constexpr std::size_t size() const noexcept { return a.size(); }
+
+        constexpr void eval_into(value_type& out, std::size_t index) const {
+            if constexpr (std::is_floating_point_v<value_type>) {
+                out = simd::multiply_add(a.value(index), b.value(index), c.value(index));
+            } else {
+                a.eval_into(out, index);
+                out *= b.value(index);
+                out += c.value(index);
+            }
+        }
+
+        constexpr void consume_into(value_type& out, std::size_t index) {
+            if constexpr (std::is_floating_point_v<value_type>) {
+                out = simd::multiply_add(a.consume_value(index), b.consume_value(index), c.consume_value(index));
+            } else {
+                a.consume_into(out, index);
+                out *= b.consume_value(index);
+                out += c.consume_value(index);
+            }
+        }
+
+        constexpr value_type value(std::size_t index) const {
+            value_type out{};
+            eval_into(out, index);
+            return out;
+        }
+
+        constexpr value_type consume_value(std::size_t index) {
+            value_type out{};
+            consume_into(out, index);
+            return out;
+        }
+
+        void eval_block(value_type* out, std::size_t begin, std::size_t count) const {
+            alignas(64) value_type mul_block[is_streamlined_expr_v<B> ? simd::kBlockElements<value_type> : 1];
+            alignas(64) value_type add_block[is_streamlined_expr_v<C> ? simd::kBlockElements<value_type> : 1];
+            a.eval_block(out, begin, count);
+            simd::fma(out, block_source(b, mul_block, begin, count), block_source(c, add_block, begin, count), count);
+        }
+
+        constexpr bool aliases(const value_type* dest, std::size_t count) const noexcept {
+            return a.aliases(dest, count) || b.aliases(dest, count) || c.aliases(dest, count);
+        }
+
+        constexpr bool aliases_shifted(const value_type* dest, std::size_t count) const noexcept {
+            return a.aliases_shifted(dest, count) || b.aliases_shifted(dest, count) || c.aliases_shifted(dest, count);
+        }
+    };
+
+    template <typename V>
+    constexpr auto make_operand(V&& operand) {
+        using D = std::decay_t<V>;
+        if constexpr (is_streamlined_expr_v<D>) {
+            return D(std::forward<V>(operand));
+        } else if constexpr (StreamlinedContainerTraits<D>::is_view) {
+            return ContainerRef<D>{operand};
+        } else if constexpr (std::is_lvalue_reference_v<V>) {
+            return ContainerRef<D>{&operand};
+        } else {
+            return ContainerOwned<D>{std::forward<V>(operand)};
+        }
+    }
+
+    template <typename Op, typename L, typename R>
+    constexpr auto make_binary(L&& lhs, R&& rhs) {
+        assert(operand_size(lhs) == operand_size(rhs) && "StreamlinedVector expression size mismatch");
+        using LOperand = decltype(make_operand(std::forward<L>(lhs)));
+        using ROperand = decltype(make_operand(std::forward<R>(rhs)));
+        return BinaryExpr<Op, LOperand, ROperand>{{}, make_operand(std::forward<L>(lhs)),
+            make_operand(std::forward<R>(rhs))};
+    }
+
+    template <typename A, typename B, typename C>
+    constexpr auto make_fma(A&& a, B&& b, C&& c) {
+        assert(operand_size(a) == operand_size(b) && operand_size(a) == operand_size(c)
+            && "StreamlinedVector expression size mismatch");
+        using AOperand = decltype(make_operand(std::forward<A>(a)));
+        using BOperand = decltype(make_operand(std::forward<B>(b)));
+        using COperand = decltype(make_operand(std::forward<C>(c)));
+        return FmaExpr<AOperand, BOperand, COperand>{{}, make_operand(std::forward<A>(a)),
+            make_operand(std::forward<B>(b)), make_operand(std::forward<C>(c))};
+    }
+
+    template <typename Op, typename V, typename S>
+    constexpr auto make_scalar_binary(V&& operand, S scalar) {
+        using VOperand = decltype(make_operand(std::forward<V>(operand)));
+        return BinaryExpr<Op, VOperand, ScalarOperand<S>>{{}, make_operand(std::forward<V>(operand)),
+            ScalarOperand<S>{scalar}};
+    }
+} // namespace detail
+
+template <typename E>
+using EnableIfStreamlinedExpr = std::enable_if_t<detail::is_streamlined_expr_v<E>, int>;
+
+template <typename V>
+using EnableIfStreamlinedOperand = std::enable_if_t<detail::is_streamlined_operand_v<V>, int>;
+
+template <typename L, typename R>
+using EnableIfStreamlinedOperands =
+    std::enable_if_t<detail::is_streamlined_operand_v<L> && detail::is_streamlined_operand_v<R>, int>;
+
+template <typename V, typename S>
+using EnableIfStreamlinedScalarOperands =
+    std::enable_if_t<detail::is_streamlined_operand_v<V> && std::is_arithmetic_v<std::decay_t<S>>, int>;
+
+template <typename L, typename R, EnableIfStreamlinedOperands<L, R> = 0>
+constexpr auto operator+(L&& lhs, R&& rhs) {
+    return detail::make_binary<detail::AddOp>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template <typename L, typename R, EnableIfStreamlinedOperands<L, R> = 0>
+constexpr auto operator-(L&& lhs, R&& rhs) {
+    return detail::make_binary<detail::SubOp>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template <typename L, typename R, EnableIfStreamlinedOperands<L, R> = 0>
+constexpr auto operator*(L&& lhs, R&& rhs) {
+    return detail::make_binary<detail::MulOp>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template <typename L, typename R, EnableIfStreamlinedOperands<L, R> = 0>
+constexpr auto operator/(L&& lhs, R&& rhs) {
+    return detail::make_binary<detail::DivOp>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator+(V&& lhs, S scalar) {
+    return detail::make_scalar_binary<detail::AddOp>(std::forward<V>(lhs), scalar);
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator+(S scalar, V&& rhs) {
+    return detail::make_scalar_binary<detail::AddOp>(std::forward<V>(rhs), scalar);
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator-(V&& lhs, S scalar) {
+    return detail::make_scalar_binary<detail::SubOp>(std::forward<V>(lhs), scalar);
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator-(S scalar, V&& rhs) {
+    return detail::make_scalar_binary<detail::ReverseSubOp>(std::forward<V>(rhs), scalar);
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator*(V&& lhs, S scalar) {
+    return detail::make_scalar_binary<detail::MulOp>(std::forward<V>(lhs), scalar);
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator*(S scalar, V&& rhs) {
+    return detail::make_scalar_binary<detail::MulOp>(std::forward<V>(rhs), scalar);
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator/(V&& lhs, S scalar) {
+    return detail::make_scalar_binary<detail::DivOp>(std::forward<V>(lhs), scalar);
+}
+
+template <typename V, typename S, EnableIfStreamlinedScalarOperands<V, S> = 0>
+constexpr auto operator/(S scalar, V&& rhs) {
+    return detail::make_scalar_binary<detail::ReverseDivOp>(std::forward<V>(rhs), scalar);
+}
+
+} // namespace hot_utils
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hot_utils/streamlined_algorithms.hpp"
+#include "hot_utils/streamlined_buffer.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace hot_utils {
+
+template <typename T, std::size_t N>
+class StreamlinedSoA;
+
+namespace detail {
+    // Items transposed per pass; keeps the touched rows of every column in L1.
+    inline constexpr std::size_t kTransposeBlock = 256;
+
+    // Item i of a StreamlinedSoA, read and written component by component.
+    // SoA is StreamlinedSoA<T, N> or const StreamlinedSoA<T, N>.
+    template <typename SoA, typename T, std::size_t N>
+    class SoAItemRef {
+    public:
+        using value_type = T;
+        using element_reference = std::conditional_t<std::is_const_v<SoA>, const T&, T&>;
+
+        SoAItemRef(SoA& soa, std::size_t index) noexcept
+            : soa_(&soa)
+            , index_(index) {}
+
+        SoAItemRef(const SoAItemRef&) noexcept = default;
+
+        // Proxy semantics: assignment writes the referenced item, it does not rebind.
+        template <typename OtherSoA>
+        SoAItemRef& operator=(const SoAItemRef<OtherSoA, T, N>& rhs) {
+            return *this = rhs.to_vector();
+        }
+
+        SoAItemRef& operator=(const SoAItemRef& rhs) { return *this = rhs.to_vector(); }
+
+        SoAItemRef& operator=(const StreamlinedVector<T, N>& rhs) {
+            for (std::size_t c = 0; c < N; ++c) {
+                (*this)[c] = rhs[c];
+            }
+            return *this;
+        }
+
+        constexpr std::size_t size() const noexcept { return N; }
+        std::size_t index() const noexcept { return index_; }
+
+        element_reference operator[](std::size_t component) const noexcept {
+            return soa_->column(component)[index_];
+        }
+
+        StreamlinedVector<T, N> to_vector() const {
+            StreamlinedVector<T, N> out{};
+            for (std::size_t c = 0; c < N; ++c) {
+                out[c] = (*this)[c];
+            }
+            return out;
+        }
+
+        operator StreamlinedVector<T, N>() const { return to_vector(); }
+
+        SoAItemRef& operator+=(const StreamlinedVector<T, N>& rhs) { return compound<AddOp>(rhs); }
+        SoAItemRef& operator-=(const StreamlinedVector<T, N>& rhs) { return compound<SubOp>(rhs); }
+        SoAItemRef& operator*=(const StreamlinedVector<T, N>& rhs) { return compound<MulOp>(rhs); }
+        SoAItemRef& operator/=(const StreamlinedVector<T, N>& rhs) { return compound<DivOp>(rhs); }
+
+        template <typename S, EnableIfArithmetic<S> = 0>
+        SoAItemRef& operator+=(S scalar) {
+            return compound_scalar<AddOp>(scalar);
+        }
+
+        template <typename S, EnableIfArithmetic<S> = 0>
+        SoAItemRef& operator-=(S scalar) {
+            return compound_scalar<SubOp>(scalar);
+        }
+
+        template <typename S, EnableIfArithmetic<S> = 0>
+        SoAItemRef& operator*=(S scalar) {
+            return compound_scalar<MulOp>(scalar);
+        }
+
+        template <typename S, EnableIfArithmetic<S> = 0>
+        SoAItemRef& operator/=(S scalar) {
+            return compound_scalar<DivOp>(scalar);
+        }
+
+        bool operator==(const StreamlinedVector<T, N>& rhs) const {
+            for (std::size_t c = 0; c < N; ++c) {
+                if (!((*this)[c] == rhs[c])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        bool operator!=(const StreamlinedVector<T, N>& rhs) const { return !(*this == rhs); }
+
+        void print(std::ostream& os) const { to_vector().print(os); }
+
+    private:
+        template <typename Op>
+        SoAItemRef& compound(const StreamlinedVector<T, N>& rhs) {
+            for (std::size_t c = 0; c < N; ++c) {
+                Op::apply((*this)[c], rhs[c]);
+            }
+            return *this;
+        }
+
+        template <typename Op, typename S>
+        SoAItemRef& compound_scalar(S scalar) {
+            for (std::size_t c = 0; c < N; ++c) {
+                Op::apply((*this)[c], scalar);
+            }
+            return *this;
+        }
+
+        SoA* soa_;
+        std::size_t index_;
+    };
+} // namespace detail
+
+// Structure-of-arrays collection of StreamlinedVector<T, N> items. Component c
+// of every item lives in column(c), a cache-line aligned StreamlinedBuffer, so
+// per-component work runs over contiguous memory through the SIMD kernels.
+// Per-item access goes through proxies that read and write like a StreamlinedVector.
+template <typename T, std::size_t N>
+class StreamlinedSoA final {
+public:
+    using value_type = StreamlinedVector<T, N>;
+    using reference = detail::SoAItemRef<StreamlinedSoA, T, N>;
+    using const_reference = detail::SoAItemRef<const StreamlinedSoA, T, N>;
+    static constexpr std::size_t components = N;
+
+    StreamlinedSoA() = default;
+
+    explicit StreamlinedSoA(std::size_t size) {
+        for (auto& column : columns_) {
+            column = StreamlinedBuffer<T>(size);
+        }
+    }
+
+    // Transposes count array-of-structs items into columns.
+    StreamlinedSoA(const StreamlinedVector<T, N>* items, std::size_t count)
+        : StreamlinedSoA(count) {
+        assign_from(items);
+    }
+
+    explicit StreamlinedSoA(const std::vector<StreamlinedVector<T, N>>& items)
+        : StreamlinedSoA(items.data(), items.size()) {}
+
+    StreamlinedSoA(StreamlinedSoA&&) noexcept = default;
+    StreamlinedSoA& operator=(StreamlinedSoA&&) noexcept = default;
+
+    StreamlinedSoA(const StreamlinedSoA&) = delete;
+    StreamlinedSoA& operator=(const StreamlinedSoA&) = delete;
+
+    StreamlinedSoA clone() const {
+        StreamlinedSoA out;
+        for (std::size_t c = 0; c < N; ++c) {
+            out.columns_[c] = columns_[c].clone();
+        }
+        return out;
+    }
+
+    std::size_t size() const noexcept { return columns_[0].size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    StreamlinedBuffer<T>& column(std::size_t component) noexcept { return columns_[component]; }
+    const StreamlinedBuffer<T>& column(std::size_t component) const noexcept { return columns_[component]; }
+
+    reference operator[](std::size_t index) noexcept { return reference(*this, index); }
+    const_reference operator[](std::size_t index) const noexcept { return const_reference(*this, index); }
+
+    // Overwrites every item from size() array-of-structs items.
+    void assign_from(const StreamlinedVector<T, N>* items) {
+        const std::size_t count = size();
+        for (std::size_t begin = 0; begin < count; begin += detail::kTransposeBlock) {
+            const std::size_t end = std::min(count, begin + detail::kTransposeBlock);
+            for (std::size_t c = 0; c < N; ++c) {
+                T* column_data = columns_[c].data();
+                for (std::size_t i = begin; i < end; ++i) {
+                    column_data[i] = items[i][c];
+                }
+            }
+        }
+    }
+
+    // Writes every item back out as size() array-of-structs items.
+    void copy_to(StreamlinedVector<T, N>* items) const {
+        const std::size_t count = size();
+        for (std::size_t begin = 0; begin < count; begin += detail::kTransposeBlock) {
+            const std::size_t end = std::min(count, begin + detail::kTransposeBlock);
+            for (std::size_t c = 0; c < N; ++c) {
+                const T* column_data = columns_[c].data();
+                for (std::size_t i = begin; i < end; ++i) {
+                    items[i][c] = column_data[i];
+                }
+            }
+        }
+    }
+
+    std::vector<StreamlinedVector<T, N>> to_aos() const {
+        std::vector<StreamlinedVector<T, N>> out(size());
+        copy_to(out.data());
+        return out;
+    }
+
+    // Calls fn(column(c), c) for every component.
+    template <typename F>
+    void for_each_column(F&& fn) {
+        for (std::size_t c = 0; c < N; ++c) {
+            fn(columns_[c], c);
+        }
+    }
+
+    StreamlinedSoA& operator+=(const StreamlinedSoA& rhs) { return columnwise<detail::AddOp>(rhs); }
+    StreamlinedSoA& operator-=(const StreamlinedSoA& rhs) { return columnwise<detail::SubOp>(rhs); }
+    StreamlinedSoA& operator*=(const StreamlinedSoA& rhs) { return columnwise<detail::MulOp>(rhs); }
+    StreamlinedSoA& operator/=(const StreamlinedSoA& rhs) { return columnwise<detail::DivOp>(rhs); }
+
+    // Per-component offset or scale applied to every item, e.g. translating all points.
+    StreamlinedSoA& operator+=(const StreamlinedVector<T, N>& rhs) { return per_component<detail::AddOp>(rhs); }
+    StreamlinedSoA& operator-=(const StreamlinedVector<T, N>& rhs) { return per_component<detail::SubOp>(rhs); }
+    StreamlinedSoA& operator*=(const StreamlinedVector<T, N>& rhs) { return per_component<detail::MulOp>(rhs); }
+    StreamlinedSoA& operator/=(const StreamlinedVector<T, N>& rhs) { return per_component<detail::DivOp>(rhs); }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedSoA& operator+=(S scalar) {
+        return every_column([scalar](StreamlinedBuffer<T>& column) { column += scalar; });
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedSoA& operator-=(S scalar) {
+        return every_column([scalar](StreamlinedBuffer<T>& column) { column -= scalar; });
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedSoA& operator*=(S scalar) {
+        return every_column([scalar](StreamlinedBuffer<T>& column) { column *= scalar; });
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    StreamlinedSoA& operator/=(S scalar) {
+        return every_column([scalar](StreamlinedBuffer<T>& column) { column /= scalar; });
+    }
+
+    bool operator==(const StreamlinedSoA& rhs) const { return columns_ == rhs.columns_; }
+    bool operator!=(const StreamlinedSoA& rhs) const { return !(*this == rhs); }
+
+private:
+    template <typename F>
+    StreamlinedSoA& every_column(F fn) {
+        for (auto& column : columns_) {
+            fn(column);
+        }
+        return *this;
+    }
+
+    template <typename Op>
+    StreamlinedSoA& columnwise(const StreamlinedSoA& rhs) {
+        assert(rhs.size() == size() && "StreamlinedSoA size mismatch");
+        for (std::size_t c = 0; c < N; ++c) {
+            detail::compound_assign_operand<Op>(columns_[c].data(), size(), rhs.columns_[c]);
+        }
+        return *this;
+    }
+
+    template <typename Op>
+    StreamlinedSoA& per_component(const StreamlinedVector<T, N>& rhs) {
+        for (std::size_t c = 0; c < N; ++c) {
+            detail::compound_assign_scalar<Op>(columns_[c].data(), size(), rhs[c]);
+        }
+        return *this;
+    }
+
+    std::array<StreamlinedBuffer<T>, N> columns_;
+};
+
+template <typename T, std::size_t N>
+StreamlinedSoA<T, N> aos_to_soa(const std::vector<StreamlinedVector<T, N>>& items) {
+    return StreamlinedSoA<T, N>(items);
+}
+
+template <typename T, std::size_t N>
+std::vector<StreamlinedVector<T, N>> soa_to_aos(const StreamlinedSoA<T, N>& soa) {
+    return soa.to_aos();
+}
+
+// y += alpha * x column by column, e.g. advancing positions by velocity * dt.
+template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
+void axpy(S alpha, const StreamlinedSoA<T, N>& x, StreamlinedSoA<T, N>& y) {
+    assert(x.size() == y.size() && "StreamlinedSoA size mismatch in axpy");
+    for (std::size_t c = 0; c < N; ++c) {
+        axpy(alpha, x.column(c), y.column(c));
+    }
+}
+
+} // namespace hot_utils
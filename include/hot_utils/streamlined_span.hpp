@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "hot_utils/streamlined_expr.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace hot_utils {
+
+// Fixed-size, non-owning view with the StreamlinedVector operator surface.
+// Assignment writes through to the viewed elements.
+template <typename T, std::size_t N>
+class StreamlinedSpan final {
+public:
+    using value_type = T;
+    static constexpr std::size_t size_v = N;
+
+    constexpr explicit StreamlinedSpan(T* first) noexcept
+        : data_(first) {}
+    constexpr StreamlinedSpan(StreamlinedVector<T, N>& vector) noexcept
+        : data_(vector.data.data()) {}
+
+    constexpr StreamlinedSpan(const StreamlinedSpan&) noexcept = default;
+
+    // Shifted views of one buffer may overlap, so copy from the end when the
+    // destination starts after the source.
+    constexpr StreamlinedSpan& operator=(const StreamlinedSpan& rhs) {
+        if (std::less<const T*>{}(rhs.data_, data_)) {
+            std::copy_backward(rhs.data_, rhs.data_ + N, data_ + N);
+        } else {
+            std::copy_n(rhs.data_, N, data_);
+        }
+        return *this;
+    }
+
+    constexpr StreamlinedSpan& operator=(const StreamlinedVector<T, N>& rhs) {
+        std::copy_n(rhs.data.data(), N, data_);
+        return *this;
+    }
+
+    template <typename E, EnableIfStreamlinedExpr<E> = 0>
+    constexpr StreamlinedSpan& operator=(E&& expr) {
+        assert(expr.size() == N && "StreamlinedSpan size mismatch in expression");
+        if constexpr (std::is_lvalue_reference_v<E> || std::is_const_v<std::remove_reference_t<E>>) {
+            detail::evaluate_into<false>(data_, N, expr);
+        } else {
+            detail::evaluate_into<true>(data_, N, expr);
+        }
+        return *this;
+    }
+
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr T* data() const noexcept { return data_; }
+
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + N; }
+
+    constexpr T& operator[](std::size_t index) const noexcept { return data_[index]; }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedSpan& operator+=(const V& operand) {
+        detail::compound_assign_operand<detail::AddOp>(data_, N, operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedSpan& operator-=(const V& operand) {
+        detail::compound_assign_operand<detail::SubOp>(data_, N, operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedSpan& operator*=(const V& operand) {
+        detail::compound_assign_operand<detail::MulOp>(data_, N, operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedSpan& operator/=(const V& operand) {
+        detail::compound_assign_operand<detail::DivOp>(data_, N, operand);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    constexpr StreamlinedSpan& operator+=(S scalar) {
+        detail::compound_assign_scalar<detail::AddOp>(data_, N, scalar);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    constexpr StreamlinedSpan& operator-=(S scalar) {
+        detail::compound_assign_scalar<detail::SubOp>(data_, N, scalar);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    constexpr StreamlinedSpan& operator*=(S scalar) {
+        detail::compound_assign_scalar<detail::MulOp>(data_, N, scalar);
+        return *this;
+    }
+
+    template <typename S, EnableIfArithmetic<S> = 0>
+    constexpr StreamlinedSpan& operator/=(S scalar) {
+        detail::compound_assign_scalar<detail::DivOp>(data_, N, scalar);
+        return *this;
+    }
+
+    constexpr StreamlinedVector<T, N> to_vector() const {
+        StreamlinedVector<T, N> out{};
+        std::copy_n(data_, N, out.data.data());
+        return out;
+    }
+
+    constexpr bool operator==(const StreamlinedVector<T, N>& rhs) const {
+        return std::equal(data_, data_ + N, rhs.begin());
+    }
+    constexpr bool operator!=(const StreamlinedVector<T, N>& rhs) const { return !(*this == rhs); }
+
+    void print(std::ostream& os) const {
+        os << "{";
+        for (std::size_t i = 0; i < N; ++i) {
+            os << (i == 0 ? "" : ", ") << data_[i];
+        }
+        os << "}";
+    }
+
+private:
+    T* data_;
+};
+
+namespace detail {
+    template <typename T, std::size_t N>
+    struct StreamlinedContainerTraits<StreamlinedSpan<T, N>> {
+        static constexpr bool value = true;
+        static constexpr bool is_view = true;
+        using value_type = T;
+        static constexpr std::size_t extent = N;
+
+        static constexpr const T* data(const StreamlinedSpan<T, N>& v) noexcept { return v.data(); }
+        static constexpr T* data(StreamlinedSpan<T, N>& v) noexcept { return v.data(); }
+        static constexpr std::size_t size(const StreamlinedSpan<T, N>&) noexcept { return N; }
+    };
+} // namespace detail
+
+} // namespace hot_utils
@@ -2,16 +2,16 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <iterator>
 #include <ostream>
 #include <type_traits>
 #include <utility>
 
-namespace hot_utils {
+#include "hot_utils/streamlined_expr.hpp"
 
-template <typename S>
-using EnableIfArithmetic = std::enable_if_t<std::is_arithmetic_v<std::decay_t<S>>, int>;
+namespace hot_utils {
 
 template <typename T, std::size_t N>
 struct StreamlinedVector final {
@@ -33,6 +33,10 @@ struct StreamlinedVector final {
     constexpr const T& operator[](std::size_t index) const noexcept { return data[index]; }
 
     constexpr StreamlinedVector& operator+=(const StreamlinedVector& rhs) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply<detail::AddOp>(data.data(), rhs.data.data(), N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), rhs.data.begin(), data.begin(), [](T& lhs, const T& rhs_value) {
             lhs += rhs_value;
             return std::move(lhs);
@@ -41,6 +45,10 @@ struct StreamlinedVector final {
     }
 
     constexpr StreamlinedVector& operator-=(const StreamlinedVector& rhs) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply<detail::SubOp>(data.data(), rhs.data.data(), N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), rhs.data.begin(), data.begin(), [](T& lhs, const T& rhs_value) {
             lhs -= rhs_value;
             return std::move(lhs);
@@ -49,6 +57,10 @@ struct StreamlinedVector final {
     }
 
     constexpr StreamlinedVector& operator*=(const StreamlinedVector& rhs) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply<detail::MulOp>(data.data(), rhs.data.data(), N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), rhs.data.begin(), data.begin(), [](T& lhs, const T& rhs_value) {
             lhs *= rhs_value;
             return std::move(lhs);
@@ -57,6 +69,10 @@ struct StreamlinedVector final {
     }
 
     constexpr StreamlinedVector& operator/=(const StreamlinedVector& rhs) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply<detail::DivOp>(data.data(), rhs.data.data(), N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), rhs.data.begin(), data.begin(), [](T& lhs, const T& rhs_value) {
             lhs /= rhs_value;
             return std::move(lhs);
@@ -66,6 +82,10 @@ struct StreamlinedVector final {
 
     template <typename S, EnableIfArithmetic<S> = 0>
     constexpr StreamlinedVector& operator+=(S scalar) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply_broadcast<detail::AddOp>(data.data(), scalar, N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), data.begin(), [scalar](T& value) {
             value += scalar;
             return std::move(value);
@@ -75,6 +95,10 @@ struct StreamlinedVector final {
 
     template <typename S, EnableIfArithmetic<S> = 0>
     constexpr StreamlinedVector& operator-=(S scalar) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply_broadcast<detail::SubOp>(data.data(), scalar, N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), data.begin(), [scalar](T& value) {
             value -= scalar;
             return std::move(value);
@@ -84,6 +108,10 @@ struct StreamlinedVector final {
 
     template <typename S, EnableIfArithmetic<S> = 0>
     constexpr StreamlinedVector& operator*=(S scalar) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply_broadcast<detail::MulOp>(data.data(), scalar, N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), data.begin(), [scalar](T& value) {
             value *= scalar;
             return std::move(value);
@@ -93,6 +121,10 @@ struct StreamlinedVector final {
 
     template <typename S, EnableIfArithmetic<S> = 0>
     constexpr StreamlinedVector& operator/=(S scalar) {
+        if (detail::simd::use_kernels<T>(N)) {
+            detail::simd::apply_broadcast<detail::DivOp>(data.data(), scalar, N);
+            return *this;
+        }
         std::transform(data.begin(), data.end(), data.begin(), [scalar](T& value) {
             value /= scalar;
             return std::move(value);
@@ -100,6 +132,44 @@ struct StreamlinedVector final {
         return *this;
     }
 
+    // Evaluates a whole expression in one pass, writing straight into data.
+    template <typename E, EnableIfStreamlinedExpr<E> = 0>
+    constexpr StreamlinedVector& operator=(E&& expr) {
+        static_assert(std::decay_t<E>::extent == N || std::decay_t<E>::extent == kDynamicExtent,
+            "StreamlinedVector extent mismatch in expression");
+        assert(expr.size() == N && "StreamlinedVector size mismatch in expression");
+        if constexpr (std::is_lvalue_reference_v<E> || std::is_const_v<std::remove_reference_t<E>>) {
+            detail::evaluate_into<false>(data.data(), N, expr);
+        } else {
+            detail::evaluate_into<true>(data.data(), N, expr);
+        }
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedVector& operator+=(const V& operand) {
+        detail::compound_assign_operand<detail::AddOp>(data.data(), N, operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedVector& operator-=(const V& operand) {
+        detail::compound_assign_operand<detail::SubOp>(data.data(), N, operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedVector& operator*=(const V& operand) {
+        detail::compound_assign_operand<detail::MulOp>(data.data(), N, operand);
+        return *this;
+    }
+
+    template <typename V, EnableIfStreamlinedOperand<V> = 0>
+    constexpr StreamlinedVector& operator/=(const V& operand) {
+        detail::compound_assign_operand<detail::DivOp>(data.data(), N, operand);
+        return *this;
+    }
+
     constexpr bool operator==(const StreamlinedVector& rhs) const { return data == rhs.data; }
     constexpr bool operator!=(const StreamlinedVector& rhs) const { return !(*this == rhs); }
 
@@ -113,76 +183,18 @@ struct StreamlinedVector final {
     }
 };
 
-template <typename T, std::size_t N>
-constexpr StreamlinedVector<T, N> operator+(StreamlinedVector<T, N> lhs, const StreamlinedVector<T, N>& rhs) {
-    lhs += rhs;
-    return lhs;
-}
-
-template <typename T, std::size_t N>
-constexpr StreamlinedVector<T, N> operator-(StreamlinedVector<T, N> lhs, const StreamlinedVector<T, N>& rhs) {
-    lhs -= rhs;
-    return lhs;
-}
-
-template <typename T, std::size_t N>
-constexpr StreamlinedVector<T, N> operator*(StreamlinedVector<T, N> lhs, const StreamlinedVector<T, N>& rhs) {
-    lhs *= rhs;
-    return lhs;
-}
-
-template <typename T, std::size_t N>
-constexpr StreamlinedVector<T, N> operator/(StreamlinedVector<T, N> lhs, const StreamlinedVector<T, N>& rhs) {
-    lhs /= rhs;
-    return lhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator+(StreamlinedVector<T, N> lhs, S scalar) {
-    lhs += scalar;
-    return lhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator+(S scalar, StreamlinedVector<T, N> rhs) {
-    rhs += scalar;
-    return rhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator-(StreamlinedVector<T, N> lhs, S scalar) {
-    lhs -= scalar;
-    return lhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator-(S scalar, StreamlinedVector<T, N> rhs) {
-    std::transform(rhs.data.begin(), rhs.data.end(), rhs.data.begin(), [scalar](T& value) { return scalar - value; });
-    return rhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator*(StreamlinedVector<T, N> lhs, S scalar) {
-    lhs *= scalar;
-    return lhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator*(S scalar, StreamlinedVector<T, N> rhs) {
-    rhs *= scalar;
-    return rhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator/(StreamlinedVector<T, N> lhs, S scalar) {
-    lhs /= scalar;
-    return lhs;
-}
-
-template <typename T, std::size_t N, typename S, EnableIfArithmetic<S> = 0>
-constexpr StreamlinedVector<T, N> operator/(S scalar, StreamlinedVector<T, N> rhs) {
-    std::transform(rhs.data.begin(), rhs.data.end(), rhs.data.begin(), [scalar](T& value) { return scalar / value; });
-    return rhs;
-}
+namespace detail {
+    template <typename T, std::size_t N>
+    struct StreamlinedContainerTraits<StreamlinedVector<T, N>> {
+        static constexpr bool value = true;
+        static constexpr bool is_view = false;
+        using value_type = T;
+        static constexpr std::size_t extent = N;
+
+        static constexpr const T* data(const StreamlinedVector<T, N>& v) noexcept { return v.data.data(); }
+        static constexpr T* data(StreamlinedVector<T, N>& v) noexcept { return v.data.data(); }
+        static constexpr std::size_t size(const StreamlinedVector<T, N>&) noexcept { return N; }
+    };
+} // namespace detail
 
 } // namespace hot_utils
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#if defined(__has_include)
+#if __has_include(<dlfcn.h>)
+#include <dlfcn.h>
+#define HOT_UTILS_HAS_DLADDR 1
+#endif
+#endif
+#ifndef HOT_UTILS_HAS_DLADDR
+#define HOT_UTILS_HAS_DLADDR 0
+#endif
+
+#include "hot_utils/log_utils.hpp"
+
+namespace hot_utils {
+namespace detail {
+    // "function" via dladdr and demangle, "module+0xoffset" for symbols the dynamic
+    // symbol table does not export (link executables with -rdynamic to name them).
+    inline std::string symbolize(std::uintptr_t pc) {
+        char buf[32];
+#if HOT_UTILS_HAS_DLADDR
+        Dl_info info{};
+        if (dladdr(reinterpret_cast<void*>(pc), &info) != 0) {
+            if (info.dli_sname != nullptr) {
+                return demangle(info.dli_sname);
+            }
+            std::string_view module = info.dli_fname != nullptr ? info.dli_fname : "?";
+            if (const std::size_t slash = module.rfind('/'); slash != std::string_view::npos) {
+                module.remove_prefix(slash + 1);
+            }
+            std::snprintf(buf, sizeof(buf), "+0x%llx",
+                static_cast<unsigned long long>(pc - reinterpret_cast<std::uintptr_t>(info.dli_fbase)));
+            return std::string(module) + buf;
+        }
+#endif
+        std::snprintf(buf, sizeof(buf), "0x%llx", static_cast<unsigned long long>(pc));
+        return buf;
+    }
+} // namespace detail
+} // namespace hot_utils
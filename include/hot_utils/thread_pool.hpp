@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace hot_utils {
+
+// Fixed-size pool with one task deque per worker. A worker pops its own deque
+// from the back (the most recently split, still cache-warm work) and steals
+// from the front of the other deques (the largest pending ranges) when idle.
+class ThreadPool final {
+public:
+    using Task = std::function<void()>;
+
+    static constexpr std::chrono::milliseconds kIdlePoll{50};
+
+    explicit ThreadPool(std::size_t threads = default_thread_count())
+        : queue_count_(std::max<std::size_t>(threads, 1))
+        , queues_(std::make_unique<WorkQueue[]>(queue_count_)) {
+        workers_.reserve(queue_count_);
+        for (std::size_t i = 0; i < queue_count_; ++i) {
+            workers_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Runs every queued task before joining the workers.
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    static std::size_t default_thread_count() noexcept {
+        const unsigned threads = std::thread::hardware_concurrency();
+        return threads == 0 ? 1 : threads;
+    }
+
+    std::size_t size() const noexcept { return queue_count_; }
+
+    // Tasks submitted from one of this pool's workers stay on its own deque;
+    // other threads spread them round-robin.
+    void submit(Task task) {
+        const auto& self = this_worker();
+        const std::size_t index = self.pool == this ? self.index
+                                                    : next_queue_.fetch_add(1, std::memory_order_relaxed) % queue_count_;
+        // Counted before it is visible so a thief can never take pending_ below zero.
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(queues_[index].mutex);
+            queues_[index].tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+        }
+        wake_.notify_one();
+    }
+
+    // Runs one queued task on the calling thread. Returns false when every deque is empty.
+    bool run_pending_task() {
+        Task task;
+        if (!take_task(task)) {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+    // Calls body(begin, end) over [0, count) in ranges of at most grain items and
+    // returns once all of them finished. Ranges are split in halves on demand, so
+    // idle workers steal large pieces and the calling thread works alongside them.
+    // The first exception thrown by body is rethrown here.
+    template <typename F>
+    void parallel_for(std::size_t count, std::size_t grain, F&& body) {
+        if (count == 0) {
+            return;
+        }
+        ForState<std::remove_reference_t<F>> state(body, std::max<std::size_t>(grain, 1), count);
+        split_range(state, 0, count);
+        while (state.remaining.load(std::memory_order_acquire) != 0) {
+            if (!run_pending_task()) {
+                std::this_thread::yield();
+            }
+        }
+        if (state.error) {
+            std::rethrow_exception(state.error);
+        }
+    }
+
+private:
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct WorkerIdentity {
+        const ThreadPool* pool = nullptr;
+        std::size_t index = 0;
+    };
+
+    template <typename F>
+    struct ForState {
+        ForState(F& body_, std::size_t grain_, std::size_t count)
+            : body(body_)
+            , grain(grain_)
+            , remaining(count) {}
+
+        F& body;
+        std::size_t grain;
+        std::atomic<std::size_t> remaining;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    static WorkerIdentity& this_worker() noexcept {
+        thread_local WorkerIdentity identity;
+        return identity;
+    }
+
+    template <typename State>
+    void split_range(State& state, std::size_t begin, std::size_t end) {
+        while (end - begin > state.grain) {
+            const std::size_t middle = begin + (end - begin) / 2;
+            submit([this, &state, middle, end] { split_range(state, middle, end); });
+            end = middle;
+        }
+        try {
+            state.body(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state.error_mutex);
+            if (!state.error) {
+                state.error = std::current_exception();
+            }
+        }
+        // Last touch of state: the waiting thread may return as soon as this reaches zero.
+        state.remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+    }
+
+    bool pop_back(std::size_t index, Task& task) {
+        auto& queue = queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal_front(std::size_t index, Task& task) {
+        auto& queue = queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    bool take_task(Task& task) {
+        if (pending_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        const auto& self = this_worker();
+        const bool is_worker = self.pool == this;
+        const std::size_t home = is_worker ? self.index : next_queue_.load(std::memory_order_relaxed) % queue_count_;
+        bool found = is_worker && pop_back(home, task);
+        for (std::size_t offset = is_worker ? 1 : 0; !found && offset < queue_count_; ++offset) {
+            found = steal_front((home + offset) % queue_count_, task);
+        }
+        if (found) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return found;
+    }
+
+    void worker_loop(std::size_t index) {
+        this_worker() = WorkerIdentity{this, index};
+        Task task;
+        while (true) {
+            if (take_task(task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            // Bounded sleep: a missed notification costs at most one poll interval.
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_.wait_for(
+                lock, kIdlePoll, [this] { return stopping_ || pending_.load(std::memory_order_acquire) != 0; });
+            if (stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    std::size_t queue_count_;
+    std::unique_ptr<WorkQueue[]> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> next_queue_{0};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+// Process-wide pool with one worker per hardware thread, created on first use.
+inline ThreadPool& default_thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace hot_utils
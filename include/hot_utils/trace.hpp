@@ -0,0 +1,396 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hot_utils {
+
+struct TraceOptions {
+    // Written as Chrome Trace Event JSON when the process exits; empty to export manually.
+    std::string output_path = "hot_utils_trace.json";
+    // Events kept per thread; later events are dropped and counted. Applies to threads
+    // that record their first event after the call.
+    std::size_t max_events_per_thread = std::size_t{1} << 18;
+};
+
+namespace detail {
+    inline std::atomic<bool> tracing_on{false};
+
+    // log_call_expr's gate: one relaxed load covers both the call log category and
+    // tracing, so a call site with both off pays for a single load.
+    inline constexpr unsigned kCallGateLog = 1;   // the call category may log at Debug
+    inline constexpr unsigned kCallGateTrace = 2; // tracing is on
+    inline std::atomic<unsigned> call_gate{kCallGateLog};
+
+    inline bool tracing_active() noexcept { return tracing_on.load(std::memory_order_relaxed); }
+
+    inline void set_tracing_on(bool on) noexcept {
+        tracing_on.store(on, std::memory_order_release);
+        if (on) {
+            call_gate.fetch_or(kCallGateTrace, std::memory_order_relaxed);
+        } else {
+            call_gate.fetch_and(~kCallGateTrace, std::memory_order_relaxed);
+        }
+    }
+
+    inline std::uint64_t trace_now_ns() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    // Names are either static strings (name) or copied labels (label, truncated to kLabelBytes).
+    struct TraceEvent {
+        static constexpr std::size_t kLabelBytes = 62;
+
+        std::uint64_t ts_ns;
+        const char* name;
+        const char* category;
+        const char* file;
+        std::int32_t line;
+        char phase;
+        std::uint8_t label_length;
+        char label[kLabelBytes];
+    };
+    static_assert(sizeof(TraceEvent) == 104, "unexpected TraceEvent padding");
+
+    // Written only by its owning thread and read by the exporter. Events live in
+    // fixed chunks that never move, so publishing size_ with release is enough.
+    // Each recorded begin event reserves a slot for its end event, so a full
+    // buffer drops whole spans and the export stays balanced.
+    class TraceBuffer {
+    public:
+        static constexpr std::size_t kChunkEvents = 4096;
+
+        TraceBuffer(std::uint32_t tid, std::size_t capacity, std::uint64_t generation)
+            : tid(tid)
+            , capacity_(capacity)
+            , chunks_(std::make_unique<std::unique_ptr<TraceEvent[]>[]>((capacity + kChunkEvents - 1) / kChunkEvents))
+            , generation_(generation) {}
+
+        // False when there is no room for the event and its end event; both count as dropped.
+        template <typename Fill>
+        bool record_begin(std::uint64_t generation, Fill&& fill) {
+            const std::size_t size = current_size(generation);
+            if (capacity_ - size < open_ + 2) {
+                dropped_.fetch_add(2, std::memory_order_relaxed);
+                return false;
+            }
+            append(size, fill);
+            ++open_;
+            return true;
+        }
+
+        // Uses the slot its begin event reserved. An end event left over from an
+        // earlier session has none and needs a free slot.
+        template <typename Fill>
+        void record_end(std::uint64_t generation, Fill&& fill) {
+            const std::size_t size = current_size(generation);
+            if (open_ != 0) {
+                --open_;
+            } else if (size == capacity_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            append(size, fill);
+        }
+
+        // Whether the owning thread has recorded anything in generation.
+        bool in_session(std::uint64_t generation) const noexcept {
+            return generation == generation_.load(std::memory_order_relaxed);
+        }
+
+        // Events dropped in generation.
+        std::uint64_t dropped(std::uint64_t generation) const noexcept {
+            return in_session(generation) ? dropped_.load(std::memory_order_relaxed) : 0;
+        }
+
+        // Calls visit(event) for every event published in generation.
+        template <typename Visit>
+        void for_each(std::uint64_t generation, Visit&& visit) const {
+            if (!in_session(generation)) {
+                return;
+            }
+            const std::size_t size = size_.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < size; ++i) {
+                visit(chunks_[i / kChunkEvents][i % kChunkEvents]);
+            }
+        }
+
+        const std::uint32_t tid;
+        std::string name; // guarded by the Tracer mutex
+
+    private:
+        std::size_t current_size(std::uint64_t generation) {
+            if (generation != generation_.load(std::memory_order_relaxed)) {
+                generation_.store(generation, std::memory_order_relaxed);
+                size_.store(0, std::memory_order_relaxed);
+                open_ = 0;
+                dropped_.store(0, std::memory_order_relaxed);
+            }
+            return size_.load(std::memory_order_relaxed);
+        }
+
+        template <typename Fill>
+        void append(std::size_t size, Fill& fill) {
+            auto& chunk = chunks_[size / kChunkEvents];
+            if (!chunk) {
+                chunk.reset(new TraceEvent[kChunkEvents]);
+            }
+            fill(chunk[size % kChunkEvents]);
+            size_.store(size + 1, std::memory_order_release);
+        }
+
+        const std::size_t capacity_;
+        std::unique_ptr<std::unique_ptr<TraceEvent[]>[]> chunks_;
+        std::atomic<std::size_t> size_{0};
+        std::atomic<std::uint64_t> generation_;
+        std::atomic<std::uint64_t> dropped_{0};
+        std::size_t open_ = 0; // begin events whose end event is still to come
+    };
+
+    inline void write_json_string(std::FILE* out, std::string_view text) {
+        std::fputc('"', out);
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                std::fputc('\\', out);
+                std::fputc(c, out);
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                std::fprintf(out, "\\u%04x", static_cast<unsigned>(c));
+            } else {
+                std::fputc(c, out);
+            }
+        }
+        std::fputc('"', out);
+    }
+
+    // Owns every thread's buffer, including those of threads that exited during the
+    // current session, and writes them out on request or at process exit.
+    class Tracer {
+    public:
+        static Tracer& instance() {
+            static Tracer tracer;
+            return tracer;
+        }
+
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+        ~Tracer() {
+            set_tracing_on(false);
+            if (!output_path_.empty()) {
+                write(output_path_.c_str());
+            }
+        }
+
+        // Discards events from earlier sessions. Threads still inside a traced
+        // scope from before the call produce unmatched end events.
+        void start(const TraceOptions& options) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            output_path_ = options.output_path;
+            capacity_.store(std::max<std::size_t>(options.max_events_per_thread, 1), std::memory_order_relaxed);
+            origin_ns_.store(trace_now_ns(), std::memory_order_relaxed);
+            const std::uint64_t generation = generation_.fetch_add(1, std::memory_order_relaxed) + 1;
+            prune_exited_threads(generation);
+            set_tracing_on(true);
+        }
+
+        void stop() { set_tracing_on(false); }
+
+        // False when the buffer is full; the caller then skips end().
+        bool begin(const char* name, std::string_view label, const char* category, const char* file, int line) {
+            const std::uint64_t ts = trace_now_ns();
+            return this_thread_buffer().record_begin(generation_.load(std::memory_order_relaxed), [&](TraceEvent& event) {
+                event.ts_ns = ts;
+                event.name = name;
+                event.category = category;
+                event.file = file;
+                event.line = line;
+                event.phase = 'B';
+                event.label_length = static_cast<std::uint8_t>(std::min(label.size(), TraceEvent::kLabelBytes));
+                std::memcpy(event.label, label.data(), event.label_length);
+            });
+        }
+
+        void end() {
+            const std::uint64_t ts = trace_now_ns();
+            this_thread_buffer().record_end(generation_.load(std::memory_order_relaxed), [ts](TraceEvent& event) {
+                event.ts_ns = ts;
+                event.phase = 'E';
+            });
+        }
+
+        void name_thread(std::string_view name) {
+            TraceBuffer& buffer = this_thread_buffer();
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffer.name = std::string(name);
+        }
+
+        // Events are written per thread in recording order, with timestamps in
+        // microseconds since start_tracing(). Threads that recorded nothing in the
+        // session are left out unless they were named.
+        void write(std::FILE* out) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const std::uint64_t generation = generation_.load(std::memory_order_relaxed);
+            prune_exited_threads(generation);
+            const std::uint64_t origin = origin_ns_.load(std::memory_order_relaxed);
+            std::uint64_t dropped = 0;
+            bool first = true;
+            const auto separator = [&] {
+                std::fputs(first ? "\n" : ",\n", out);
+                first = false;
+            };
+            std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+            for (const auto& buffer : buffers_) {
+                if (!buffer->in_session(generation) && buffer->name.empty()) {
+                    continue;
+                }
+                separator();
+                std::fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                    static_cast<unsigned>(buffer->tid));
+                write_json_string(out,
+                    buffer->name.empty() ? "thread " + std::to_string(buffer->tid) : buffer->name);
+                std::fputs("}}", out);
+                buffer->for_each(generation, [&](const TraceEvent& event) {
+                    const std::uint64_t ts = event.ts_ns > origin ? event.ts_ns - origin : 0;
+                    separator();
+                    std::fprintf(out, "{\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":1,\"tid\":%u", event.phase,
+                        static_cast<unsigned long long>(ts / 1000), static_cast<unsigned>(ts % 1000),
+                        static_cast<unsigned>(buffer->tid));
+                    if (event.phase == 'B') {
+                        std::fputs(",\"name\":", out);
+                        write_json_string(out,
+                            event.name != nullptr ? std::string_view(event.name)
+                                                  : std::string_view(event.label, event.label_length));
+                        std::fputs(",\"cat\":", out);
+                        write_json_string(out, event.category);
+                        if (event.file != nullptr) {
+                            std::fputs(",\"args\":{\"file\":", out);
+                            write_json_string(out, event.file);
+                            std::fprintf(out, ",\"line\":%d}", static_cast<int>(event.line));
+                        }
+                    }
+                    std::fputc('}', out);
+                });
+                dropped += buffer->dropped(generation);
+            }
+            std::fprintf(out, "\n],\"otherData\":{\"dropped_events\":%llu}}\n", static_cast<unsigned long long>(dropped));
+            std::fflush(out);
+        }
+
+        bool write(const char* path) {
+            std::FILE* out = std::fopen(path, "w");
+            if (out == nullptr) {
+                return false;
+            }
+            write(out);
+            return std::fclose(out) == 0;
+        }
+
+    private:
+        Tracer() = default;
+
+        TraceBuffer& this_thread_buffer() {
+            thread_local std::shared_ptr<TraceBuffer> buffer;
+            if (!buffer) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                buffer = std::make_shared<TraceBuffer>(++last_tid_,
+                    capacity_.load(std::memory_order_relaxed), generation_.load(std::memory_order_relaxed));
+                buffers_.push_back(buffer);
+            }
+            return *buffer;
+        }
+
+        // Drops the buffers of exited threads that hold nothing from generation. Only
+        // buffers_ still shares a buffer once its thread's thread_local is destroyed.
+        // Called with mutex_ held.
+        void prune_exited_threads(std::uint64_t generation) {
+            buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+                               [generation](const std::shared_ptr<TraceBuffer>& buffer) {
+                                   return buffer.use_count() == 1 && !buffer->in_session(generation);
+                               }),
+                buffers_.end());
+        }
+
+        std::mutex mutex_;
+        std::string output_path_;
+        std::atomic<std::size_t> capacity_{std::size_t{1} << 18};
+        std::atomic<std::uint64_t> origin_ns_{0};
+        std::atomic<std::uint64_t> generation_{0};
+        std::vector<std::shared_ptr<TraceBuffer>> buffers_;
+        std::uint32_t last_tid_ = 0;
+    };
+
+    // Begin event on construction and the matching end event on destruction, when
+    // tracing. A null name disables the span.
+    class TraceSpan {
+    public:
+        TraceSpan(const char* name, const char* category, const char* file = nullptr, int line = 0)
+            : active_(name != nullptr && tracing_active() && Tracer::instance().begin(name, {}, category, file, line)) {}
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+        ~TraceSpan() {
+            if (active_) {
+                Tracer::instance().end();
+            }
+        }
+
+    private:
+        bool active_;
+    };
+} // namespace detail
+
+// Records begin/end events from HOT_UTILS_LOG_CALL, ScopedTimer and TraceScope into
+// per-thread buffers, independently of the log levels. Open the exported file in
+// Perfetto (ui.perfetto.dev) or chrome://tracing.
+inline void start_tracing(const TraceOptions& options = {}) {
+    detail::Tracer::instance().start(options);
+}
+
+// Stops recording; the events stay available to write_chrome_trace and the exit-time export.
+inline void stop_tracing() {
+    detail::Tracer::instance().stop();
+}
+
+inline bool tracing_enabled() noexcept {
+    return detail::tracing_active();
+}
+
+// Label for the calling thread's track in the exported timeline.
+inline void set_trace_thread_name(std::string_view name) {
+    detail::Tracer::instance().name_thread(name);
+}
+
+// Writes the current session as Chrome Trace Event JSON. Call after stop_tracing()
+// or while traced threads are idle; events recorded during the write may be missed.
+inline void write_chrome_trace(std::FILE* out) {
+    detail::Tracer::instance().write(out);
+}
+
+inline bool write_chrome_trace(const char* path) {
+    return detail::Tracer::instance().write(path);
+}
+
+// Traces the enclosing scope under a static name, e.g. TraceScope scope("decode");
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, const char* category = "scope")
+        : span_(name, category) {}
+
+private:
+    detail::TraceSpan span_;
+};
+
+} // namespace hot_utils
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#define HOT_UTILS_HAS_TSC 1
+#else
+#define HOT_UTILS_HAS_TSC 0
+#endif
+
+namespace hot_utils {
+
+struct TscClockInfo {
+    bool invariant_tsc = false; // CPUID reports a constant-rate TSC that keeps ticking in idle states
+    bool uses_tsc = false;      // false: TscClock forwards to steady_clock
+    double ticks_per_ns = 0.0;
+};
+
+namespace detail {
+    // Length of the calibration window; spent once, on the first TscClock::now().
+    inline constexpr std::chrono::milliseconds kTscCalibrationWindow{5};
+
+    inline std::uint64_t steady_now_ns() noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+#if HOT_UTILS_HAS_TSC
+    // The fences keep the read from drifting into the timed region in either direction.
+    inline std::uint64_t read_tsc() noexcept {
+        _mm_lfence();
+        const std::uint64_t ticks = __rdtsc();
+        _mm_lfence();
+        return ticks;
+    }
+
+    inline bool cpu_has_invariant_tsc() noexcept {
+        unsigned eax = 0;
+        unsigned ebx = 0;
+        unsigned ecx = 0;
+        unsigned edx = 0;
+        if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) {
+            return false;
+        }
+        __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+        return (edx & (1u << 8)) != 0;
+    }
+
+    // A steady_clock reading paired with the TSC value taken at the same moment,
+    // bracketed by two TSC reads; the tightest bracket of a few tries wins.
+    struct TscSample {
+        std::uint64_t ticks;
+        std::uint64_t ns;
+    };
+
+    inline TscSample sample_tsc() noexcept {
+        TscSample best{0, 0};
+        std::uint64_t best_width = ~std::uint64_t{0};
+        for (int i = 0; i < 8; ++i) {
+            const std::uint64_t before = read_tsc();
+            const std::uint64_t ns = steady_now_ns();
+            const std::uint64_t after = read_tsc();
+            if (after - before < best_width) {
+                best_width = after - before;
+                best = TscSample{before + (after - before) / 2, ns};
+            }
+        }
+        return best;
+    }
+#endif
+
+    // ns = base_ns + ((ticks - base_ticks) * mult) >> 32
+    struct TscCalibration {
+        TscClockInfo info;
+        std::uint64_t base_ticks = 0;
+        std::uint64_t base_ns = 0;
+        std::uint64_t mult = 0;
+    };
+
+    inline TscCalibration calibrate_tsc() noexcept {
+        TscCalibration calibration;
+#if HOT_UTILS_HAS_TSC
+        calibration.info.invariant_tsc = cpu_has_invariant_tsc();
+        if (!calibration.info.invariant_tsc) {
+            return calibration;
+        }
+        const TscSample start = sample_tsc();
+        while (steady_now_ns() - start.ns < static_cast<std::uint64_t>(
+                   std::chrono::nanoseconds(kTscCalibrationWindow).count())) {
+        }
+        const TscSample end = sample_tsc();
+        if (end.ticks <= start.ticks || end.ns <= start.ns) {
+            return calibration;
+        }
+        const double ns_per_tick = static_cast<double>(end.ns - start.ns) / static_cast<double>(end.ticks - start.ticks);
+        calibration.info.uses_tsc = true;
+        calibration.info.ticks_per_ns = 1.0 / ns_per_tick;
+        calibration.base_ticks = end.ticks;
+        calibration.base_ns = end.ns;
+        calibration.mult = static_cast<std::uint64_t>(ns_per_tick * 4294967296.0);
+#endif
+        return calibration;
+    }
+
+    inline const TscCalibration& tsc_calibration() noexcept {
+        static const TscCalibration calibration = calibrate_tsc();
+        return calibration;
+    }
+} // namespace detail
+
+// ScopedTimer clock backed by the time-stamp counter: a fenced rdtsc scaled to nanoseconds, calibrated against steady_clock
+// on first use. Falls back to steady_clock when the TSC is not invariant, so
+// readings are always monotonic and comparable with steady_clock's epoch.
+struct TscClock {
+    using rep = std::int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<TscClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        const auto& calibration = detail::tsc_calibration();
+#if HOT_UTILS_HAS_TSC
+        if (calibration.info.uses_tsc) {
+            // Signed: another core's counter may sit a few ticks behind the calibration point.
+            const auto ticks = static_cast<std::int64_t>(detail::read_tsc() - calibration.base_ticks);
+            const auto scaled = static_cast<rep>(__extension__(static_cast<__int128>(ticks) * calibration.mult) >> 32);
+            return time_point(duration(static_cast<rep>(calibration.base_ns) + scaled));
+        }
+#endif
+        return time_point(duration(static_cast<rep>(detail::steady_now_ns())));
+    }
+
+    static TscClockInfo info() noexcept { return detail::tsc_calibration().info; }
+};
+
+// Smallest observed cost of one Clock::now() call, measured back to back.
+// Subtract it from very short measurements to remove the timer's own cost.
+template <class Clock>
+std::chrono::nanoseconds measure_clock_overhead(std::size_t rounds = 1000) {
+    Clock::now(); // pays for any one-time calibration outside the measurement
+    auto best = std::chrono::nanoseconds::max();
+    for (std::size_t i = 0; i < rounds; ++i) {
+        const auto first = Clock::now();
+        const auto second = Clock::now();
+        best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(second - first));
+    }
+    return std::max(best, std::chrono::nanoseconds(0));
+}
+
+// measure_clock_overhead<Clock>(), measured once per process.
+template <class Clock>
+std::chrono::nanoseconds clock_overhead() {
+    static const std::chrono::nanoseconds overhead = measure_clock_overhead<Clock>();
+    return overhead;
+}
+
+} // namespace hot_utils
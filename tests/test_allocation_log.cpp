@@ -0,0 +1,159 @@
+#include "gtest/gtest-spi.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hot_utils/allocation_log.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+
+// The whole test binary runs on the hooks; outside a scope they only forward to malloc.
+HOT_UTILS_DEFINE_ALLOCATION_HOOKS()
+
+namespace {
+
+struct CaptureAllocationLogger {
+    hot_utils::AllocationStats* stats;
+    std::size_t* sites;
+
+    void operator()(std::string_view, const hot_utils::AllocationStats& recorded, const hot_utils::AllocationSite*,
+        std::size_t site_count) const {
+        *stats = recorded;
+        *sites = site_count;
+    }
+};
+
+int g_violations = 0;
+
+void count_violation(std::string_view, const hot_utils::AllocationStats&) {
+    ++g_violations;
+}
+
+} // namespace
+
+TEST(AllocationLog, HooksAreInstalled) {
+    EXPECT_TRUE(hot_utils::allocation_hooks_installed());
+}
+
+TEST(AllocationLog, CountsAllocationsInScope) {
+    hot_utils::AllocationStats stats;
+    std::size_t sites = 0;
+    auto* outside = new int(1);
+    {
+        hot_utils::ScopedAllocationLog<CaptureAllocationLogger> log("scope", {}, CaptureAllocationLogger{&stats, &sites});
+        auto small = std::make_unique<char[]>(10);
+        auto large = std::make_unique<char[]>(1000);
+        hot_utils::do_not_optimize(small.get());
+        hot_utils::do_not_optimize(large.get());
+        EXPECT_EQ(log.stats().allocations, 2u);
+        delete outside;
+    }
+    EXPECT_EQ(stats.allocations, 2u);
+    EXPECT_EQ(stats.deallocations, 3u);
+    EXPECT_EQ(stats.bytes_allocated, 1010u);
+    EXPECT_EQ(stats.size_classes[0], 1u); // <= 16
+    EXPECT_EQ(stats.size_classes[6], 1u); // <= 1024
+    if (hot_utils::kAllocationLiveBytes) {
+        EXPECT_GE(stats.peak_live_bytes, 1010);
+        EXPECT_LT(stats.live_bytes, 0); // freed more than it allocated
+    }
+    EXPECT_EQ(sites, 0u);
+}
+
+TEST(AllocationLog, NestedScopesSeeInnerAllocations) {
+    hot_utils::AllocationStats outer_stats;
+    hot_utils::AllocationStats inner_stats;
+    std::size_t sites = 0;
+    {
+        hot_utils::ScopedAllocationLog<CaptureAllocationLogger> outer("outer", {}, CaptureAllocationLogger{&outer_stats, &sites});
+        std::vector<int> kept(100);
+        {
+            hot_utils::ScopedAllocationLog<CaptureAllocationLogger> inner(
+                "inner", {}, CaptureAllocationLogger{&inner_stats, &sites});
+            std::string text(100, 'x');
+            hot_utils::do_not_optimize(text.data());
+        }
+        hot_utils::do_not_optimize(kept.data());
+    }
+    EXPECT_EQ(inner_stats.allocations, 1u);
+    EXPECT_EQ(inner_stats.live_bytes, 0);
+    EXPECT_EQ(outer_stats.allocations, 2u);
+    EXPECT_EQ(outer_stats.live_bytes, 0);
+    if (hot_utils::kAllocationLiveBytes) {
+        EXPECT_GE(outer_stats.peak_live_bytes, 500);
+    }
+}
+
+TEST(AllocationLog, RecordsAllocatingSites) {
+    hot_utils::AllocationStats stats;
+    std::size_t sites = 0;
+    {
+        hot_utils::AllocationLogOptions options;
+        options.record_sites = true;
+        hot_utils::ScopedAllocationLog<CaptureAllocationLogger> log("sites", options, CaptureAllocationLogger{&stats, &sites});
+        for (int i = 0; i < 4; ++i) {
+            auto value = std::make_unique<double>(i);
+            hot_utils::do_not_optimize(value.get());
+        }
+        std::vector<char> buffer(64);
+        hot_utils::do_not_optimize(buffer.data());
+    }
+    EXPECT_EQ(stats.allocations, 5u);
+    EXPECT_GE(sites, 1u);
+    EXPECT_LE(sites, 5u);
+}
+
+TEST(AllocationLog, TrackingAllocatorReportsWithoutHooks) {
+    hot_utils::AllocationStats stats;
+    std::size_t sites = 0;
+    {
+        hot_utils::ScopedAllocationLog<CaptureAllocationLogger> log("vector", {}, CaptureAllocationLogger{&stats, &sites});
+        std::vector<int, hot_utils::TrackingAllocator<int>> values;
+        values.reserve(32);
+        values.resize(32);
+    }
+    // Counted once although the global hooks are installed too.
+    EXPECT_EQ(stats.allocations, 1u);
+    EXPECT_EQ(stats.bytes_allocated, 32 * sizeof(int));
+    EXPECT_EQ(stats.live_bytes, 0);
+}
+
+TEST(AllocationLog, NoAllocationScopeCallsHandler) {
+    g_violations = 0;
+    {
+        hot_utils::NoAllocationScope scope("quiet", &count_violation);
+        int local = 1;
+        hot_utils::do_not_optimize(local);
+    }
+    EXPECT_EQ(g_violations, 0);
+    {
+        hot_utils::NoAllocationScope scope("noisy", &count_violation);
+        auto value = std::make_unique<int>(1);
+        hot_utils::do_not_optimize(value.get());
+    }
+    EXPECT_EQ(g_violations, 1);
+}
+
+TEST(AllocationLog, NoAllocationScopeFailsTheTest) {
+    EXPECT_NONFATAL_FAILURE(
+        {
+            hot_utils::NoAllocationScope scope("hot loop");
+            auto value = std::make_unique<int>(1);
+            hot_utils::do_not_optimize(value.get());
+        },
+        "unexpected heap allocation: hot loop: 1 allocations");
+}
+
+TEST(AllocationLog, FormatsSizeClasses) {
+    hot_utils::AllocationStats stats;
+    stats.allocations = 3;
+    stats.bytes_allocated = 10'000'000;
+    stats.size_classes[1] = 2;
+    stats.size_classes[hot_utils::kAllocationSizeClasses - 1] = 1;
+    const std::string line = hot_utils::detail::format_allocation_stats("x", stats);
+    EXPECT_NE(line.find("x: 3 allocations, 10000000 bytes"), std::string::npos) << line;
+    EXPECT_NE(line.find("<=32:2"), std::string::npos) << line;
+    EXPECT_NE(line.find(">4194304:1"), std::string::npos) << line;
+}
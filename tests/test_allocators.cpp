@@ -0,0 +1,193 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include "hot_utils/allocators.hpp"
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace {
+
+struct NullAllocationLogger {
+    void operator()(std::string_view, const hot_utils::AllocationStats&, const hot_utils::AllocationSite*,
+        std::size_t) const {}
+};
+
+bool aligned_to(const void* ptr, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+} // namespace
+
+TEST(MonotonicArena, BumpsAndAligns) {
+    hot_utils::MonotonicArena<hot_utils::AllocatorStats> arena(1024);
+    auto* first = static_cast<char*>(arena.allocate(3, 1));
+    auto* second = static_cast<char*>(arena.allocate(8, 8));
+    auto* wide = arena.allocate(64, 64);
+    EXPECT_EQ(second, first + 8);
+    EXPECT_TRUE(aligned_to(wide, 64));
+    EXPECT_EQ(arena.bytes_allocated(), 75u);
+    EXPECT_EQ(arena.stats().allocations, 3u);
+    EXPECT_EQ(arena.stats().upstream_allocations, 1u);
+}
+
+TEST(MonotonicArena, RewindReusesMemory) {
+    hot_utils::MonotonicArena<hot_utils::AllocatorStats> arena(256);
+    arena.allocate(16);
+    const auto mark = arena.mark();
+    void* scratch = arena.allocate(100);
+    arena.allocate(1000); // spills into a second chunk
+    EXPECT_EQ(arena.stats().upstream_allocations, 2u);
+
+    arena.rewind(mark);
+    EXPECT_EQ(arena.bytes_allocated(), 16u);
+    EXPECT_EQ(arena.stats().bytes_in_use, 16);
+    EXPECT_EQ(arena.allocate(100), scratch);
+    arena.allocate(1000);
+    EXPECT_EQ(arena.stats().upstream_allocations, 2u);
+    EXPECT_EQ(arena.stats().peak_bytes_in_use, 1116);
+}
+
+TEST(MonotonicArena, ResetKeepsChunks) {
+    hot_utils::MonotonicArena<hot_utils::AllocatorStats> arena(256);
+    void* first = arena.allocate(200);
+    arena.allocate(200);
+    const std::size_t capacity = arena.capacity();
+    arena.reset();
+    EXPECT_EQ(arena.allocate(200), first);
+    arena.allocate(200);
+    EXPECT_EQ(arena.capacity(), capacity);
+    EXPECT_EQ(arena.stats().rewinds, 1u);
+
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 0u);
+    EXPECT_NE(arena.allocate(8), nullptr);
+}
+
+TEST(ArenaAllocator, BacksContainersOfLoggedElements) {
+    hot_utils::MonotonicArena<> arena;
+    using Element = hot_utils::CopyMoveLog<int>;
+    std::vector<Element, hot_utils::ArenaAllocator<Element>> values{hot_utils::ArenaAllocator<Element>(arena)};
+    for (int i = 0; i < 100; ++i) {
+        values.emplace_back(i);
+    }
+    EXPECT_EQ(values.back().value(), 99);
+    EXPECT_GE(arena.bytes_allocated(), 100 * sizeof(Element));
+
+    using Vec = hot_utils::StreamlinedVector<float, 8>;
+    std::list<Vec, hot_utils::ArenaAllocator<Vec>> vectors{hot_utils::ArenaAllocator<Vec>(arena)};
+    for (int i = 0; i < 10; ++i) {
+        vectors.emplace_back();
+        EXPECT_TRUE(aligned_to(&vectors.back(), alignof(Vec)));
+    }
+}
+
+TEST(FixedBlockPool, ReusesFreedBlocks) {
+    hot_utils::FixedBlockPool<hot_utils::AllocatorStats> pool(24, 8, 1024);
+    EXPECT_EQ(pool.block_size(), 24u);
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    EXPECT_EQ(static_cast<char*>(b), static_cast<char*>(a) + 24);
+    pool.deallocate(a);
+    EXPECT_EQ(pool.allocate(), a);
+    EXPECT_EQ(pool.stats().bytes_in_use, 48);
+    EXPECT_EQ(pool.slab_count(), 1u);
+}
+
+TEST(FixedBlockPool, HonoursAlignment) {
+    hot_utils::FixedBlockPool<> pool(40, 64);
+    EXPECT_EQ(pool.block_size(), 64u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(aligned_to(pool.allocate(), 64));
+    }
+}
+
+TEST(FixedBlockPool, KeepsOddSizedBlocksAlignedForTheFreeList) {
+    struct Nine {
+        char bytes[9];
+    };
+    static_assert(sizeof(Nine) == 9 && alignof(Nine) == 1);
+    hot_utils::FixedBlockPool<> pool(sizeof(Nine), alignof(Nine));
+    EXPECT_EQ(pool.block_size(), 16u);
+    void* blocks[100];
+    for (auto& block : blocks) {
+        block = pool.allocate();
+        EXPECT_TRUE(aligned_to(block, alignof(void*)));
+    }
+    for (void* block : blocks) {
+        pool.deallocate(block);
+    }
+
+    hot_utils::PoolAllocator<Nine> allocator;
+    Nine* a = allocator.allocate(1);
+    Nine* b = allocator.allocate(1);
+    EXPECT_TRUE(aligned_to(a, alignof(void*)));
+    EXPECT_TRUE(aligned_to(b, alignof(void*)));
+    allocator.deallocate(a, 1);
+    allocator.deallocate(b, 1);
+}
+
+TEST(PoolAllocator, ReusesListNodesWithoutTheHeap) {
+    if (!hot_utils::allocation_hooks_installed()) {
+        GTEST_SKIP() << "allocation hooks not linked";
+    }
+    using Element = hot_utils::CopyMoveLog<int>;
+    std::list<Element, hot_utils::PoolAllocator<Element>> values;
+    for (int i = 0; i < 100; ++i) {
+        values.emplace_back(i);
+    }
+    values.clear();
+    hot_utils::ScopedAllocationLog<NullAllocationLogger> log;
+    for (int i = 0; i < 100; ++i) {
+        values.emplace_back(i);
+    }
+    EXPECT_EQ(log.stats().allocations, 0u);
+    EXPECT_EQ(values.back().value(), 99);
+}
+
+TEST(PoolAllocator, CountsBlocksPerType) {
+    using Allocator = hot_utils::PoolAllocator<std::uint64_t, hot_utils::AllocatorStats>;
+    Allocator allocator;
+    std::uint64_t* a = allocator.allocate(1);
+    std::uint64_t* b = allocator.allocate(1);
+    const auto& stats = Allocator::pool().stats();
+    EXPECT_EQ(stats.allocations, 2u);
+    EXPECT_EQ(stats.upstream_allocations, 1u);
+    allocator.deallocate(a, 1);
+    allocator.deallocate(b, 1);
+    EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(PoolAllocator, SendsArraysToTheHeap) {
+    using Allocator = hot_utils::PoolAllocator<double, hot_utils::AllocatorStats>;
+    std::vector<double, Allocator> values(1000, 1.0);
+    EXPECT_EQ(Allocator::pool().stats().allocations, 0u);
+}
+
+TEST(ArenaResource, BacksPmrContainers) {
+    hot_utils::MonotonicArena<hot_utils::AllocatorStats> arena;
+    hot_utils::ArenaResource<hot_utils::MonotonicArena<hot_utils::AllocatorStats>> resource(arena);
+    std::pmr::list<int> values(&resource);
+    for (int i = 0; i < 10; ++i) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(arena.stats().allocations, 10u);
+}
+
+TEST(InstrumentedResource, CountsUpstreamTraffic) {
+    hot_utils::InstrumentedResource<> resource;
+    {
+        std::pmr::vector<int> values(&resource);
+        values.reserve(100);
+        values.push_back(1);
+        EXPECT_EQ(resource.stats().bytes_in_use, static_cast<std::int64_t>(100 * sizeof(int)));
+    }
+    EXPECT_EQ(resource.stats().allocations, 1u);
+    EXPECT_EQ(resource.stats().deallocations, 1u);
+    EXPECT_EQ(resource.stats().bytes_in_use, 0);
+    EXPECT_EQ(resource.upstream(), std::pmr::get_default_resource());
+}
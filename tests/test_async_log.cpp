@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/async_log.hpp"
+#include "hot_utils/log_utils.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+using test_support::read_lines;
+
+// Routes logging into a temporary file for the lifetime of the fixture.
+class AsyncLog : public ::testing::Test {
+protected:
+    void SetUp() override {
+        out_ = std::tmpfile();
+        ASSERT_NE(out_, nullptr);
+    }
+
+    void TearDown() override {
+        hot_utils::disable_async_logging();
+        std::fclose(out_);
+    }
+
+    hot_utils::AsyncLogOptions options() const {
+        hot_utils::AsyncLogOptions options;
+        options.out = out_;
+        return options;
+    }
+
+    std::FILE* out_ = nullptr;
+};
+
+} // namespace
+
+TEST_F(AsyncLog, WritesLinesAndCallsInPerThreadOrder) {
+    hot_utils::enable_async_logging(options());
+    EXPECT_TRUE(hot_utils::async_logging_enabled());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < 100; ++i) {
+                const std::string msg = "t" + std::to_string(t) + " " + std::to_string(i);
+                hot_utils::detail::log_line("TEST", msg);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    hot_utils::detail::log_call_impl("file.cpp", 7, "func", "expr()", 1);
+    hot_utils::flush_async_log();
+
+    const auto lines = read_lines(out_);
+    ASSERT_EQ(lines.size(), 301u);
+    int next[3] = {0, 0, 0};
+    for (const auto& line : lines) {
+        if (line.rfind("[CALL]", 0) == 0) {
+            EXPECT_EQ(line, "[CALL]   file.cpp:7 func -> expr()");
+            continue;
+        }
+        int t = -1;
+        int i = -1;
+        ASSERT_EQ(std::sscanf(line.c_str(), "[TEST] t%d %d", &t, &i), 2) << line;
+        EXPECT_EQ(i, next[t]++);
+    }
+}
+
+TEST_F(AsyncLog, CountPolicyReportsDroppedRecords) {
+    auto opts = options();
+    opts.ring_capacity = 8;
+    opts.overflow = hot_utils::LogOverflow::Count;
+    opts.drain_interval = std::chrono::hours(1);
+    hot_utils::enable_async_logging(opts);
+    hot_utils::flush_async_log();
+
+    const auto dropped_before = hot_utils::async_log_stats().dropped;
+    // A fresh thread gets a fresh 8-record ring; the drain thread sleeps until flushed.
+    std::thread([] {
+        for (int i = 0; i < 20; ++i) {
+            hot_utils::detail::log_line("TEST", "burst");
+        }
+    }).join();
+    hot_utils::flush_async_log();
+
+    EXPECT_EQ(hot_utils::async_log_stats().dropped - dropped_before, 12u);
+    const auto lines = read_lines(out_);
+    ASSERT_EQ(lines.size(), 9u);
+    EXPECT_EQ(lines.back(), "[LOG] dropped 12 records");
+}
+
+TEST_F(AsyncLog, BlockPolicyLosesNothing) {
+    auto opts = options();
+    opts.ring_capacity = 4;
+    opts.overflow = hot_utils::LogOverflow::Block;
+    opts.drain_interval = std::chrono::microseconds(50);
+    hot_utils::enable_async_logging(opts);
+
+    std::thread([] {
+        for (int i = 0; i < 500; ++i) {
+            hot_utils::detail::log_line("TEST", "steady");
+        }
+    }).join();
+    hot_utils::flush_async_log();
+    EXPECT_EQ(read_lines(out_).size(), 500u);
+}
+
+TEST_F(AsyncLog, DisableRestoresSynchronousLogging) {
+    hot_utils::enable_async_logging(options());
+    hot_utils::detail::log_line("TEST", "queued");
+    hot_utils::disable_async_logging();
+    EXPECT_FALSE(hot_utils::async_logging_enabled());
+    EXPECT_EQ(read_lines(out_).size(), 1u);
+}
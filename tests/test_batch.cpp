@@ -0,0 +1,58 @@
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/batch.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace {
+
+using Vec = hot_utils::StreamlinedVector<float, 16>;
+
+std::vector<Vec> make_vectors(std::size_t count, float scale) {
+    std::vector<Vec> out(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        for (std::size_t j = 0; j < 16; ++j) {
+            out[i][j] = scale * static_cast<float>(i % 31 + j);
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(Batch, AssignEvaluatesExpressionPerVectorInParallel) {
+    hot_utils::ThreadPool pool(3);
+    hot_utils::BatchOptions options;
+    options.pool = &pool;
+    options.serial_threshold_bytes = 0;
+    options.chunk_bytes = 4 * sizeof(Vec);
+
+    auto v = make_vectors(5000, 1.0f);
+    const auto w = make_vectors(5000, 0.5f);
+    const auto original = v;
+    hot_utils::batch_assign(v, [&](std::size_t i) { return v[i] * 2.0f + w[i]; }, options);
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        for (std::size_t j = 0; j < 16; ++j) {
+            EXPECT_EQ(v[i][j], original[i][j] * 2.0f + w[i][j]);
+        }
+    }
+}
+
+TEST(Batch, ApplyPassesEachVectorAndIndex) {
+    auto v = make_vectors(3000, 1.0f);
+    hot_utils::BatchOptions options;
+    options.serial_threshold_bytes = 0;
+    hot_utils::batch_apply(v, [](Vec& vector, std::size_t i) { vector += static_cast<float>(i); }, options);
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(v[i][0], static_cast<float>(i % 31 + i));
+    }
+}
+
+TEST(Batch, SmallBatchesRunOnTheCallingThread) {
+    std::vector<Vec> v(4);
+    const auto caller = std::this_thread::get_id();
+    hot_utils::batch_apply(v, [caller](Vec&, std::size_t) { EXPECT_EQ(std::this_thread::get_id(), caller); });
+}
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "hot_utils/benchmark.hpp"
+#include "test_support.hpp"
+
+namespace {
+hot_utils::BenchmarkOptions fast_options() {
+    hot_utils::BenchmarkOptions options;
+    options.warmup = std::chrono::microseconds(100);
+    options.min_sample_time = std::chrono::microseconds(200);
+    options.samples = 5;
+    return options;
+}
+
+int g_registered_runs = 0;
+
+HOT_UTILS_BENCHMARK(test_registered_increment) {
+    ++g_registered_runs;
+}
+} // namespace
+
+TEST(Benchmark, ComputesStatsOverSamples) {
+    const auto stats = hot_utils::compute_benchmark_stats({4.0, 1.0, 3.0, 2.0, 5.0});
+    EXPECT_DOUBLE_EQ(stats.min, 1.0);
+    EXPECT_DOUBLE_EQ(stats.median, 3.0);
+    EXPECT_DOUBLE_EQ(stats.mean, 3.0);
+    EXPECT_NEAR(stats.stddev, 1.5811388, 1e-6);
+    EXPECT_NEAR(stats.p99, 4.96, 1e-9);
+}
+
+TEST(Benchmark, EmptySamplesYieldZeroStats) {
+    const auto stats = hot_utils::compute_benchmark_stats({});
+    EXPECT_EQ(stats.min, 0.0);
+    EXPECT_EQ(stats.p99, 0.0);
+}
+
+TEST(Benchmark, RunBenchmarkCalibratesIterationsAndCollectsSamples) {
+    std::vector<int> values(64, 1);
+    const auto result = hot_utils::run_benchmark("sum", [&] {
+        int sum = 0;
+        for (const int v : values) {
+            sum += v;
+        }
+        return sum;
+    }, fast_options());
+
+    EXPECT_EQ(result.name, "sum");
+    EXPECT_GT(result.iterations, 1u);
+    ASSERT_EQ(result.samples.size(), 5u);
+    EXPECT_GT(result.stats.mean, 0.0);
+    EXPECT_LE(result.stats.min, result.stats.median);
+    EXPECT_LE(result.stats.median, result.stats.p99);
+}
+
+TEST(Benchmark, RunsRegisteredBenchmarksMatchingFilter) {
+    g_registered_runs = 0;
+    const auto results = hot_utils::run_benchmarks(fast_options(), "test_registered_increment");
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results.front().name, "test_registered_increment");
+    EXPECT_GT(g_registered_runs, 0);
+
+    EXPECT_TRUE(hot_utils::run_benchmarks(fast_options(), "no_such_benchmark").empty());
+}
+
+namespace {
+hot_utils::BenchmarkResult sample_result() {
+    hot_utils::BenchmarkResult result;
+    result.name = "copy, \"quoted\"";
+    result.iterations = 1000;
+    result.samples = {1.5, 2.5};
+    result.stats = hot_utils::compute_benchmark_stats(result.samples);
+    result.counters.push_back(hot_utils::BenchmarkCounter{"bytes", 64.0});
+    return result;
+}
+
+std::string written(void (*write)(const std::vector<hot_utils::BenchmarkResult>&, std::FILE*,
+    const hot_utils::BenchmarkContext&)) {
+    return test_support::capture_output([write](std::FILE* file) {
+        write({sample_result()}, file, hot_utils::BenchmarkContext{"abc123", "Test CPU", "gcc", "2026-01-01T00:00:00Z"});
+    });
+}
+} // namespace
+
+TEST(Benchmark, WritesJsonResults) {
+    const std::string json = written(&hot_utils::write_benchmark_json);
+    EXPECT_NE(json.find("\"git_sha\": \"abc123\", \"cpu_model\": \"Test CPU\""), std::string::npos) << json;
+    EXPECT_NE(json.find("{\"name\": \"copy, \\\"quoted\\\"\", \"iterations\": 1000, \"min_ns\": 1.5"), std::string::npos)
+        << json;
+    EXPECT_NE(json.find("\"samples_ns\": [1.5, 2.5], \"counters\": {\"bytes\": 64}"), std::string::npos) << json;
+}
+
+TEST(Benchmark, WritesCsvResults) {
+    const std::string csv = written(&hot_utils::write_benchmark_csv);
+    EXPECT_EQ(csv.rfind("name,iterations,min_ns,median_ns,mean_ns,stddev_ns,p99_ns,samples_ns,counters,git_sha", 0), 0u)
+        << csv;
+    EXPECT_NE(csv.find("\n\"copy, \"\"quoted\"\"\",1000,1.5,2,2,"), std::string::npos) << csv;
+    EXPECT_NE(csv.find(",1.5;2.5,bytes=64,abc123,Test CPU,gcc,2026-01-01T00:00:00Z\n"), std::string::npos) << csv;
+}
+
+TEST(Benchmark, ContextNamesTheBuild) {
+    const auto context = hot_utils::benchmark_context();
+    EXPECT_FALSE(context.git_sha.empty());
+    EXPECT_FALSE(context.cpu_model.empty());
+    EXPECT_EQ(context.date.size(), 20u);
+}
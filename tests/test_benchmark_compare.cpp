@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "hot_utils/benchmark_compare.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+hot_utils::BenchmarkResult make_result(const std::string& name, std::vector<double> samples) {
+    hot_utils::BenchmarkResult result;
+    result.name = name;
+    result.iterations = 100;
+    result.samples = std::move(samples);
+    result.stats = hot_utils::compute_benchmark_stats(result.samples);
+    return result;
+}
+
+std::vector<double> spread(double center, std::size_t count) {
+    std::vector<double> out;
+    for (std::size_t i = 0; i < count; ++i) {
+        out.push_back(center + static_cast<double>(i % 5) * 0.01 * center);
+    }
+    return out;
+}
+
+hot_utils::BenchmarkReport round_trip(
+    void (*write)(const std::vector<hot_utils::BenchmarkResult>&, std::FILE*, const hot_utils::BenchmarkContext&),
+    const std::vector<hot_utils::BenchmarkResult>& results) {
+    std::FILE* file = test_support::file_with_contents(test_support::capture_output([&](std::FILE* out) {
+        write(results, out, hot_utils::BenchmarkContext{"abc123", "Test CPU, 4 cores", "gcc 12", "2026-01-01T00:00:00Z"});
+    }));
+    hot_utils::BenchmarkReport report;
+    std::string error;
+    EXPECT_TRUE(hot_utils::read_benchmark_results(file, report, &error)) << error;
+    std::fclose(file);
+    return report;
+}
+
+void expect_same_results(const hot_utils::BenchmarkReport& report, const hot_utils::BenchmarkResult& expected) {
+    EXPECT_EQ(report.context.git_sha, "abc123");
+    EXPECT_EQ(report.context.cpu_model, "Test CPU, 4 cores");
+    ASSERT_EQ(report.results.size(), 1u);
+    const auto& result = report.results.front();
+    EXPECT_EQ(result.name, expected.name);
+    EXPECT_EQ(result.iterations, expected.iterations);
+    EXPECT_EQ(result.samples, expected.samples);
+    EXPECT_DOUBLE_EQ(result.stats.median, expected.stats.median);
+    EXPECT_DOUBLE_EQ(result.stats.p99, expected.stats.p99);
+    ASSERT_EQ(result.counters.size(), 1u);
+    EXPECT_EQ(result.counters.front().name, "misses");
+    EXPECT_DOUBLE_EQ(result.counters.front().value, 0.25);
+}
+
+} // namespace
+
+TEST(BenchmarkCompare, ReadsBackJson) {
+    auto result = make_result("push_back, \"reserved\"\n", {10.5, 11.25, 9.75});
+    result.counters.push_back(hot_utils::BenchmarkCounter{"misses", 0.25});
+    expect_same_results(round_trip(&hot_utils::write_benchmark_json, {result}), result);
+}
+
+TEST(BenchmarkCompare, ReadsBackCsv) {
+    auto result = make_result("push_back, \"reserved\"\n", {10.5, 11.25, 9.75});
+    result.counters.push_back(hot_utils::BenchmarkCounter{"misses", 0.25});
+    expect_same_results(round_trip(&hot_utils::write_benchmark_csv, {result}), result);
+}
+
+TEST(BenchmarkCompare, RejectsMalformedJson) {
+    std::FILE* file = test_support::file_with_contents("{\"benchmarks\": [{\"name\": \"x\",]}");
+    hot_utils::BenchmarkReport report;
+    std::string error;
+    EXPECT_FALSE(hot_utils::read_benchmark_results(file, report, &error));
+    EXPECT_NE(error.find("offset"), std::string::npos) << error;
+    std::fclose(file);
+}
+
+TEST(BenchmarkCompare, MannWhitneyMatchesReferenceValues) {
+    // Fully separated sets of five: U = 0, z = -2.507 with continuity correction.
+    const auto separated = hot_utils::mann_whitney_u({1, 2, 3, 4, 5}, {6, 7, 8, 9, 10});
+    EXPECT_DOUBLE_EQ(separated.u, 0.0);
+    EXPECT_NEAR(separated.z, -2.5067, 1e-4);
+    EXPECT_NEAR(separated.p_value, 0.01219, 1e-4);
+
+    // Ties share average ranks and shrink the variance.
+    const auto tied = hot_utils::mann_whitney_u({1, 2, 2, 3}, {2, 3, 3, 4});
+    EXPECT_DOUBLE_EQ(tied.u, 3.0);
+    EXPECT_GT(tied.p_value, 0.05);
+
+    EXPECT_DOUBLE_EQ(hot_utils::mann_whitney_u({1, 1, 1}, {1, 1, 1}).p_value, 1.0);
+    EXPECT_DOUBLE_EQ(hot_utils::mann_whitney_u({1}, {2, 3}).p_value, 1.0);
+}
+
+TEST(BenchmarkCompare, FlagsSignificantSlowdowns) {
+    const std::vector<hot_utils::BenchmarkResult> baseline = {
+        make_result("steady", spread(100.0, 10)), make_result("slower", spread(100.0, 10)),
+        make_result("faster", spread(100.0, 10)), make_result("noise", spread(100.0, 10)),
+        make_result("removed", spread(100.0, 10))};
+    const std::vector<hot_utils::BenchmarkResult> candidate = {make_result("steady", spread(100.0, 10)),
+        make_result("slower", spread(120.0, 10)), make_result("faster", spread(80.0, 10)),
+        make_result("noise", spread(102.0, 10)), make_result("added", spread(100.0, 10))};
+
+    const auto comparisons = hot_utils::compare_benchmark_results(baseline, candidate);
+    ASSERT_EQ(comparisons.size(), 6u);
+    EXPECT_EQ(comparisons[0].verdict, hot_utils::BenchmarkVerdict::Unchanged);
+    EXPECT_EQ(comparisons[1].verdict, hot_utils::BenchmarkVerdict::Regressed);
+    EXPECT_NEAR(comparisons[1].change, 0.2, 1e-9);
+    EXPECT_LT(comparisons[1].p_value, 0.001);
+    EXPECT_EQ(comparisons[2].verdict, hot_utils::BenchmarkVerdict::Improved);
+    EXPECT_EQ(comparisons[3].verdict, hot_utils::BenchmarkVerdict::Unchanged); // 2% is below the threshold
+    EXPECT_EQ(comparisons[4].verdict, hot_utils::BenchmarkVerdict::OnlyInBaseline);
+    EXPECT_EQ(comparisons[5].verdict, hot_utils::BenchmarkVerdict::OnlyInCandidate);
+    EXPECT_TRUE(hot_utils::any_benchmark_regressed(comparisons));
+
+    hot_utils::BenchmarkCompareOptions loose;
+    loose.threshold = 0.25;
+    EXPECT_FALSE(hot_utils::any_benchmark_regressed(hot_utils::compare_benchmark_results(baseline, candidate, loose)));
+}
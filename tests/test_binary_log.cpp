@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/binary_log.hpp"
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/log_utils.hpp"
+#include "hot_utils/scoped_timer.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+using test_support::read_all;
+
+std::string decode(std::FILE* binary) {
+    const std::string encoded = read_all(binary);
+    return test_support::capture_output([&](std::FILE* text) {
+        std::string error;
+        EXPECT_TRUE(hot_utils::decode_binary_log(std::string_view(encoded), text, &error)) << error;
+    });
+}
+
+class BinaryLog : public ::testing::Test {
+protected:
+    void SetUp() override {
+        out_ = std::tmpfile();
+        ASSERT_NE(out_, nullptr);
+        hot_utils::enable_binary_logging(out_);
+    }
+
+    void TearDown() override {
+        hot_utils::disable_binary_logging();
+        std::fclose(out_);
+    }
+
+    std::FILE* out_ = nullptr;
+};
+
+} // namespace
+
+TEST_F(BinaryLog, DecodesToTheTextFormat) {
+    EXPECT_TRUE(hot_utils::binary_logging_enabled());
+    hot_utils::detail::log_line("TEST", "plain line");
+    hot_utils::detail::log_call_impl("file.cpp", 7, "func", "expr()", 1);
+    hot_utils::DefaultTimerLogger{}("phase", std::chrono::milliseconds(42));
+    HOT_UTILS_BINARY_LOG("STAT", "n={} delta={} ratio={} name={}", 5u, -3, 0.5, hot_utils::InternedString{"x"});
+    hot_utils::disable_binary_logging();
+
+    EXPECT_EQ(decode(out_), "[TEST] plain line\n"
+                            "[CALL]   file.cpp:7 func -> expr()\n"
+                            "[TIME] TIMER phase: 42.000 ms\n"
+                            "[STAT] n=5 delta=-3 ratio=0.5 name=x\n");
+}
+
+TEST_F(BinaryLog, CopyMoveEventsMatchTextBackend) {
+    hot_utils::set_log_level("copy_move", hot_utils::LogLevel::Debug);
+    hot_utils::CopyMoveLog<int> a(1);
+    hot_utils::CopyMoveLog<int> b(a);
+    hot_utils::CopyMoveLog<int> c(std::move(b));
+    (void)c;
+    hot_utils::disable_binary_logging();
+    hot_utils::configure_logging("");
+
+    EXPECT_EQ(decode(out_), "[DEBUG] CopyMoveLog<int>: copy_ctor\n"
+                            "[DEBUG] CopyMoveLog<int>: move_ctor\n");
+}
+
+TEST_F(BinaryLog, RepeatedEventsAreSmallerThanText) {
+    for (int i = 0; i < 1000; ++i) {
+        HOT_UTILS_BINARY_LOG("STAT", "iteration {} of the warm-up loop", i);
+    }
+    hot_utils::disable_binary_logging();
+
+    const std::string binary = read_all(out_);
+    const std::string text = decode(out_);
+    EXPECT_LT(binary.size() * 5, text.size());
+    EXPECT_NE(text.find("[STAT] iteration 999 of the warm-up loop\n"), std::string::npos);
+}
+
+TEST_F(BinaryLog, FlushCollectsEveryThread) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 100; ++i) {
+                HOT_UTILS_BINARY_LOG("TEST", "{}", i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    hot_utils::flush_binary_log();
+
+    const std::string text = decode(out_);
+    EXPECT_EQ(static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')), 300u);
+}
+
+TEST(BinaryLogDecode, RejectsMalformedInput) {
+    std::string error;
+    EXPECT_FALSE(hot_utils::decode_binary_log(std::string_view("not a log"), stdout, &error));
+    EXPECT_EQ(error, "missing binary log header");
+    EXPECT_FALSE(hot_utils::decode_binary_log(std::string_view("HUBLOG01E\x05", 10), stdout, &error));
+    EXPECT_EQ(error, "event references an undefined format");
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "hot_utils/contention_benchmark.hpp"
+
+namespace {
+hot_utils::ContentionOptions fast_options(std::vector<std::size_t> thread_counts) {
+    hot_utils::ContentionOptions options;
+    options.thread_counts = std::move(thread_counts);
+    options.warmup = std::chrono::milliseconds(2);
+    options.duration = std::chrono::milliseconds(20);
+    return options;
+}
+} // namespace
+
+TEST(ContentionBenchmark, BarrierReleasesEveryThreadEachRound) {
+    constexpr std::size_t kThreads = 3;
+    constexpr int kRounds = 50;
+    hot_utils::detail::SpinBarrier barrier(kThreads);
+    std::atomic<int> arrivals{0};
+    std::atomic<bool> early{false};
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (int round = 0; round < kRounds; ++round) {
+                arrivals.fetch_add(1);
+                barrier.arrive_and_wait();
+                // Everyone arrived for this round before anyone got past it.
+                if (arrivals.load() < (round + 1) * static_cast<int>(kThreads)) {
+                    early = true;
+                }
+                barrier.arrive_and_wait();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(early.load());
+    EXPECT_EQ(arrivals.load(), kRounds * static_cast<int>(kThreads));
+}
+
+TEST(ContentionBenchmark, DefaultThreadCountsDoubleUpToTheMaximum) {
+    hot_utils::ContentionOptions options;
+    options.max_threads = 6;
+    EXPECT_EQ(hot_utils::detail::contention_thread_counts(options), (std::vector<std::size_t>{1, 2, 4, 6}));
+    options.max_threads = 4;
+    EXPECT_EQ(hot_utils::detail::contention_thread_counts(options), (std::vector<std::size_t>{1, 2, 4}));
+    options.max_threads = 1;
+    EXPECT_EQ(hot_utils::detail::contention_thread_counts(options), (std::vector<std::size_t>{1}));
+}
+
+TEST(ContentionBenchmark, MeasuresEveryThreadOverOneWindow) {
+    std::atomic<std::size_t> highest_index{0};
+    const auto result = hot_utils::run_contention_benchmark("index", [&highest_index](std::size_t thread) {
+        if (thread > highest_index.load(std::memory_order_relaxed)) {
+            highest_index.store(thread, std::memory_order_relaxed);
+        }
+    }, fast_options({1, 2}));
+
+    EXPECT_EQ(result.name, "index");
+    ASSERT_EQ(result.points.size(), 2u);
+    EXPECT_EQ(highest_index.load(), 1u);
+    for (const auto& point : result.points) {
+        ASSERT_EQ(point.operations.size(), point.threads);
+        for (const auto ops : point.operations) {
+            EXPECT_GT(ops, 0u);
+        }
+        EXPECT_GE(point.seconds, 0.02);
+        EXPECT_GT(point.ops_per_second, 0.0);
+        EXPECT_GT(point.ns_per_op, 0.0);
+        EXPECT_GT(point.fairness, 0.0);
+        EXPECT_LE(point.fairness, 1.0 + 1e-12);
+        EXPECT_LE(point.min_share, 1.0 + 1e-12);
+        EXPECT_FALSE(point.pinned);
+    }
+    EXPECT_DOUBLE_EQ(result.points[0].speedup, 1.0);
+    EXPECT_DOUBLE_EQ(result.points[0].efficiency, 1.0);
+    EXPECT_DOUBLE_EQ(result.points[0].fairness, 1.0);
+}
+
+TEST(ContentionBenchmark, PinsThreadsWhenAsked) {
+    auto options = fast_options({2});
+    options.pin_threads = true;
+    const auto result = hot_utils::run_contention_benchmark("pinned", [] { return 1; }, options);
+    ASSERT_EQ(result.points.size(), 1u);
+#if HOT_UTILS_HAS_THREAD_PINNING
+    EXPECT_TRUE(result.points[0].pinned);
+#endif
+}
+
+TEST(ContentionBenchmark, ConvertsPointsToBenchmarkResults) {
+    const auto result = hot_utils::run_contention_benchmark("noop", [] {}, fast_options({1, 2}));
+    const auto results = hot_utils::contention_benchmark_results(result);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].name, "noop/threads:1");
+    EXPECT_EQ(results[1].name, "noop/threads:2");
+    EXPECT_EQ(results[1].samples.size(), 2u);
+    ASSERT_EQ(results[1].counters.size(), 3u);
+    EXPECT_EQ(results[1].counters[0].name, "ops_per_second");
+    EXPECT_DOUBLE_EQ(results[1].counters[0].value, result.points[1].ops_per_second);
+}
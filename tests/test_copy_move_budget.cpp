@@ -0,0 +1,172 @@
+#include "gtest/gtest-spi.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "hot_utils/copy_move_budget.hpp"
+#include "hot_utils/do_not_optimize.hpp"
+
+namespace {
+
+int g_overruns = 0;
+std::string g_report;
+
+void record_overrun(std::string_view, const std::string& report) {
+    ++g_overruns;
+    g_report = report;
+}
+
+template <int N>
+struct Tag {};
+
+class CopyMoveBudgetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        g_overruns = 0;
+        g_report.clear();
+    }
+};
+
+} // namespace
+
+TEST_F(CopyMoveBudgetTest, PassesWithinBudget) {
+    {
+        hot_utils::CopyMoveBudget budget("within", &record_overrun);
+        budget.limit<hot_utils::CopyMoveLog<int>>(1, 1);
+        hot_utils::CopyMoveLog<int> a;
+        hot_utils::CopyMoveLog<int> b = a;
+        hot_utils::CopyMoveLog<int> c = std::move(b);
+        hot_utils::do_not_optimize(c);
+        EXPECT_TRUE(budget.within_budget());
+    }
+    EXPECT_EQ(g_overruns, 0);
+}
+
+TEST_F(CopyMoveBudgetTest, ReportsPerTypeDiff) {
+    {
+        hot_utils::CopyMoveBudget budget("diff", &record_overrun);
+        budget.limit<hot_utils::CopyMoveLog<int>>(1, 2).limit<hot_utils::MoveLog<int>>(0);
+        hot_utils::CopyMoveLog<int> a;
+        hot_utils::CopyMoveLog<int> b = a;
+        b = a;
+        hot_utils::MoveLog<int> m;
+        hot_utils::MoveLog<int> n = std::move(m);
+        hot_utils::do_not_optimize(n);
+        EXPECT_FALSE(budget.within_budget());
+    }
+    ASSERT_EQ(g_overruns, 1);
+    EXPECT_NE(g_report.find("CopyMoveLog<int>: copies 2/1 OVER (copy_ctor +1, copy_assign +1), moves 0/2"),
+        std::string::npos)
+        << g_report;
+    EXPECT_NE(g_report.find("MoveLog<int>: copies 0/0"), std::string::npos) << g_report;
+    EXPECT_NE(g_report.find("moves 1 (move_ctor +1"), std::string::npos) << g_report;
+}
+
+TEST_F(CopyMoveBudgetTest, IgnoresCountsBeforeTheScope) {
+    hot_utils::CopyLog<int> a;
+    hot_utils::CopyLog<int> before = a;
+    hot_utils::do_not_optimize(before);
+    {
+        hot_utils::CopyMoveBudget budget("fresh", &record_overrun);
+        budget.limit<hot_utils::CopyLog<int>>(0);
+    }
+    EXPECT_EQ(g_overruns, 0);
+}
+
+TEST_F(CopyMoveBudgetTest, FailsTheCurrentTestByDefault) {
+    EXPECT_NONFATAL_FAILURE(
+        {
+            hot_utils::CopyMoveBudget budget("hot path");
+            budget.limit<hot_utils::CopyLog<int>>(0);
+            hot_utils::CopyLog<int> a;
+            hot_utils::CopyLog<int> b = a;
+            hot_utils::do_not_optimize(b);
+        },
+        "hot path over budget");
+}
+
+TEST_F(CopyMoveBudgetTest, ChargesCopiesFromOtherThreads) {
+    {
+        hot_utils::CopyMoveBudget budget("workers", &record_overrun);
+        budget.limit<hot_utils::CopyLog<long>>(2);
+        std::thread workers[2];
+        for (auto& worker : workers) {
+            worker = std::thread([] {
+                hot_utils::CopyLog<long> a;
+                hot_utils::CopyLog<long> b = a;
+                hot_utils::CopyLog<long> c = b;
+                hot_utils::do_not_optimize(c);
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    ASSERT_EQ(g_overruns, 1);
+    EXPECT_NE(g_report.find("copies 4/2 OVER"), std::string::npos) << g_report;
+}
+
+TEST_F(CopyMoveBudgetTest, NestedBudgetsChargeTheOuterScope) {
+    int inner_overruns = 0;
+    {
+        hot_utils::CopyMoveBudget outer("outer", &record_overrun);
+        outer.limit<hot_utils::CopyLog<short>>(1);
+        hot_utils::CopyLog<short> a;
+        hot_utils::CopyLog<short> b = a;
+        hot_utils::do_not_optimize(b);
+        {
+            hot_utils::CopyMoveBudget inner("inner", &record_overrun);
+            inner.limit<hot_utils::CopyLog<short>>(1);
+            hot_utils::CopyLog<short> c = a;
+            hot_utils::do_not_optimize(c);
+            EXPECT_TRUE(inner.within_budget());
+            inner_overruns = g_overruns;
+        }
+        EXPECT_EQ(g_overruns, inner_overruns);
+    }
+    EXPECT_EQ(inner_overruns, 0);
+    ASSERT_EQ(g_overruns, 1);
+    EXPECT_NE(g_report.find("copies 2/1 OVER"), std::string::npos) << g_report;
+}
+
+TEST_F(CopyMoveBudgetTest, LimitsPastMaxTypesPutTheBudgetOver) {
+    static_assert(hot_utils::CopyMoveBudget::kMaxTypes == 8);
+    {
+        hot_utils::CopyMoveBudget budget("types", &record_overrun);
+        budget.limit<hot_utils::CopyLog<Tag<0>>>(1)
+            .limit<hot_utils::CopyLog<Tag<1>>>(1)
+            .limit<hot_utils::CopyLog<Tag<2>>>(1)
+            .limit<hot_utils::CopyLog<Tag<3>>>(1)
+            .limit<hot_utils::CopyLog<Tag<4>>>(1)
+            .limit<hot_utils::CopyLog<Tag<5>>>(1)
+            .limit<hot_utils::CopyLog<Tag<6>>>(1)
+            .limit<hot_utils::CopyLog<Tag<7>>>(1);
+        EXPECT_TRUE(budget.within_budget());
+        budget.limit<hot_utils::CopyLog<Tag<8>>>(1);
+        EXPECT_FALSE(budget.within_budget());
+    }
+    ASSERT_EQ(g_overruns, 1);
+    EXPECT_NE(g_report.find("limits not checked: 1 (at most 8 types per budget)"), std::string::npos) << g_report;
+}
+
+TEST_F(CopyMoveBudgetTest, LimitsHeapAllocations) {
+    if (!hot_utils::allocation_hooks_installed()) {
+        GTEST_SKIP() << "allocation hooks not linked";
+    }
+    {
+        hot_utils::CopyMoveBudget budget("alloc", &record_overrun);
+        budget.max_allocations(1);
+        auto first = std::make_unique<int>(1);
+        hot_utils::do_not_optimize(first.get());
+        EXPECT_TRUE(budget.within_budget());
+        auto second = std::make_unique<int>(2);
+        hot_utils::do_not_optimize(second.get());
+        EXPECT_FALSE(budget.within_budget());
+    }
+    ASSERT_EQ(g_overruns, 1);
+    EXPECT_NE(g_report.find("heap: allocations 2/1 OVER (8 bytes)"), std::string::npos) << g_report;
+}
@@ -1,9 +1,18 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/log_utils.hpp"
 #include "hot_utils/streamlined_vector.hpp"
+#include "test_support.hpp"
 
 TEST(CopyLog, CountsCopyOps) {
     using Log = hot_utils::CopyLog<int>;
@@ -71,3 +80,196 @@ TEST(CopyMoveLog, SupportsNestedLoggedTypes) {
     EXPECT_EQ(inner_counts.copy_ctor, 2u);
     EXPECT_EQ(inner_counts.move_ctor, 2u);
 }
+
+TEST(CopyMoveLog, SumsCountsAcrossThreads) {
+    using Log = hot_utils::CopyMoveLog<long>;
+    hot_utils::set_log_level("copy_move", hot_utils::LogLevel::Off);
+    Log::reset();
+
+    constexpr int kThreads = 8;
+    constexpr int kCopies = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([] {
+            Log a;
+            for (int i = 0; i < kCopies; ++i) {
+                Log b = a;
+                a = std::move(b);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    hot_utils::configure_logging("");
+
+    const auto counts = Log::counts();
+    EXPECT_EQ(counts.copy_ctor, static_cast<std::size_t>(kThreads * kCopies));
+    EXPECT_EQ(counts.move_assign, static_cast<std::size_t>(kThreads * kCopies));
+    EXPECT_EQ(counts.copy_assign, 0u);
+    EXPECT_EQ(counts.move_ctor, 0u);
+
+    Log::reset();
+    EXPECT_EQ(Log::counts().copy_ctor, 0u);
+}
+
+TEST(CopyMoveLog, AttributesCopiesToCallSites) {
+    using Log = hot_utils::CopyMoveLog<double>;
+    hot_utils::set_log_level("copy_move", hot_utils::LogLevel::Off);
+    hot_utils::reset_copy_sites();
+    hot_utils::enable_copy_site_tracking();
+
+    Log a;
+    for (int i = 0; i < 3; ++i) {
+        Log b = a;
+        (void)b;
+    }
+    const int copy_line = __LINE__ - 3;
+    {
+        hot_utils::CopySiteTag tag("assign_loop");
+        for (int i = 0; i < 5; ++i) {
+            a = Log{};
+        }
+    }
+    hot_utils::disable_copy_site_tracking();
+    Log untracked = a;
+    (void)untracked;
+    hot_utils::configure_logging("");
+
+    const auto sites = hot_utils::copy_site_stats();
+    ASSERT_EQ(sites.size(), 2u);
+    EXPECT_EQ(sites[0].type, "CopyMoveLog<double>");
+    EXPECT_STREQ(sites[0].action, "move_assign");
+    EXPECT_EQ(sites[0].file, nullptr);
+    EXPECT_STREQ(sites[0].tag, "assign_loop");
+    EXPECT_EQ(sites[0].count, 5u);
+    EXPECT_EQ(sites[0].bytes, 5 * sizeof(double));
+
+    EXPECT_STREQ(sites[1].action, "copy_ctor");
+    ASSERT_NE(sites[1].file, nullptr);
+    EXPECT_NE(std::string(sites[1].file).find("test_copy_move_log.cpp"), std::string::npos);
+    EXPECT_EQ(sites[1].line, copy_line);
+    EXPECT_EQ(sites[1].tag, nullptr);
+    EXPECT_EQ(sites[1].count, 3u);
+    hot_utils::reset_copy_sites();
+    EXPECT_TRUE(hot_utils::copy_site_stats().empty());
+}
+
+TEST(CopyMoveLog, ReportsEveryInstantiatedType) {
+    struct Payload {
+        char bytes[100];
+    };
+    using Big = hot_utils::CopyLog<Payload>;
+    hot_utils::set_log_level("copy_move", hot_utils::LogLevel::Off);
+    hot_utils::reset_copy_sites();
+    hot_utils::enable_copy_site_tracking();
+    Big big;
+    Big copy = big;
+    copy = big;
+    hot_utils::MoveLog<short> small(short{7});
+    hot_utils::MoveLog<short> moved = std::move(small);
+    EXPECT_EQ(moved.value(), 7);
+    hot_utils::disable_copy_site_tracking();
+    hot_utils::configure_logging("");
+
+    const auto types = hot_utils::copy_move_type_stats();
+    const auto find = [&types](std::string_view prefix) {
+        return std::find_if(types.begin(), types.end(),
+            [prefix](const hot_utils::CopyMoveTypeStats& type) { return type.type.rfind(prefix, 0) == 0; });
+    };
+    const auto payload = find("CopyLog<");
+    ASSERT_NE(payload, types.end());
+    EXPECT_EQ(payload->size, sizeof(Payload));
+    EXPECT_GE(payload->counts.copy_ctor, 1u);
+    EXPECT_NE(find("MoveLog<short>"), types.end());
+
+    const std::string text =
+        test_support::capture_output([](std::FILE* out) { hot_utils::write_copy_move_report(out, 2); });
+    EXPECT_NE(text.find("copies and moves by type"), std::string::npos) << text;
+    EXPECT_NE(text.find("MoveLog<short>"), std::string::npos) << text;
+    EXPECT_NE(text.find("top 2 sites by count"), std::string::npos) << text;
+    EXPECT_NE(text.find("top 2 sites by bytes"), std::string::npos) << text;
+    EXPECT_NE(text.find("<assignment>"), std::string::npos) << text;
+    hot_utils::reset_copy_sites();
+}
+
+TEST(LifetimeLog, TracksLiveAndPeakInstances) {
+    using Log = hot_utils::LifetimeLog<std::int64_t>;
+    Log::reset();
+    {
+        Log a;
+        Log b(std::int64_t{7});
+        {
+            Log c = a;
+            Log d = std::move(b);
+            const auto during = Log::snapshot();
+            EXPECT_EQ(during.live, 4);
+            EXPECT_EQ(during.peak_live, 4);
+        }
+        a = Log{};
+    }
+    const auto counts = Log::snapshot();
+    EXPECT_EQ(counts.default_ctor, 2u);
+    EXPECT_EQ(counts.value_ctor, 1u);
+    EXPECT_EQ(counts.copy_ctor, 1u);
+    EXPECT_EQ(counts.move_ctor, 1u);
+    EXPECT_EQ(counts.move_assign, 1u);
+    EXPECT_EQ(counts.constructed(), 5u);
+    EXPECT_EQ(counts.destroyed, 5u);
+    EXPECT_EQ(counts.live, 0);
+    EXPECT_EQ(counts.peak_live, 4);
+    EXPECT_EQ(counts.peak_bytes(), 4 * sizeof(std::int64_t));
+    EXPECT_EQ(Log::counts().copy_ctor, 1u);
+}
+
+TEST(LifetimeLog, DeltaMeasuresOneRequest) {
+    using Log = hot_utils::LifetimeLog<int>;
+    Log::reset();
+    std::vector<Log> resident(10);
+
+    Log::reset_peak();
+    const auto before = Log::snapshot();
+    {
+        std::vector<Log> scratch;
+        scratch.reserve(5);
+        for (int i = 0; i < 5; ++i) {
+            scratch.emplace_back(i);
+        }
+    }
+    const auto churn = hot_utils::lifetime_delta(before, Log::snapshot());
+    EXPECT_EQ(churn.value_ctor, 5u);
+    EXPECT_EQ(churn.destroyed, 5u);
+    EXPECT_EQ(churn.live, 0);
+    EXPECT_EQ(churn.peak_live, 5);
+    EXPECT_EQ(churn.peak_bytes(), 5 * sizeof(int));
+
+    // reset() keeps the resident instances live.
+    Log::reset();
+    EXPECT_EQ(Log::snapshot().live, 10);
+    resident.clear();
+    EXPECT_EQ(Log::snapshot().live, 0);
+}
+
+TEST(LifetimeLog, CountsExactlyAcrossThreads) {
+    using Log = hot_utils::LifetimeLog<char>;
+    Log::reset();
+    constexpr int kThreads = 8;
+    constexpr int kObjects = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([] {
+            for (int round = 0; round < 10; ++round) {
+                std::vector<Log> objects(kObjects);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto counts = Log::snapshot();
+    EXPECT_EQ(counts.default_ctor, static_cast<std::size_t>(kThreads * kObjects * 10));
+    EXPECT_EQ(counts.destroyed, counts.constructed());
+    EXPECT_EQ(counts.live, 0);
+    // The peak is approximate across threads, never above the true maximum.
+    EXPECT_LE(counts.peak_live, kThreads * kObjects);
+}
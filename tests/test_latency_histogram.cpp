@@ -0,0 +1,136 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/latency_histogram.hpp"
+#include "hot_utils/scoped_timer.hpp"
+#include "test_support.hpp"
+
+TEST(LatencyHistogram, EmptyHistogramReportsZero) {
+    hot_utils::LatencyHistogram histogram;
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.min(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+    EXPECT_EQ(histogram.value_at_percentile(99.0), 0u);
+    EXPECT_EQ(histogram.mean(), 0.0);
+}
+
+TEST(LatencyHistogram, PercentilesStayWithinPrecision) {
+    hot_utils::LatencyHistogram histogram(10'000'000'000, 3);
+    for (std::uint64_t value = 1; value <= 100000; ++value) {
+        histogram.record(value * 100);
+    }
+    EXPECT_EQ(histogram.count(), 100000u);
+    EXPECT_EQ(histogram.min(), 100u);
+    EXPECT_EQ(histogram.max(), 10'000'000u);
+    const auto within = [](std::uint64_t actual, double expected) {
+        return std::abs(static_cast<double>(actual) - expected) <= expected * 0.001;
+    };
+    EXPECT_TRUE(within(histogram.value_at_percentile(50.0), 5'000'000.0)) << histogram.value_at_percentile(50.0);
+    EXPECT_TRUE(within(histogram.value_at_percentile(99.0), 9'900'000.0)) << histogram.value_at_percentile(99.0);
+    EXPECT_TRUE(within(histogram.value_at_percentile(99.9), 9'990'000.0)) << histogram.value_at_percentile(99.9);
+    EXPECT_EQ(histogram.value_at_percentile(100.0), 10'000'000u);
+    EXPECT_NEAR(histogram.mean(), 5'000'050.0, 5'000'050.0 * 0.001);
+}
+
+TEST(LatencyHistogram, SmallValuesAreExact) {
+    hot_utils::LatencyHistogram histogram;
+    for (std::uint64_t value = 0; value < 2000; ++value) {
+        histogram.record(value);
+    }
+    EXPECT_EQ(histogram.value_at_percentile(0.0), 0u);
+    EXPECT_EQ(histogram.value_at_percentile(50.0), 999u);
+    EXPECT_EQ(histogram.value_at_percentile(100.0), 1999u);
+}
+
+TEST(LatencyHistogram, ClampsValuesAboveTheTrackableMaximum) {
+    hot_utils::LatencyHistogram histogram(1'000'000, 2);
+    histogram.record(std::uint64_t{5'000'000});
+    histogram.record(std::chrono::seconds(-1));
+    EXPECT_EQ(histogram.count(), 2u);
+    EXPECT_EQ(histogram.max(), 1'000'000u);
+    EXPECT_EQ(histogram.min(), 0u);
+}
+
+TEST(LatencyHistogram, MergesPerThreadHistograms) {
+    constexpr int kThreads = 4;
+    std::vector<hot_utils::LatencyHistogram> histograms(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&histograms, t] {
+            for (std::uint64_t i = 0; i < 1000; ++i) {
+                histograms[t].record(1000 * (t + 1) + i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    hot_utils::LatencyHistogram total;
+    for (const auto& histogram : histograms) {
+        total.merge(histogram);
+    }
+    EXPECT_EQ(total.count(), 4000u);
+    EXPECT_EQ(total.min(), 1000u);
+    EXPECT_EQ(total.max(), 4999u);
+
+    // A coarser histogram re-bins, keeping the count and the precision of the target.
+    hot_utils::LatencyHistogram coarse(1'000'000, 2);
+    coarse.merge(total);
+    EXPECT_EQ(coarse.count(), 4000u);
+    EXPECT_NEAR(static_cast<double>(coarse.value_at_percentile(50.0)), 3000.0, 3000.0 * 0.01);
+}
+
+TEST(LatencyHistogram, ResetClearsSamples) {
+    hot_utils::LatencyHistogram histogram;
+    histogram.record(std::chrono::microseconds(5));
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    histogram.record(std::chrono::microseconds(7));
+    EXPECT_EQ(histogram.min(), 7000u);
+}
+
+TEST(LatencyHistogram, TimerLoggerRecordsScopes) {
+    hot_utils::LatencyHistogram histogram;
+    for (int i = 0; i < 10; ++i) {
+        hot_utils::TscScopedTimer<hot_utils::HistogramTimerLogger> timer("", hot_utils::HistogramTimerLogger{&histogram});
+    }
+    {
+        hot_utils::ScopedTimer<std::chrono::microseconds, std::chrono::steady_clock, hot_utils::HistogramTimerLogger>
+            timer("", hot_utils::HistogramTimerLogger{&histogram});
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_EQ(histogram.count(), 11u);
+    EXPECT_GE(histogram.max(), 2'000'000u);
+}
+
+TEST(LatencyHistogram, PrintsPercentileTable) {
+    hot_utils::LatencyHistogram histogram;
+    for (std::uint64_t i = 1; i <= 1000; ++i) {
+        histogram.record(i * 1000);
+    }
+    const std::string text =
+        test_support::capture_output([&](std::FILE* out) { histogram.print_percentiles(out, "op"); });
+    EXPECT_NE(text.find("op: 1000 samples"), std::string::npos) << text;
+    EXPECT_NE(text.find("p50"), std::string::npos) << text;
+    EXPECT_NE(text.find("p99.99"), std::string::npos) << text;
+    EXPECT_NE(text.find("1000.000 us"), std::string::npos) << text;
+}
+
+TEST(LatencyHistogram, WritesPercentileDistribution) {
+    hot_utils::LatencyHistogram histogram;
+    for (std::uint64_t i = 1; i <= 10000; ++i) {
+        histogram.record(i);
+    }
+    const std::string text =
+        test_support::capture_output([&](std::FILE* out) { histogram.write_percentile_distribution(out); });
+    EXPECT_EQ(text.rfind("       Value     Percentile TotalCount 1/(1-Percentile)", 0), 0u) << text;
+    EXPECT_NE(text.find("1.000000000000      10000\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("#[Mean    ="), std::string::npos) << text;
+    EXPECT_NE(text.find("Total count    =        10000]"), std::string::npos) << text;
+    EXPECT_NE(text.find("#[Buckets ="), std::string::npos) << text;
+}
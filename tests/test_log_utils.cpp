@@ -1,3 +1,8 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "hot_utils/log_utils.hpp"
@@ -27,3 +32,117 @@ TEST(LogUtils, LogDebugCompiles) {
     hot_utils::log_debug("hello");
     EXPECT_TRUE(true);
 }
+
+namespace {
+
+std::vector<std::string> captured_lines;
+
+void capture_line(const char* level, std::string_view msg) {
+    captured_lines.push_back(std::string(level) + " " + std::string(msg));
+}
+
+void capture_call(const char*, int, const char*, const char* expr, std::size_t depth) {
+    captured_lines.push_back("CALL " + std::to_string(depth) + " " + expr);
+}
+
+constexpr hot_utils::detail::LogSink kCaptureSink{&capture_line, &capture_call};
+
+hot_utils::LogCategory test_category{"test"};
+
+// Captures every line through the sink hook and restores the default levels afterwards.
+class LogLevels : public ::testing::Test {
+protected:
+    void SetUp() override {
+        captured_lines.clear();
+        hot_utils::detail::active_log_sink.store(&kCaptureSink);
+    }
+
+    void TearDown() override {
+        hot_utils::detail::active_log_sink.store(nullptr);
+        hot_utils::configure_logging("");
+    }
+};
+
+} // namespace
+
+TEST(LogUtils, ParsesLevelNames) {
+    hot_utils::LogLevel level = hot_utils::LogLevel::Off;
+    EXPECT_TRUE(hot_utils::parse_log_level("TRACE", level));
+    EXPECT_EQ(level, hot_utils::LogLevel::Trace);
+    EXPECT_TRUE(hot_utils::parse_log_level("warn", level));
+    EXPECT_EQ(level, hot_utils::LogLevel::Warn);
+    EXPECT_FALSE(hot_utils::parse_log_level("verbose", level));
+    EXPECT_STREQ(hot_utils::log_level_name(hot_utils::LogLevel::Info), "INFO");
+}
+
+TEST_F(LogLevels, SpecSetsDefaultAndPerCategoryLevels) {
+    ASSERT_TRUE(hot_utils::configure_logging("warn, test=trace"));
+    EXPECT_TRUE(hot_utils::log_enabled<hot_utils::LogLevel::Trace>(test_category));
+    EXPECT_FALSE(hot_utils::log_enabled<hot_utils::LogLevel::Info>(hot_utils::log_categories::timer));
+    EXPECT_TRUE(hot_utils::log_enabled<hot_utils::LogLevel::Error>(hot_utils::log_categories::timer));
+
+    EXPECT_FALSE(hot_utils::configure_logging("test=loud"));
+    EXPECT_EQ(test_category.level(), hot_utils::LogLevel::Trace);
+
+    hot_utils::set_log_level(hot_utils::LogLevel::Off);
+    EXPECT_FALSE(hot_utils::log_enabled<hot_utils::LogLevel::Error>(hot_utils::log_categories::general));
+    EXPECT_TRUE(hot_utils::log_enabled<hot_utils::LogLevel::Trace>(test_category));
+}
+
+TEST_F(LogLevels, DisabledMessageIsNotEvaluated) {
+    hot_utils::set_log_level("test", hot_utils::LogLevel::Info);
+    int built = 0;
+    const auto build = [&built] {
+        ++built;
+        return std::string("built");
+    };
+    HOT_UTILS_LOG(test_category, hot_utils::LogLevel::Debug, build());
+    HOT_UTILS_LOG(test_category, hot_utils::LogLevel::Warn, build());
+    EXPECT_EQ(built, 1);
+    ASSERT_EQ(captured_lines.size(), 1u);
+    EXPECT_EQ(captured_lines[0], "WARN built");
+}
+
+TEST_F(LogLevels, CategoriesGateLibraryOutputAtRuntime) {
+    ASSERT_TRUE(hot_utils::configure_logging("off,call=debug"));
+    int x = 0;
+    hot_utils::log_debug("hidden");
+    HOT_UTILS_LOG_CALL(HOT_UTILS_LOG_CALL(++x));
+    ASSERT_EQ(captured_lines.size(), 2u);
+    EXPECT_EQ(captured_lines[0], "CALL 0 HOT_UTILS_LOG_CALL(++x)");
+    EXPECT_EQ(captured_lines[1], "CALL 1 ++x");
+
+    captured_lines.clear();
+    hot_utils::set_log_level("call", hot_utils::LogLevel::Off);
+    hot_utils::set_log_level("general", hot_utils::LogLevel::Debug);
+    HOT_UTILS_LOG_CALL(++x);
+    hot_utils::log_debug("shown");
+    ASSERT_EQ(captured_lines.size(), 1u);
+    EXPECT_EQ(captured_lines[0], "DEBUG shown");
+    EXPECT_EQ(x, 2);
+}
+
+TEST_F(LogLevels, LogCallIfIgnoresTheCallCategory) {
+    ASSERT_TRUE(hot_utils::configure_logging("call=off"));
+    int x = 0;
+    HOT_UTILS_LOG_CALL_IF(true, ++x);
+    HOT_UTILS_LOG_CALL_IF(false, ++x);
+    HOT_UTILS_LOG_CALL(++x);
+    ASSERT_EQ(captured_lines.size(), 1u);
+    EXPECT_EQ(captured_lines[0], "CALL 0 ++x");
+    EXPECT_EQ(x, 3);
+}
+
+TEST_F(LogLevels, CallGateMirrorsTheCallCategory) {
+    // A disabled HOT_UTILS_LOG_CALL reads only call_gate, so it must follow the category's level.
+    ASSERT_TRUE(hot_utils::configure_logging("call=off"));
+    int x = 0;
+    HOT_UTILS_LOG_CALL(++x);
+    EXPECT_EQ(hot_utils::detail::call_gate.load() & hot_utils::detail::kCallGateLog, 0u);
+
+    hot_utils::set_log_level("call", hot_utils::LogLevel::Debug);
+    EXPECT_NE(hot_utils::detail::call_gate.load() & hot_utils::detail::kCallGateLog, 0u);
+    HOT_UTILS_LOG_CALL(++x);
+    ASSERT_EQ(captured_lines.size(), 1u);
+    EXPECT_EQ(x, 2);
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/perf_counters.hpp"
+
+namespace {
+
+hot_utils::PerfCounts g_counts;
+std::string g_line;
+
+struct CaptureLogger {
+    void operator()(std::string_view, const hot_utils::PerfCounts& counts) const { g_counts = counts; }
+};
+
+void capture_line(const char*, std::string_view msg) {
+    g_line = std::string(msg);
+}
+
+void ignore_call(const char*, int, const char*, const char*, std::size_t) {}
+
+constexpr hot_utils::detail::LogSink kCaptureSink{&capture_line, &ignore_call};
+
+void busy_work() {
+    std::uint64_t x = 1;
+    for (int i = 0; i < 100000; ++i) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        hot_utils::do_not_optimize(x);
+    }
+}
+
+} // namespace
+
+TEST(PerfCounters, ReportsTimeAndWhateverCountersOpened) {
+    {
+        hot_utils::PerfCounterTimer<CaptureLogger> timer("loop", 100000);
+        busy_work();
+    }
+    EXPECT_GT(g_counts.elapsed.count(), 0);
+    EXPECT_EQ(g_counts.iterations, 100000u);
+    if (!hot_utils::perf_counters_available()) {
+        EXPECT_FALSE(g_counts.any_counter());
+        EXPECT_EQ(g_counts.ipc(), 0.0);
+        return;
+    }
+    if (g_counts.has(hot_utils::PerfEvent::Instructions)) {
+        EXPECT_GT(g_counts.per_iteration(hot_utils::PerfEvent::Instructions), 1.0);
+    }
+}
+
+TEST(PerfCounters, DefaultLoggerDegradesToTime) {
+    hot_utils::detail::active_log_sink.store(&kCaptureSink);
+    {
+        hot_utils::PerfCounterTimer<> timer("region");
+        busy_work();
+    }
+    hot_utils::detail::active_log_sink.store(nullptr);
+    EXPECT_EQ(g_line.rfind("region: ", 0), 0u);
+    if (!hot_utils::perf_counters_available()) {
+        EXPECT_NE(g_line.find("(counters unavailable)"), std::string::npos);
+    } else {
+        EXPECT_NE(g_line.find("cycles/iter"), std::string::npos);
+    }
+}
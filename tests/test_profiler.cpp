@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/profiler.hpp"
+#include "hot_utils/scoped_timer.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+int g_logged = 0;
+
+struct CountingLogger {
+    void operator()(std::string_view, std::chrono::nanoseconds) const { ++g_logged; }
+};
+
+void count_line(const char*, std::string_view) {
+    ++g_logged;
+}
+
+void ignore_call(const char*, int, const char*, const char*, std::size_t) {}
+
+constexpr hot_utils::detail::LogSink kCountingSink{&count_line, &ignore_call};
+
+using Timer = hot_utils::ScopedTimer<>;
+
+void spin_for(std::chrono::microseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+void frame() {
+    Timer outer("frame");
+    for (int i = 0; i < 3; ++i) {
+        Timer inner("update");
+        spin_for(std::chrono::microseconds(50));
+    }
+    Timer render("render");
+}
+
+class Profiler : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hot_utils::reset_profiler();
+        hot_utils::enable_profiler();
+        hot_utils::detail::active_log_sink.store(&kCountingSink);
+        g_logged = 0;
+    }
+
+    void TearDown() override {
+        hot_utils::disable_profiler();
+        hot_utils::detail::active_log_sink.store(nullptr);
+    }
+};
+
+} // namespace
+
+TEST_F(Profiler, AggregatesNestedTimersWithoutLogging) {
+    frame();
+    frame();
+    EXPECT_EQ(g_logged, 0);
+
+    const auto entries = hot_utils::profile_snapshot();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].label, "frame");
+    EXPECT_EQ(entries[0].depth, 0u);
+    EXPECT_EQ(entries[0].calls, 2u);
+    EXPECT_EQ(entries[1].label, "update");
+    EXPECT_EQ(entries[1].depth, 1u);
+    EXPECT_EQ(entries[1].calls, 6u);
+    EXPECT_GE(entries[1].total, std::chrono::microseconds(300));
+    EXPECT_GE(entries[1].max, std::chrono::microseconds(50));
+    EXPECT_EQ(entries[2].label, "render");
+    EXPECT_EQ(entries[0].self, entries[0].total - entries[1].total - entries[2].total);
+}
+
+TEST_F(Profiler, CustomLoggersAndUnlabelledTimersAreLeftAlone) {
+    {
+        hot_utils::ScopedTimer<std::chrono::nanoseconds, std::chrono::steady_clock, CountingLogger> custom("custom");
+        hot_utils::ScopedTimer<std::chrono::nanoseconds, std::chrono::steady_clock, CountingLogger> unlabelled;
+    }
+    EXPECT_EQ(g_logged, 2);
+
+    const auto entries = hot_utils::profile_snapshot();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].label, "custom");
+}
+
+TEST_F(Profiler, MergesThreadsByLabelPath) {
+    std::thread first(frame);
+    std::thread second(frame);
+    first.join();
+    second.join();
+
+    const auto entries = hot_utils::profile_snapshot();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].calls, 2u);
+    EXPECT_EQ(entries[1].calls, 6u);
+}
+
+TEST_F(Profiler, WritesFoldedStacksAndSummary) {
+    frame();
+    hot_utils::disable_profiler();
+    {
+        Timer logged("logged");
+    }
+    EXPECT_EQ(g_logged, 1);
+
+    const auto folded = test_support::split_lines(
+        test_support::capture_output([](std::FILE* out) { hot_utils::write_profile_folded(out); }));
+    ASSERT_GE(folded.size(), 2u);
+    EXPECT_EQ(folded[0].rfind("frame ", 0), 0u);
+    EXPECT_EQ(folded[1].rfind("frame;update ", 0), 0u);
+
+    const auto summary = test_support::split_lines(
+        test_support::capture_output([](std::FILE* out) { hot_utils::write_profile_summary(out); }));
+    ASSERT_GE(summary.size(), 3u);
+    EXPECT_EQ(summary[0].rfind("scope", 0), 0u);
+    EXPECT_EQ(summary[1].rfind("frame ", 0), 0u);
+    EXPECT_EQ(summary[2].rfind("  update ", 0), 0u);
+}
+
+TEST_F(Profiler, ResetDropsOpenScopes) {
+    {
+        Timer open("open");
+        hot_utils::reset_profiler();
+    }
+    EXPECT_TRUE(hot_utils::profile_snapshot().empty());
+}
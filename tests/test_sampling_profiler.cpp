@@ -0,0 +1,90 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/do_not_optimize.hpp"
+#include "hot_utils/sampling_profiler.hpp"
+#include "test_support.hpp"
+
+// Not in an anonymous namespace: the folded output names it through dladdr.
+__attribute__((noinline)) std::uint64_t sampling_profiler_test_spin(std::chrono::milliseconds duration) {
+    std::uint64_t value = 1;
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < duration) {
+        for (int i = 0; i < 1000; ++i) {
+            value = value * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        hot_utils::do_not_optimize(value);
+    }
+    return value;
+}
+
+#if HOT_UTILS_HAS_SAMPLING_PROFILER
+
+TEST(SamplingProfiler, RecordsFoldedStacks) {
+    hot_utils::SamplingProfilerOptions options;
+    options.interval = std::chrono::milliseconds(1);
+    ASSERT_TRUE(hot_utils::start_sampling_profiler(options));
+    EXPECT_TRUE(hot_utils::sampling_profiler_running());
+    EXPECT_FALSE(hot_utils::start_sampling_profiler(options));
+    sampling_profiler_test_spin(std::chrono::milliseconds(200));
+    hot_utils::stop_sampling_profiler();
+    EXPECT_FALSE(hot_utils::sampling_profiler_running());
+
+    const auto stats = hot_utils::sampling_profile_stats();
+    EXPECT_GT(stats.samples, 10u);
+    EXPECT_EQ(stats.dropped, 0u);
+
+    const std::string text =
+        test_support::capture_output([](std::FILE* out) { hot_utils::write_sampling_profile_folded(out); });
+    EXPECT_NE(text.find("sampling_profiler_test_spin"), std::string::npos) << text;
+
+    // Every line is "frames count" and the counts add up to the samples.
+    std::uint64_t total = 0;
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        const std::size_t end = text.find('\n', begin);
+        const std::string line = text.substr(begin, end - begin);
+        const std::size_t space = line.rfind(' ');
+        ASSERT_NE(space, std::string::npos) << line;
+        total += std::stoull(line.substr(space + 1));
+        begin = end + 1;
+    }
+    EXPECT_EQ(total, stats.samples);
+}
+
+TEST(SamplingProfiler, DropsSamplesPastCapacityAndResets) {
+    hot_utils::SamplingProfilerOptions options;
+    options.interval = std::chrono::milliseconds(1);
+    options.max_samples = 4;
+    options.max_depth = 2;
+    options.split_by_thread = true;
+    ASSERT_TRUE(hot_utils::start_sampling_profiler(options));
+    sampling_profiler_test_spin(std::chrono::milliseconds(100));
+    hot_utils::stop_sampling_profiler();
+
+    auto stats = hot_utils::sampling_profile_stats();
+    EXPECT_EQ(stats.samples, 4u);
+    EXPECT_GT(stats.dropped, 0u);
+
+    const std::string text =
+        test_support::capture_output([](std::FILE* out) { hot_utils::write_sampling_profile_folded(out); });
+    EXPECT_EQ(text.rfind("thread ", 0), 0u) << text;
+
+    hot_utils::reset_sampling_profile();
+    stats = hot_utils::sampling_profile_stats();
+    EXPECT_EQ(stats.samples, 0u);
+    EXPECT_EQ(stats.dropped, 0u);
+}
+
+#else
+
+TEST(SamplingProfiler, UnsupportedPlatformRefusesToStart) {
+    EXPECT_FALSE(hot_utils::start_sampling_profiler());
+    EXPECT_FALSE(hot_utils::sampling_profiler_running());
+}
+
+#endif
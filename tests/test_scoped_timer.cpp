@@ -1,5 +1,9 @@
 #include "gtest/gtest.h"
 
+#include <string>
+#include <string_view>
+#include <type_traits>
+
 #include "hot_utils/scoped_timer.hpp"
 
 namespace {
@@ -12,6 +16,29 @@ struct TestLogger {
         g_last = us;
     }
 };
+
+// Advances 400 us on every reading.
+struct StepClock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<StepClock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        static rep ticks = 0;
+        ticks += 400'000;
+        return time_point(duration(ticks));
+    }
+};
+
+std::string g_line;
+
+void capture_line(const char*, std::string_view msg) {
+    g_line = std::string(msg);
+}
+
+void ignore_call(const char*, int, const char*, const char*, std::size_t) {}
 } // namespace
 
 TEST(ScopedTimer, LogsOnDestructionDefaultTypes) {
@@ -20,6 +47,22 @@ TEST(ScopedTimer, LogsOnDestructionDefaultTypes) {
     EXPECT_TRUE(true);
 }
 
+TEST(ScopedTimer, DefaultDurationIsMilliseconds) {
+    // Loggers written against the original default take std::chrono::milliseconds.
+    static_assert(std::is_same_v<hot_utils::ScopedTimer<>, hot_utils::ScopedTimer<std::chrono::milliseconds>>);
+}
+
+TEST(ScopedTimer, DefaultLoggerReportsBelowAMillisecond) {
+    static const hot_utils::detail::LogSink sink{&capture_line, &ignore_call};
+    g_line.clear();
+    hot_utils::detail::active_log_sink.store(&sink, std::memory_order_release);
+    {
+        hot_utils::ScopedTimer<std::chrono::milliseconds, StepClock> timer("short");
+    }
+    hot_utils::detail::active_log_sink.store(nullptr, std::memory_order_release);
+    EXPECT_EQ(g_line, "TIMER short: 400.000 us");
+}
+
 TEST(ScopedTimer, SupportsCustomTypes) {
     g_called = 0;
 
@@ -34,3 +77,15 @@ TEST(ScopedTimer, SupportsCustomTypes) {
 
     EXPECT_EQ(g_called, 1);
 }
+
+TEST(ScopedTimer, DefaultLoggerScalesUnits) {
+    char buf[32];
+    hot_utils::detail::format_duration(buf, sizeof(buf), 850);
+    EXPECT_STREQ(buf, "850 ns");
+    hot_utils::detail::format_duration(buf, sizeof(buf), 12'345);
+    EXPECT_STREQ(buf, "12.345 us");
+    hot_utils::detail::format_duration(buf, sizeof(buf), 42'000'000);
+    EXPECT_STREQ(buf, "42.000 ms");
+    hot_utils::detail::format_duration(buf, sizeof(buf), 12'500'000'000);
+    EXPECT_STREQ(buf, "12.500 s");
+}
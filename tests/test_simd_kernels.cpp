@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "hot_utils/simd_kernels.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace {
+
+struct IsaGuard {
+    hot_utils::SimdIsa saved = hot_utils::active_simd_isa();
+    ~IsaGuard() { hot_utils::set_simd_isa(saved); }
+};
+
+std::vector<hot_utils::SimdIsa> available_isas() {
+    std::vector<hot_utils::SimdIsa> isas;
+    for (int i = 0; i <= static_cast<int>(hot_utils::detected_simd_isa()); ++i) {
+        isas.push_back(static_cast<hot_utils::SimdIsa>(i));
+    }
+    return isas;
+}
+
+template <typename Op, typename T>
+void expect_kernels_match_scalar() {
+    constexpr std::size_t n = 37;
+    std::vector<T> lhs(n);
+    std::vector<T> rhs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        lhs[i] = static_cast<T>(static_cast<int>(i * 7) - 100);
+        rhs[i] = static_cast<T>(static_cast<int>(i % 5) + 1);
+    }
+
+    auto expected = lhs;
+    hot_utils::detail::simd::apply_scalar_loop<Op>(expected.data(), rhs.data(), n);
+    auto expected_broadcast = lhs;
+    hot_utils::detail::simd::apply_broadcast_loop<Op>(expected_broadcast.data(), T{3}, n);
+
+    IsaGuard guard;
+    for (const auto isa : available_isas()) {
+        hot_utils::set_simd_isa(isa);
+        auto actual = lhs;
+        hot_utils::detail::simd::apply<Op>(actual.data(), rhs.data(), n);
+        EXPECT_EQ(actual, expected) << hot_utils::simd_isa_name(isa);
+
+        auto broadcast = lhs;
+        hot_utils::detail::simd::apply_broadcast<Op>(broadcast.data(), T{3}, n);
+        EXPECT_EQ(broadcast, expected_broadcast) << hot_utils::simd_isa_name(isa);
+    }
+}
+
+template <typename T>
+void expect_all_ops_match_scalar() {
+    using namespace hot_utils::detail;
+    expect_kernels_match_scalar<AddOp, T>();
+    expect_kernels_match_scalar<SubOp, T>();
+    expect_kernels_match_scalar<MulOp, T>();
+    expect_kernels_match_scalar<DivOp, T>();
+    expect_kernels_match_scalar<ReverseSubOp, T>();
+    expect_kernels_match_scalar<ReverseDivOp, T>();
+}
+
+} // namespace
+
+TEST(SimdKernels, SetIsaClampsToDetected) {
+    IsaGuard guard;
+    EXPECT_EQ(hot_utils::set_simd_isa(hot_utils::SimdIsa::Avx512), hot_utils::detected_simd_isa());
+    EXPECT_EQ(hot_utils::set_simd_isa(hot_utils::SimdIsa::Scalar), hot_utils::SimdIsa::Scalar);
+    EXPECT_EQ(hot_utils::active_simd_isa(), hot_utils::SimdIsa::Scalar);
+}
+
+TEST(SimdKernels, FloatKernelsMatchScalar) { expect_all_ops_match_scalar<float>(); }
+
+TEST(SimdKernels, DoubleKernelsMatchScalar) { expect_all_ops_match_scalar<double>(); }
+
+TEST(SimdKernels, Int32KernelsMatchScalar) { expect_all_ops_match_scalar<std::int32_t>(); }
+
+TEST(SimdKernels, Int64KernelsMatchScalar) { expect_all_ops_match_scalar<std::int64_t>(); }
+
+TEST(SimdKernels, LargeStreamlinedVectorUsesKernelsForOperatorsAndExpressions) {
+    constexpr std::size_t n = 1000;
+    using Vec = hot_utils::StreamlinedVector<float, n>;
+
+    IsaGuard guard;
+    for (const auto isa : available_isas()) {
+        hot_utils::set_simd_isa(isa);
+        Vec a{};
+        Vec b{};
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = static_cast<float>(i);
+            b[i] = 2.0f;
+        }
+
+        a *= b;
+        a += 1.0f;
+        const Vec reversed = 10.0f - a;
+        a = b - a / 2.0f;
+
+        EXPECT_FLOAT_EQ(reversed[3], 3.0f) << hot_utils::simd_isa_name(isa);
+        EXPECT_FLOAT_EQ(a[3], -1.5f) << hot_utils::simd_isa_name(isa);
+        EXPECT_FLOAT_EQ(a[n - 1], 2.0f - 999.5f) << hot_utils::simd_isa_name(isa);
+    }
+}
@@ -0,0 +1,130 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/streamlined_algorithms.hpp"
+#include "hot_utils/streamlined_buffer.hpp"
+#include "hot_utils/streamlined_span.hpp"
+#include "hot_utils/streamlined_vector.hpp"
+
+namespace {
+
+constexpr std::size_t kElements = 1000;
+
+template <typename T>
+hot_utils::StreamlinedVector<T, kElements> pattern(int scale, int modulus) {
+    hot_utils::StreamlinedVector<T, kElements> out{};
+    for (std::size_t i = 0; i < kElements; ++i) {
+        out[i] = static_cast<T>(static_cast<int>(i % modulus) * scale - modulus);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(StreamlinedAlgorithms, SumAndDotMatchNaiveLoops) {
+    const auto a = pattern<std::int64_t>(3, 17);
+    const auto b = pattern<std::int64_t>(2, 11);
+    std::int64_t expected_sum = 0;
+    std::int64_t expected_dot = 0;
+    for (std::size_t i = 0; i < kElements; ++i) {
+        expected_sum += a[i];
+        expected_dot += a[i] * b[i];
+    }
+    EXPECT_EQ(hot_utils::sum(a), expected_sum);
+    EXPECT_EQ(hot_utils::dot(a, b), expected_dot);
+    EXPECT_EQ(hot_utils::sum(a * b), expected_dot);
+
+    // Floating-point dot runs through the dispatched FMA kernels; the inputs keep every partial sum exact.
+    const auto x = pattern<double>(3, 17);
+    const auto y = pattern<double>(2, 11);
+    EXPECT_EQ(hot_utils::dot(x, y), static_cast<double>(expected_dot));
+    EXPECT_EQ(hot_utils::dot(x, y, hot_utils::Summation::Kahan), static_cast<double>(expected_dot));
+    EXPECT_DOUBLE_EQ(hot_utils::norm2(x), std::sqrt(static_cast<double>(hot_utils::dot(a, a))));
+
+    const hot_utils::StreamlinedVector<int, 3> small{1, 2, 3};
+    EXPECT_EQ(hot_utils::sum(small), 6);
+    EXPECT_EQ(hot_utils::dot(small, small), 14);
+}
+
+TEST(StreamlinedAlgorithms, SummationModesAgreeOnExactInputs) {
+    const auto a = pattern<double>(1, 64);
+    const double expected = hot_utils::sum(pattern<std::int64_t>(1, 64));
+    for (const auto mode : {hot_utils::Summation::Fast, hot_utils::Summation::Pairwise, hot_utils::Summation::Kahan}) {
+        EXPECT_EQ(hot_utils::sum(a, mode), expected);
+    }
+}
+
+TEST(StreamlinedAlgorithms, CompensatedSummationRecoversLostLowBits) {
+    hot_utils::StreamlinedBuffer<float> values(1 << 16, 0.1f);
+    values[0] = 1.0e6f;
+    const double exact = 1.0e6 + 0.1 * static_cast<double>(values.size() - 1);
+
+    const double fast_error = std::abs(hot_utils::sum(values) - exact);
+    const double pairwise_error = std::abs(hot_utils::sum(values, hot_utils::Summation::Pairwise) - exact);
+    const double kahan_error = std::abs(hot_utils::sum(values, hot_utils::Summation::Kahan) - exact);
+    EXPECT_LT(pairwise_error, fast_error);
+    EXPECT_LT(kahan_error, 1.0);
+}
+
+TEST(StreamlinedAlgorithms, NormsMinMaxAndArgIndices) {
+    hot_utils::StreamlinedVector<int, 6> v{3, -4, 0, 7, -4, 7};
+    EXPECT_DOUBLE_EQ(hot_utils::norm1(v), 25.0);
+    EXPECT_DOUBLE_EQ(hot_utils::norm2(hot_utils::StreamlinedVector<float, 2>{3.0f, -4.0f}), 5.0f);
+    EXPECT_EQ(hot_utils::min_value(v), -4);
+    EXPECT_EQ(hot_utils::max_value(v), 7);
+    EXPECT_EQ(hot_utils::argmin(v), 1u);
+    EXPECT_EQ(hot_utils::argmax(v), 3u);
+
+    const auto wide = pattern<float>(5, 23);
+    std::size_t expected_max = 0;
+    for (std::size_t i = 1; i < kElements; ++i) {
+        if (wide[i] > wide[expected_max]) {
+            expected_max = i;
+        }
+    }
+    EXPECT_EQ(hot_utils::argmax(wide), expected_max);
+    EXPECT_EQ(hot_utils::max_value(wide), wide[expected_max]);
+    EXPECT_EQ(hot_utils::min_value(wide), -23.0f);
+}
+
+TEST(StreamlinedAlgorithms, FmaIsLazy) {
+    const auto a = pattern<double>(3, 17);
+    const auto b = pattern<double>(2, 11);
+    const auto c = pattern<double>(1, 5);
+
+    hot_utils::StreamlinedVector<double, kElements> out = hot_utils::fma(a, b, c);
+    for (std::size_t i = 0; i < kElements; ++i) {
+        EXPECT_EQ(out[i], std::fma(a[i], b[i], c[i]));
+    }
+
+    // Destination aliasing an operand and nested operands both go through the block path.
+    out = hot_utils::fma(out, b, a + c);
+    for (std::size_t i = 0; i < kElements; ++i) {
+        EXPECT_EQ(out[i], std::fma(std::fma(a[i], b[i], c[i]), b[i], a[i] + c[i]));
+    }
+
+    const hot_utils::StreamlinedVector<int, 3> x{1, 2, 3};
+    const hot_utils::StreamlinedVector<int, 3> fused = hot_utils::fma(x, x, x);
+    EXPECT_EQ(fused, (hot_utils::StreamlinedVector<int, 3>{2, 6, 12}));
+}
+
+TEST(StreamlinedAlgorithms, AxpyUpdatesInPlace) {
+    const auto x = pattern<float>(1, 9);
+    auto y = pattern<float>(2, 7);
+    const auto before = y;
+    hot_utils::axpy(0.5f, x, y);
+    for (std::size_t i = 0; i < kElements; ++i) {
+        EXPECT_EQ(y[i], std::fma(0.5f, x[i], before[i]));
+    }
+
+    hot_utils::StreamlinedBuffer<int> buffer(8, 1);
+    const hot_utils::StreamlinedVector<int, 4> step{1, 2, 3, 4};
+    hot_utils::axpy(2, step, buffer.view<4>(4));
+    EXPECT_EQ(buffer[3], 1);
+    EXPECT_EQ(buffer[4], 3);
+    EXPECT_EQ(buffer[7], 9);
+}
@@ -0,0 +1,223 @@
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/copy_move_log.hpp"
+#include "hot_utils/streamlined_buffer.hpp"
+
+namespace {
+
+using Buffer = hot_utils::StreamlinedBuffer<float>;
+
+Buffer iota_buffer(std::size_t size, float start) {
+    Buffer out(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        out[i] = start + static_cast<float>(i);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(StreamlinedBufferStorage, IsAlignedAndPaddedToCacheLines) {
+    const Buffer buffer(37);
+    EXPECT_EQ(buffer.size(), 37u);
+    EXPECT_EQ(buffer.padded_size(), 48u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.data()) % Buffer::kAlignment, 0u);
+    for (const float value : buffer) {
+        EXPECT_EQ(value, 0.0f);
+    }
+
+    const Buffer empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.data(), nullptr);
+}
+
+TEST(StreamlinedBufferStorage, PadsOnlyElementTypesWithKernels) {
+    const hot_utils::StreamlinedBuffer<std::string> strings(3, "x");
+    EXPECT_EQ(strings.padded_size(), 3u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(strings.data()) % Buffer::kAlignment, 0u);
+
+    static int constructed = 0;
+    struct Counted {
+        Counted() { ++constructed; }
+    };
+    const hot_utils::StreamlinedBuffer<Counted> counted(5);
+    EXPECT_EQ(counted.padded_size(), 5u);
+    EXPECT_EQ(constructed, 5);
+}
+
+TEST(StreamlinedBufferStorage, IsMoveOnly) {
+    static_assert(!std::is_copy_constructible_v<Buffer>);
+    static_assert(!std::is_copy_assignable_v<Buffer>);
+    static_assert(std::is_nothrow_move_constructible_v<Buffer>);
+
+    Buffer a(10, 1.5f);
+    const float* storage = a.data();
+    Buffer b = std::move(a);
+    EXPECT_EQ(b.data(), storage);
+    EXPECT_TRUE(a.empty());
+
+    const Buffer c = b.clone();
+    EXPECT_NE(c.data(), b.data());
+    EXPECT_EQ(c, b);
+}
+
+TEST(StreamlinedBufferArithmetic, CompoundOpsAcrossThePaddedLength) {
+    Buffer a = iota_buffer(1000, 1.0f);
+    const Buffer b(1000, 2.0f);
+
+    a *= b;
+    a += 1.0f;
+    a -= b;
+    a /= 2.0f;
+
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_FLOAT_EQ(a[i], (2.0f * static_cast<float>(i + 1) + 1.0f - 2.0f) / 2.0f);
+    }
+}
+
+TEST(StreamlinedBufferArithmetic, ExpressionsMaterializeIntoBuffers) {
+    const Buffer a = iota_buffer(5, 1.0f);
+    const Buffer b(5, 2.0f);
+
+    static_assert(std::is_same_v<decltype((a + b).eval()), Buffer>);
+
+    const Buffer out = a * 2.0f + b - 10.0f / b;
+    ASSERT_EQ(out.size(), 5u);
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        EXPECT_FLOAT_EQ(out[i], 2.0f * static_cast<float>(i + 1) + 2.0f - 5.0f);
+    }
+
+    Buffer target(5);
+    target = (a + b) * b;
+    EXPECT_FLOAT_EQ(target[4], 14.0f);
+}
+
+TEST(StreamlinedBufferArithmetic, ThrowingExpressionLeavesNothingBehind) {
+    static int live = 0;
+    struct Tracked {
+        int value = 0;
+        Tracked() { ++live; }
+        Tracked(const Tracked& other)
+            : value(other.value) {
+            ++live;
+        }
+        Tracked& operator=(const Tracked&) = default;
+        ~Tracked() { --live; }
+        Tracked& operator+=(const Tracked& rhs) {
+            if (value == 3) {
+                throw std::runtime_error("bad element");
+            }
+            value += rhs.value;
+            return *this;
+        }
+        Tracked operator+(const Tracked& rhs) const {
+            Tracked out(*this);
+            return out += rhs;
+        }
+    };
+
+    hot_utils::StreamlinedBuffer<Tracked> a(5);
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        a[i].value = static_cast<int>(i);
+    }
+    EXPECT_THROW(hot_utils::StreamlinedBuffer<Tracked> sum(a + a), std::runtime_error);
+    EXPECT_EQ(live, 5);
+}
+
+TEST(StreamlinedBufferArithmetic, WorksWithMillionsOfElements) {
+    constexpr std::size_t n = 2'000'000;
+    Buffer a(n, 1.0f);
+    const Buffer b(n, 3.0f);
+
+    a = a + b * 2.0f;
+    EXPECT_FLOAT_EQ(a[0], 7.0f);
+    EXPECT_FLOAT_EQ(a[n - 1], 7.0f);
+}
+
+TEST(StreamlinedBufferViews, InteroperateWithStreamlinedVector) {
+    using Vec = hot_utils::StreamlinedVector<float, 3>;
+    Buffer buffer = iota_buffer(6, 0.0f);
+    const Vec offset{std::array<float, 3>{10.0f, 20.0f, 30.0f}};
+
+    auto tail = buffer.view<3>(3);
+    tail += offset;
+    EXPECT_TRUE(tail == (Vec{std::array<float, 3>{13.0f, 24.0f, 35.0f}}));
+
+    const Vec sum = buffer.view<3>(0) + buffer.view<3>(3);
+    EXPECT_EQ(sum, (Vec{std::array<float, 3>{13.0f, 25.0f, 37.0f}}));
+
+    buffer.view<3>(0) = offset * 2.0f;
+    EXPECT_FLOAT_EQ(buffer[2], 60.0f);
+
+    const Buffer from_vector(offset);
+    EXPECT_EQ(from_vector.size(), 3u);
+    EXPECT_FLOAT_EQ(from_vector[1], 20.0f);
+}
+
+TEST(StreamlinedBufferViews, AssignFromOverlappingShiftedViews) {
+    // Scalar path: each element must read the source before any shifted write lands on it.
+    Buffer small = iota_buffer(5, 0.0f);
+    small.view<4>(1) = small.view<4>(0) + 10.0f;
+    const float expected_small[] = {0.0f, 10.0f, 11.0f, 12.0f, 13.0f};
+    for (std::size_t i = 0; i < 5; ++i) {
+        EXPECT_FLOAT_EQ(small[i], expected_small[i]) << i;
+    }
+
+    // Block path over more than one block, shifted both ways.
+    constexpr std::size_t kCount = 1024;
+    Buffer forward = iota_buffer(kCount + 1, 0.0f);
+    forward.view<kCount>(1) = forward.view<kCount>(0) + 10.0f;
+    Buffer backward = iota_buffer(kCount + 1, 0.0f);
+    backward.view<kCount>(0) = backward.view<kCount>(1) * 2.0f;
+    for (std::size_t i = 0; i < kCount; ++i) {
+        EXPECT_FLOAT_EQ(forward[i + 1], static_cast<float>(i) + 10.0f) << i;
+        EXPECT_FLOAT_EQ(backward[i], static_cast<float>(i + 1) * 2.0f) << i;
+    }
+
+    // Compound assignment reads the shifted operand before it is updated, too.
+    Buffer compound = iota_buffer(kCount + 1, 0.0f);
+    compound.view<kCount>(1) += compound.view<kCount>(0);
+    for (std::size_t i = 0; i < kCount; ++i) {
+        EXPECT_FLOAT_EQ(compound[i + 1], static_cast<float>(2 * i + 1)) << i;
+    }
+}
+
+TEST(StreamlinedBufferViews, CopiesBetweenOverlappingShiftedViews) {
+    Buffer right = iota_buffer(5, 0.0f);
+    right.view<4>(1) = right.view<4>(0);
+    const float expected_right[] = {0.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+    Buffer left = iota_buffer(5, 0.0f);
+    left.view<4>(0) = left.view<4>(1);
+    const float expected_left[] = {1.0f, 2.0f, 3.0f, 4.0f, 4.0f};
+    for (std::size_t i = 0; i < 5; ++i) {
+        EXPECT_FLOAT_EQ(right[i], expected_right[i]) << i;
+        EXPECT_FLOAT_EQ(left[i], expected_left[i]) << i;
+    }
+}
+
+TEST(StreamlinedBufferViews, PrintsLikeStreamlinedVector) {
+    const Buffer buffer = iota_buffer(3, 1.0f);
+    std::ostringstream os;
+    buffer.print(os);
+    EXPECT_EQ(os.str(), "{1, 2, 3}");
+}
+
+TEST(StreamlinedBufferElements, MovingBufferNeverTouchesElements) {
+    using Log = hot_utils::CopyMoveLog<int>;
+    hot_utils::StreamlinedBuffer<Log> a(4);
+
+    Log::reset();
+    hot_utils::StreamlinedBuffer<Log> b = std::move(a);
+    const auto counts = Log::counts();
+    EXPECT_EQ(counts.copy_ctor, 0u);
+    EXPECT_EQ(counts.move_ctor, 0u);
+    EXPECT_EQ(b.size(), 4u);
+}
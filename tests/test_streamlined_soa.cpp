@@ -0,0 +1,91 @@
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/streamlined_soa.hpp"
+
+namespace {
+
+using Vec3 = hot_utils::StreamlinedVector<float, 3>;
+using SoA3 = hot_utils::StreamlinedSoA<float, 3>;
+
+std::vector<Vec3> make_points(std::size_t count) {
+    std::vector<Vec3> out(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = Vec3{static_cast<float>(i), static_cast<float>(2 * i), static_cast<float>(i % 5)};
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(StreamlinedSoALayout, StoresEachComponentInItsOwnAlignedColumn) {
+    const auto points = make_points(1000);
+    const SoA3 soa(points);
+    EXPECT_EQ(soa.size(), 1000u);
+    for (std::size_t c = 0; c < 3; ++c) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.column(c).data()) % 64, 0u);
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            EXPECT_EQ(soa.column(c)[i], points[i][c]);
+        }
+    }
+    EXPECT_EQ(soa.to_aos(), points);
+    EXPECT_EQ(hot_utils::soa_to_aos(hot_utils::aos_to_soa(points)), points);
+}
+
+TEST(StreamlinedSoAProxies, ReadAndWriteLikeStreamlinedVector) {
+    SoA3 soa(make_points(4));
+    EXPECT_TRUE(soa[3] == (Vec3{3.0f, 6.0f, 3.0f}));
+
+    const Vec3 copy = soa[1];
+    EXPECT_EQ(copy, (Vec3{1.0f, 2.0f, 1.0f}));
+
+    soa[0] = Vec3{7.0f, 8.0f, 9.0f};
+    soa[1] += Vec3{1.0f, 1.0f, 1.0f};
+    soa[2] *= 2.0f;
+    soa[3] = soa[0];
+    EXPECT_TRUE(soa[0] == (Vec3{7.0f, 8.0f, 9.0f}));
+    EXPECT_TRUE(soa[1] == (Vec3{2.0f, 3.0f, 2.0f}));
+    EXPECT_TRUE(soa[2] == (Vec3{4.0f, 8.0f, 4.0f}));
+    EXPECT_TRUE(soa[3] == (Vec3{7.0f, 8.0f, 9.0f}));
+
+    soa[1][2] = 5.0f;
+    EXPECT_EQ(soa.column(2)[1], 5.0f);
+
+    // Expressions over proxies materialize through the StreamlinedVector conversion.
+    soa[2] = Vec3(soa[0]) + Vec3(soa[1]);
+    EXPECT_TRUE(soa[2] == (Vec3{9.0f, 11.0f, 14.0f}));
+
+    const SoA3& view = soa;
+    static_assert(std::is_same_v<decltype(view[0][0]), const float&>);
+    std::ostringstream os;
+    view[0].print(os);
+    EXPECT_EQ(os.str(), "{7, 8, 9}");
+}
+
+TEST(StreamlinedSoABulk, OperatesColumnByColumn) {
+    const auto points = make_points(333);
+    SoA3 positions(points);
+    SoA3 velocities(points);
+
+    positions += Vec3{1.0f, 0.0f, -1.0f};
+    positions *= 2.0f;
+    hot_utils::axpy(0.5f, velocities, positions);
+    positions.column(1) -= velocities.column(0);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const Vec3 expected{(points[i][0] + 1.0f) * 2.0f + 0.5f * points[i][0],
+            points[i][1] * 2.0f + 0.5f * points[i][1] - points[i][0],
+            (points[i][2] - 1.0f) * 2.0f + 0.5f * points[i][2]};
+        EXPECT_TRUE(positions[i] == expected);
+    }
+
+    SoA3 copy = positions.clone();
+    EXPECT_EQ(copy, positions);
+    copy -= positions;
+    EXPECT_EQ(hot_utils::sum(copy.column(0)), 0.0f);
+}
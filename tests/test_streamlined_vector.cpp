@@ -17,6 +17,12 @@ void expect_vector_eq(const hot_utils::StreamlinedVector<T, N>& actual, const st
     }
 }
 
+template <typename E, hot_utils::EnableIfStreamlinedExpr<E> = 0>
+void expect_vector_eq(const E& actual,
+    const std::array<typename E::value_type, E::extent>& expected) {
+    expect_vector_eq(actual.eval(), expected);
+}
+
 template <std::size_t N>
 using CopyVec = hot_utils::StreamlinedVector<hot_utils::CopyLog<int>, N>;
 
@@ -260,3 +266,71 @@ TEST(StreamlinedVectorFunctionParams, RefConstRefAndRRefDoNotCopyByThemselves) {
     EXPECT_EQ(counts.move_ctor, 0u);
     EXPECT_EQ(counts.move_assign, 0u);
 }
+
+TEST(StreamlinedVectorExpressions, FusedExpressionMatchesElementWiseResult) {
+    using Vec = hot_utils::StreamlinedVector<int, 3>;
+    const Vec a{std::array<int, 3>{1, 2, 3}};
+    const Vec b{std::array<int, 3>{4, 5, 6}};
+    const Vec c{std::array<int, 3>{7, 8, 9}};
+    const Vec d{std::array<int, 3>{1, 1, 1}};
+
+    const Vec out = a * 2 + b * c - d;
+    expect_vector_eq(out, {29, 43, 59});
+    expect_vector_eq(100 - (a + b) / 2, {98, 97, 96});
+}
+
+TEST(StreamlinedVectorExpressions, OperatorsReturnLazyNodes) {
+    using Vec = hot_utils::StreamlinedVector<int, 3>;
+    const Vec a{};
+    const Vec b{};
+
+    static_assert(!std::is_same_v<decltype(a + b), Vec>);
+    static_assert(std::is_convertible_v<decltype(a + b * 2), Vec>);
+}
+
+TEST(StreamlinedVectorExpressions, LvalueChainCopiesOnlyIntoDestination) {
+    constexpr std::size_t n = 3;
+    using Vec = hot_utils::StreamlinedVector<NumberLog, n>;
+
+    const Vec a{std::array<NumberLog, n>{NumberLog{1}, NumberLog{2}, NumberLog{3}}};
+    const Vec b{std::array<NumberLog, n>{NumberLog{4}, NumberLog{5}, NumberLog{6}}};
+    const Vec c{std::array<NumberLog, n>{NumberLog{7}, NumberLog{8}, NumberLog{9}}};
+
+    hot_utils::CopyMoveLog<int>::reset();
+    const Vec out = a * b + c - a;
+
+    const auto counts = hot_utils::CopyMoveLog<int>::counts();
+    EXPECT_EQ(counts.copy_ctor, 0u);
+    EXPECT_EQ(counts.copy_assign, n);
+    EXPECT_EQ(out[0].value, 10);
+    EXPECT_EQ(out[1].value, 16);
+    EXPECT_EQ(out[2].value, 24);
+}
+
+TEST(StreamlinedVectorExpressions, RvalueChainNeverCopies) {
+    constexpr std::size_t n = 3;
+    using Vec = hot_utils::StreamlinedVector<NumberLog, n>;
+
+    Vec a{std::array<NumberLog, n>{NumberLog{1}, NumberLog{2}, NumberLog{3}}};
+    const Vec b{std::array<NumberLog, n>{NumberLog{4}, NumberLog{5}, NumberLog{6}}};
+
+    hot_utils::CopyMoveLog<int>::reset();
+    const Vec out = std::move(a) + b + b;
+
+    const auto counts = hot_utils::CopyMoveLog<int>::counts();
+    EXPECT_EQ(counts.copy_ctor, 0u);
+    EXPECT_EQ(counts.copy_assign, 0u);
+    EXPECT_EQ(out[2].value, 15);
+}
+
+TEST(StreamlinedVectorExpressions, AssignmentHandlesDestinationOnTheRight) {
+    using Vec = hot_utils::StreamlinedVector<int, 3>;
+    Vec v{std::array<int, 3>{1, 2, 3}};
+    const Vec b{std::array<int, 3>{10, 20, 30}};
+
+    v = b - v * 2;
+    expect_vector_eq(v, {8, 16, 24});
+
+    v += v / 2;
+    expect_vector_eq(v, {12, 24, 36});
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// Helpers shared by the tests that check what a writer put into a FILE*.
+namespace test_support {
+
+// Everything written to file so far. The file stays open.
+inline std::string read_all(std::FILE* file) {
+    std::fflush(file);
+    std::rewind(file);
+    std::string text;
+    char buf[512];
+    std::size_t read = 0;
+    while ((read = std::fread(buf, 1, sizeof(buf), file)) != 0) {
+        text.append(buf, read);
+    }
+    return text;
+}
+
+// Splits text at '\n'; a trailing newline does not add an empty line.
+inline std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        std::size_t end = text.find('\n', begin);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        lines.push_back(text.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return lines;
+}
+
+inline std::vector<std::string> read_lines(std::FILE* file) {
+    return split_lines(read_all(file));
+}
+
+// Runs write(FILE*) against a fresh temporary file and returns what it wrote.
+template <typename Write>
+std::string capture_output(Write&& write) {
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr) {
+        ADD_FAILURE() << "std::tmpfile() failed";
+        return {};
+    }
+    write(file);
+    std::string text = read_all(file);
+    std::fclose(file);
+    return text;
+}
+
+// A temporary file holding contents, rewound for reading. The caller closes it.
+inline std::FILE* file_with_contents(const std::string& contents) {
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr) {
+        ADD_FAILURE() << "std::tmpfile() failed";
+        return nullptr;
+    }
+    std::fwrite(contents.data(), 1, contents.size(), file);
+    std::rewind(file);
+    return file;
+}
+
+} // namespace test_support
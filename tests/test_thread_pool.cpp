@@ -0,0 +1,59 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/thread_pool.hpp"
+
+TEST(ThreadPool, RunsSubmittedTasksBeforeDestruction) {
+    std::atomic<int> runs{0};
+    {
+        hot_utils::ThreadPool pool(3);
+        EXPECT_EQ(pool.size(), 3u);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&runs] { runs.fetch_add(1, std::memory_order_relaxed); });
+        }
+    }
+    EXPECT_EQ(runs.load(), 100);
+}
+
+TEST(ThreadPool, ParallelForCoversEveryIndexOnce) {
+    hot_utils::ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(10007);
+    pool.parallel_for(hits.size(), 64, [&hits](std::size_t begin, std::size_t end) {
+        EXPECT_LE(end - begin, 64u);
+        for (std::size_t i = begin; i < end; ++i) {
+            hits[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+}
+
+TEST(ThreadPool, NestedParallelForDoesNotDeadlock) {
+    hot_utils::ThreadPool pool(2);
+    std::atomic<std::size_t> total{0};
+    pool.parallel_for(8, 1, [&](std::size_t, std::size_t) {
+        pool.parallel_for(100, 10, [&total](std::size_t begin, std::size_t end) {
+            total.fetch_add(end - begin, std::memory_order_relaxed);
+        });
+    });
+    EXPECT_EQ(total.load(), 800u);
+}
+
+TEST(ThreadPool, ParallelForRethrowsFirstException) {
+    hot_utils::ThreadPool pool(2);
+    std::atomic<std::size_t> visited{0};
+    EXPECT_THROW(pool.parallel_for(1000, 10,
+                     [&visited](std::size_t begin, std::size_t end) {
+                         visited.fetch_add(end - begin, std::memory_order_relaxed);
+                         if (begin == 0) {
+                             throw std::runtime_error("chunk failed");
+                         }
+                     }),
+        std::runtime_error);
+    EXPECT_EQ(visited.load(), 1000u);
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/log_utils.hpp"
+#include "hot_utils/scoped_timer.hpp"
+#include "hot_utils/trace.hpp"
+#include "test_support.hpp"
+
+namespace {
+
+struct NullLogger {
+    void operator()(std::string_view, std::chrono::nanoseconds) const {}
+};
+
+std::string export_trace() {
+    return test_support::capture_output([](std::FILE* out) { hot_utils::write_chrome_trace(out); });
+}
+
+std::size_t count(const std::string& text, const std::string& needle) {
+    std::size_t found = 0;
+    for (std::size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        ++found;
+    }
+    return found;
+}
+
+hot_utils::TraceOptions manual_export(std::size_t max_events = std::size_t{1} << 18) {
+    hot_utils::TraceOptions options;
+    options.output_path.clear();
+    options.max_events_per_thread = max_events;
+    return options;
+}
+
+int traced_work(int x) {
+    return HOT_UTILS_LOG_CALL(x + 1);
+}
+
+} // namespace
+
+TEST(Trace, RecordsCallsAndTimersPerThread) {
+    hot_utils::configure_logging("call=off");
+    hot_utils::start_tracing(manual_export());
+    EXPECT_TRUE(hot_utils::tracing_enabled());
+    hot_utils::set_trace_thread_name("main");
+    {
+        hot_utils::ScopedTimer<std::chrono::nanoseconds, std::chrono::steady_clock, NullLogger> timer("outer \"phase\"");
+        EXPECT_EQ(traced_work(1), 2);
+    }
+    std::thread([] {
+        hot_utils::TraceScope scope("worker");
+        traced_work(2);
+    }).join();
+    hot_utils::stop_tracing();
+    hot_utils::configure_logging("");
+    EXPECT_FALSE(hot_utils::tracing_enabled());
+
+    const std::string json = export_trace();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(count(json, "\"ph\":\"B\""), 4u);
+    EXPECT_EQ(count(json, "\"ph\":\"E\""), 4u);
+    EXPECT_EQ(count(json, "\"name\":\"x + 1\",\"cat\":\"call\""), 2u);
+    EXPECT_NE(json.find("\"name\":\"outer \\\"phase\\\"\",\"cat\":\"timer\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"worker\",\"cat\":\"scope\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"main\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"dropped_events\":0"), std::string::npos);
+}
+
+TEST(Trace, NothingIsRecordedWhileStopped) {
+    hot_utils::start_tracing(manual_export());
+    hot_utils::stop_tracing();
+    traced_work(3);
+    EXPECT_EQ(count(export_trace(), "\"ph\":\"B\""), 0u);
+}
+
+TEST(Trace, FullBufferDropsAndCounts) {
+    hot_utils::start_tracing(manual_export(4));
+    std::thread([] {
+        for (int i = 0; i < 5; ++i) {
+            hot_utils::TraceScope scope("tick");
+        }
+    }).join();
+    hot_utils::stop_tracing();
+
+    const std::string json = export_trace();
+    EXPECT_EQ(count(json, "\"name\":\"tick\""), 2u);
+    EXPECT_NE(json.find("\"dropped_events\":6"), std::string::npos);
+}
+
+TEST(Trace, FullBufferKeepsSpansBalanced) {
+    // Room for five events: the outer two spans fit with their end events, the third does not.
+    hot_utils::start_tracing(manual_export(5));
+    std::thread([] {
+        hot_utils::TraceScope outer("outer");
+        hot_utils::TraceScope middle("middle");
+        hot_utils::TraceScope inner("inner");
+    }).join();
+    hot_utils::stop_tracing();
+
+    const std::string json = export_trace();
+    EXPECT_EQ(count(json, "\"ph\":\"B\""), 2u);
+    EXPECT_EQ(count(json, "\"ph\":\"E\""), 2u);
+    EXPECT_EQ(count(json, "\"name\":\"inner\""), 0u);
+    EXPECT_NE(json.find("\"dropped_events\":2"), std::string::npos);
+}
+
+TEST(Trace, ExportCoversOnlyTheCurrentSession) {
+    hot_utils::start_tracing(manual_export(4));
+    std::thread([] {
+        hot_utils::set_trace_thread_name("earlier");
+        for (int i = 0; i < 5; ++i) {
+            hot_utils::TraceScope scope("tick");
+        }
+    }).join();
+    hot_utils::stop_tracing();
+
+    hot_utils::start_tracing(manual_export());
+    std::thread([] { hot_utils::TraceScope scope("later"); }).join();
+    hot_utils::stop_tracing();
+
+    const std::string json = export_trace();
+    EXPECT_EQ(count(json, "\"name\":\"tick\""), 0u);
+    EXPECT_EQ(json.find("\"earlier\""), std::string::npos) << json;
+    EXPECT_EQ(count(json, "\"name\":\"later\""), 1u);
+    EXPECT_NE(json.find("\"dropped_events\":0"), std::string::npos) << json;
+}
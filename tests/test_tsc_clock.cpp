@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+#include "hot_utils/scoped_timer.hpp"
+#include "hot_utils/tsc_clock.hpp"
+
+namespace {
+
+std::chrono::nanoseconds g_elapsed{0};
+
+struct CaptureLogger {
+    void operator()(std::string_view, std::chrono::nanoseconds elapsed) const { g_elapsed = elapsed; }
+};
+
+} // namespace
+
+TEST(TscClock, IsMonotonic) {
+    auto previous = hot_utils::TscClock::now();
+    for (int i = 0; i < 10000; ++i) {
+        const auto now = hot_utils::TscClock::now();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+}
+
+TEST(TscClock, TracksSteadyClock) {
+    const auto info = hot_utils::TscClock::info();
+    if (info.uses_tsc) {
+        EXPECT_TRUE(info.invariant_tsc);
+        EXPECT_GT(info.ticks_per_ns, 0.0);
+    }
+    const auto steady_start = std::chrono::steady_clock::now();
+    const auto tsc_start = hot_utils::TscClock::now();
+    while (std::chrono::steady_clock::now() - steady_start < std::chrono::milliseconds(20)) {
+    }
+    const auto tsc_elapsed = hot_utils::TscClock::now() - tsc_start;
+    const auto steady_elapsed = std::chrono::steady_clock::now() - steady_start;
+    const double ratio = static_cast<double>(tsc_elapsed.count()) / static_cast<double>(steady_elapsed.count());
+    EXPECT_NEAR(ratio, 1.0, 0.02);
+}
+
+TEST(TscClock, MeasuresItsOwnOverhead) {
+    const auto overhead = hot_utils::clock_overhead<hot_utils::TscClock>();
+    EXPECT_GE(overhead.count(), 0);
+    EXPECT_LT(overhead, std::chrono::microseconds(5));
+    EXPECT_EQ(hot_utils::clock_overhead<hot_utils::TscClock>(), overhead);
+}
+
+TEST(TscClock, DrivesScopedTimer) {
+    {
+        hot_utils::TscScopedTimer<CaptureLogger> timer("tsc");
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(200);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+    EXPECT_GE(g_elapsed, std::chrono::microseconds(190));
+    EXPECT_LT(g_elapsed, std::chrono::milliseconds(50));
+}
@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "hot_utils/benchmark_compare.hpp"
+
+namespace {
+
+int usage(const char* program) {
+    std::fprintf(stderr, "usage: %s [--alpha P] [--threshold FRACTION] <baseline> <candidate>\n", program);
+    return 2;
+}
+
+bool parse_fraction(const char* text, double& out) {
+    char* end = nullptr;
+    out = std::strtod(text, &end);
+    return end != text && *end == '\0' && out >= 0.0;
+}
+
+void print_context(const char* role, const char* path, const hot_utils::BenchmarkContext& context) {
+    std::printf("%-9s %s: %s, %s, %s, %s\n", role, path, context.git_sha.c_str(), context.cpu_model.c_str(),
+        context.compiler.c_str(), context.date.c_str());
+}
+
+} // namespace
+
+// Usage: hot_utils_bench_compare [--alpha P] [--threshold FRACTION] <baseline> <candidate>
+// Compares two result files written with HOT_UTILS_BENCHMARK_OUT (JSON or CSV)
+// with a Mann-Whitney U test. Exits 1 when any benchmark regressed, 2 on errors.
+int main(int argc, char** argv) {
+    hot_utils::BenchmarkCompareOptions options;
+    const char* paths[2] = {nullptr, nullptr};
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        if ((std::strcmp(argv[i], "--alpha") == 0 || std::strcmp(argv[i], "--threshold") == 0) && i + 1 < argc) {
+            double& target = argv[i][2] == 'a' ? options.alpha : options.threshold;
+            if (!parse_fraction(argv[i + 1], target)) {
+                return usage(argv[0]);
+            }
+            ++i;
+        } else if (argv[i][0] == '-' || positional == 2) {
+            return usage(argv[0]);
+        } else {
+            paths[positional++] = argv[i];
+        }
+    }
+    if (positional != 2) {
+        return usage(argv[0]);
+    }
+
+    hot_utils::BenchmarkReport reports[2];
+    for (int i = 0; i < 2; ++i) {
+        std::string error;
+        if (!hot_utils::read_benchmark_results(paths[i], reports[i], &error)) {
+            std::fprintf(stderr, "%s: %s\n", paths[i], error.c_str());
+            return 2;
+        }
+    }
+    print_context("baseline", paths[0], reports[0].context);
+    print_context("candidate", paths[1], reports[1].context);
+    if (reports[0].context.cpu_model != reports[1].context.cpu_model) {
+        std::printf("warning: results come from different CPUs\n");
+    }
+    std::printf("alpha %.3g, threshold %.1f%%\n\n", options.alpha, options.threshold * 100.0);
+
+    const auto comparisons = hot_utils::compare_benchmark_results(reports[0].results, reports[1].results, options);
+    hot_utils::print_benchmark_comparison(comparisons);
+    return hot_utils::any_benchmark_regressed(comparisons) ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+#include <cstdio>
+#include <string>
+
+#include "hot_utils/binary_log.hpp"
+
+// Usage: hot_utils_log_decode <binary log> [text output]
+// Writes the decoded lines to stdout when no output path is given.
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::fprintf(stderr, "usage: %s <binary log> [text output]\n", argv[0]);
+        return 2;
+    }
+    std::FILE* in = std::fopen(argv[1], "rb");
+    if (in == nullptr) {
+        std::perror(argv[1]);
+        return 1;
+    }
+    std::FILE* out = argc == 3 ? std::fopen(argv[2], "w") : stdout;
+    if (out == nullptr) {
+        std::perror(argv[2]);
+        std::fclose(in);
+        return 1;
+    }
+    std::string error;
+    const bool ok = hot_utils::decode_binary_log(in, out, &error);
+    std::fclose(in);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    if (!ok) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+    return 0;
+}